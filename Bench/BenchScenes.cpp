@@ -0,0 +1,156 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "BenchScenes.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "shader/Shader.h"
+#include "Renderer/GLStateCache.h"
+#include "Utils/ImageLoader.h"
+#include "Utils/TextureArrayBuilder.h"
+#include "Renderer/VertexLayout.h"
+#include "GettingStarted/DemoGeometry.h"
+
+namespace {
+
+// opengl_03: 贴了 jinx.png 的矩形
+class Scene03 : public BenchScene {
+public:
+    const char* name() const override { return "opengl_03"; }
+
+    bool init(int, int) override {
+        m_shader = std::make_unique<Shader>("../GettingStarted/opengl_03/opengl_03.vert",
+                                            "../GettingStarted/opengl_03/opengl_03.frag");
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+        glGenBuffers(1, &m_ebo);
+        GLStateCache::bindVertexArray(m_vao);
+        GLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_VERTICES), QUAD_VERTICES, GL_STATIC_DRAW);
+        GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QUAD_INDICES), QUAD_INDICES, GL_STATIC_DRAW);
+        QuadVertexLayout::apply();
+
+        m_texture = ImageLoader::loadTexture("../Resources/jinx.png");
+        if (m_texture == 0) {
+            return false;
+        }
+        m_shader->use();
+        m_shader->setInt("ourTexture", 0);
+        m_shader->setBool("flipY", true);
+        return true;
+    }
+
+    void render(int) override {
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        GLStateCache::bindTexture(0, GL_TEXTURE_2D, m_texture);
+        m_shader->use();
+        GLStateCache::bindVertexArray(m_vao);
+        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+    }
+
+    void destroy() override {
+        GLStateCache::deleteVertexArrays(1, &m_vao);
+        GLStateCache::deleteBuffers(1, &m_vbo);
+        GLStateCache::deleteBuffers(1, &m_ebo);
+        GLStateCache::deleteTextures(1, &m_texture);
+        glDeleteProgram(m_shader->ID);
+    }
+
+private:
+    std::unique_ptr<Shader> m_shader;
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0, m_texture = 0;
+};
+
+// opengl_04: 六个面使用纹理数组的旋转正方体
+class Scene04 : public BenchScene {
+public:
+    const char* name() const override { return "opengl_04"; }
+
+    bool init(int width, int height) override {
+        GLStateCache::setEnabled(GL_DEPTH_TEST, true);
+        m_shader = std::make_unique<Shader>("../GettingStarted/opengl_04/opengl_04.vert",
+                                            "../GettingStarted/opengl_04/opengl_04.frag");
+        glGenVertexArrays(1, &m_vao);
+        glGenBuffers(1, &m_vbo);
+        glGenBuffers(1, &m_ebo);
+        GLStateCache::bindVertexArray(m_vao);
+        GLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(CUBE_VERTICES), CUBE_VERTICES, GL_STATIC_DRAW);
+        GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(CUBE_INDICES), CUBE_INDICES, GL_STATIC_DRAW);
+        CubeVertexLayout::apply();
+
+        TextureArrayBuilder builder;
+        for (int i = 1; i <= 6; i++) {
+            builder.addLayer("../Resources/Gemini_Generated_Image_nxkhggnxkhggnxkh" + std::to_string(i) + ".png");
+        }
+        m_texture = builder.build();
+        if (m_texture == 0) {
+            // 贴图缺失时仍然可以测量几何和状态切换的开销
+            LOG_WARN("bench: opengl_04 face textures missing, using placeholder");
+        }
+
+        m_shader->use();
+        m_shader->setInt("faceTextures", 0);
+        m_modelUniform = m_shader->uniform<glm::mat4>("model"_uniform);
+        m_frameConstantsBuffer = std::make_unique<UniformBuffer<FrameConstants>>(FRAME_CONSTANTS_BINDING);
+        m_frameConstants.view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -3.0f));
+        m_frameConstants.projection = glm::perspective(glm::radians(60.0f), (float)width / (float)height, 0.1f, 100.0f);
+        m_frameConstants.viewport = glm::vec4(0.0f, 0.0f, (float)width, (float)height);
+        return true;
+    }
+
+    void render(int frameIndex) override {
+        // 用帧序号驱动旋转，保证每次运行的画面一致
+        float time = frameIndex / 60.0f;
+        m_frameConstants.time = glm::vec4(time, 1.0f / 60.0f, 0.0f, 0.0f);
+        m_frameConstantsBuffer->update(m_frameConstants);
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        m_shader->use();
+        GLStateCache::bindTexture(0, GL_TEXTURE_2D_ARRAY,
+                                  m_texture ? m_texture : ImageLoader::placeholderTexture(GL_TEXTURE_2D_ARRAY));
+
+        glm::quat rotation = glm::angleAxis(time, glm::normalize(glm::vec3(0.3f, 1.0f, 0.0f)));
+        m_shader->set(m_modelUniform, glm::mat4_cast(rotation));
+        GLStateCache::bindVertexArray(m_vao);
+        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+    }
+
+    void destroy() override {
+        GLStateCache::deleteVertexArrays(1, &m_vao);
+        GLStateCache::deleteBuffers(1, &m_vbo);
+        GLStateCache::deleteBuffers(1, &m_ebo);
+        if (m_texture) {
+            GLStateCache::deleteTextures(1, &m_texture);
+        }
+        m_frameConstantsBuffer->destroy();
+        glDeleteProgram(m_shader->ID);
+        GLStateCache::setEnabled(GL_DEPTH_TEST, false);
+    }
+
+private:
+    std::unique_ptr<Shader> m_shader;
+    std::unique_ptr<UniformBuffer<FrameConstants>> m_frameConstantsBuffer;
+    FrameConstants m_frameConstants{};
+    UniformHandle<glm::mat4> m_modelUniform;
+    GLuint m_vao = 0, m_vbo = 0, m_ebo = 0, m_texture = 0;
+};
+
+}
+
+std::unique_ptr<BenchScene> createBenchScene(const std::string& name) {
+    if (name == "opengl_03") return std::make_unique<Scene03>();
+    if (name == "opengl_04") return std::make_unique<Scene04>();
+    return nullptr;
+}
+
+std::vector<std::string> benchSceneNames() {
+    return {"opengl_03", "opengl_04"};
+}
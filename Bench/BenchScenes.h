@@ -0,0 +1,25 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_BENCHSCENES_H
+#define RENDERER_BENCHSCENES_H
+#include <memory>
+#include <string>
+#include <vector>
+
+// GettingStarted 中各个场景的无窗口版本，资源和 shader 与对应的 target 完全一致，
+// 只是把 GLFW 窗口换成了 HeadlessContext 的离屏 FBO。
+class BenchScene {
+public:
+    virtual ~BenchScene() = default;
+    virtual const char* name() const = 0;
+    virtual bool init(int width, int height) = 0;
+    virtual void render(int frameIndex) = 0;
+    virtual void destroy() = 0;
+};
+
+std::unique_ptr<BenchScene> createBenchScene(const std::string& name);
+std::vector<std::string> benchSceneNames();
+
+#endif //RENDERER_BENCHSCENES_H
@@ -0,0 +1,215 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+/*
+ * Headless frame-time benchmark.
+ * usage: bench [--scene opengl_03|opengl_04|all] [--frames N] [--warmup N] [--size WxH] [--output file.json]
+ * Prints mean / p50 / p99 / max per scene as JSON, twice:
+ *   cpu_*   CPU time to record and submit the frame (scene->render() only)
+ *   frame_* the same plus glFinish(), i.e. CPU submission + GPU execution, like a vsync-less present
+ ***/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Bench/BenchScenes.h"
+#include "Renderer/GLStateCache.h"
+#include "Utils/HeadlessContext.h"
+#include "Utils/Logger.h"
+
+struct BenchOptions {
+    std::string scene = "all";
+    int frames = 500;
+    int warmup = 30;
+    int width = 800;
+    int height = 600;
+    std::string output;
+};
+
+struct TimeStats {
+    double meanMs = 0, p50Ms = 0, p99Ms = 0, maxMs = 0;
+};
+
+struct SceneResult {
+    std::string name;
+    int frames = 0;
+    // 只算 CPU 提交，glFinish 之前
+    TimeStats cpu;
+    // 包含 glFinish，CPU 提交 + GPU 执行
+    TimeStats frame;
+    // GLStateCache 每帧平均发出/跳过的状态调用数
+    double stateCallsIssued = 0, stateCallsFiltered = 0;
+};
+
+static bool parseOptions(int argc, char* argv[], BenchOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--scene" && hasValue) {
+            options.scene = argv[++i];
+        } else if (arg == "--frames" && hasValue) {
+            options.frames = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--warmup" && hasValue) {
+            options.warmup = std::max(0, atoi(argv[++i]));
+        } else if (arg == "--size" && hasValue) {
+            if (sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2 ||
+                options.width <= 0 || options.height <= 0) {
+                LOG_ERROR("bench: invalid --size {}, expected WxH", argv[i]);
+                return false;
+            }
+        } else if (arg == "--output" && hasValue) {
+            options.output = argv[++i];
+        } else {
+            LOG_ERROR("bench: unknown argument {}", arg);
+            LOG_INFO("usage: bench [--scene opengl_03|opengl_04|all] [--frames N] [--warmup N] [--size WxH] [--output file.json]");
+            return false;
+        }
+    }
+    return true;
+}
+
+static double percentile(const std::vector<double>& sorted, double p) {
+    size_t index = (size_t)std::ceil(p * sorted.size());
+    index = std::clamp<size_t>(index, 1, sorted.size()) - 1;
+    return sorted[index];
+}
+
+static TimeStats summarize(std::vector<double> times) {
+    TimeStats stats;
+    double sum = 0;
+    for (double t : times) {
+        sum += t;
+    }
+    std::sort(times.begin(), times.end());
+    stats.meanMs = sum / times.size();
+    stats.p50Ms = percentile(times, 0.50);
+    stats.p99Ms = percentile(times, 0.99);
+    stats.maxMs = times.back();
+    return stats;
+}
+
+static bool runScene(const std::string& name, const BenchOptions& options, HeadlessContext& context, SceneResult& result) {
+    auto scene = createBenchScene(name);
+    if (!scene) {
+        LOG_ERROR("bench: unknown scene {}", name);
+        return false;
+    }
+    context.bindFramebuffer();
+    if (!scene->init(options.width, options.height)) {
+        LOG_ERROR("bench: failed to init scene {}", name);
+        scene->destroy();
+        return false;
+    }
+
+    // 每帧末尾 glFinish，相当于有窗口时 SwapBuffers 的同步点；CPU 时间在它之前单独取
+    for (int i = 0; i < options.warmup; i++) {
+        scene->render(i);
+        glFinish();
+        GLStateCache::endFrame();
+    }
+    uint64_t stateIssued = 0, stateFiltered = 0;
+    std::vector<double> cpuTimes;
+    std::vector<double> frameTimes;
+    cpuTimes.reserve(options.frames);
+    frameTimes.reserve(options.frames);
+    for (int i = 0; i < options.frames; i++) {
+        auto start = std::chrono::steady_clock::now();
+        scene->render(options.warmup + i);
+        auto submitted = std::chrono::steady_clock::now();
+        glFinish();
+        auto finished = std::chrono::steady_clock::now();
+        cpuTimes.push_back(std::chrono::duration<double, std::milli>(submitted - start).count());
+        frameTimes.push_back(std::chrono::duration<double, std::milli>(finished - start).count());
+        GLStateCache::endFrame();
+        stateIssued += GLStateCache::lastFrame().totalIssued();
+        stateFiltered += GLStateCache::lastFrame().totalFiltered();
+    }
+    scene->destroy();
+
+    result.name = name;
+    result.frames = options.frames;
+    result.cpu = summarize(std::move(cpuTimes));
+    result.frame = summarize(std::move(frameTimes));
+    result.stateCallsIssued = (double)stateIssued / options.frames;
+    result.stateCallsFiltered = (double)stateFiltered / options.frames;
+    return true;
+}
+
+static void writeStats(std::ostringstream& json, const char* prefix, const TimeStats& stats) {
+    json << ", \"" << prefix << "_mean_ms\": " << stats.meanMs << ", \"" << prefix << "_p50_ms\": " << stats.p50Ms
+         << ", \"" << prefix << "_p99_ms\": " << stats.p99Ms << ", \"" << prefix << "_max_ms\": " << stats.maxMs;
+}
+
+static std::string toJson(const BenchOptions& options, const std::vector<SceneResult>& results) {
+    std::ostringstream json;
+    json.setf(std::ios::fixed);
+    json.precision(4);
+    json << "{\n";
+    json << "  \"renderer\": \"" << (const char*)glGetString(GL_RENDERER) << "\",\n";
+    json << "  \"gl_version\": \"" << (const char*)glGetString(GL_VERSION) << "\",\n";
+    json << "  \"width\": " << options.width << ",\n";
+    json << "  \"height\": " << options.height << ",\n";
+    json << "  \"scenes\": [\n";
+    for (size_t i = 0; i < results.size(); i++) {
+        const SceneResult& r = results[i];
+        json << "    {\"name\": \"" << r.name << "\", \"frames\": " << r.frames;
+        writeStats(json, "cpu", r.cpu);
+        writeStats(json, "frame", r.frame);
+        json << ", \"state_calls_issued\": " << r.stateCallsIssued
+             << ", \"state_calls_filtered\": " << r.stateCallsFiltered << "}"
+             << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    json << "  ]\n}\n";
+    return json.str();
+}
+
+int main(int argc, char *argv[]) {
+    // 帧时间里不应该有日志线程的干扰，这里用同步 logger
+    LoggerOptions loggerOptions;
+    loggerOptions.async = false;
+    Logger::init(loggerOptions);
+    // JSON 默认输出到 stdout，控制台日志只保留警告以上
+    Logger::getConsoleLogger()->set_level(spdlog::level::warn);
+
+    BenchOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        return -1;
+    }
+
+    HeadlessContext context;
+    if (!context.create(options.width, options.height)) {
+        LOG_ERROR("bench: failed to create headless context");
+        return -1;
+    }
+
+    std::vector<std::string> scenes = options.scene == "all" ? benchSceneNames() : std::vector<std::string>{options.scene};
+    std::vector<SceneResult> results;
+    for (const std::string& name : scenes) {
+        SceneResult result;
+        if (!runScene(name, options, context, result)) {
+            return -1;
+        }
+        results.push_back(result);
+    }
+
+    std::string json = toJson(options, results);
+    if (options.output.empty()) {
+        std::cout << json;
+    } else {
+        std::ofstream out(options.output);
+        out << json;
+        if (!out) {
+            LOG_ERROR("bench: failed to write {}", options.output);
+            return -1;
+        }
+    }
+    context.destroy();
+    Logger::shutdown();
+    return 0;
+}
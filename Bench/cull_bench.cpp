@@ -0,0 +1,108 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+/*
+ * Frustum culling micro-benchmark, no GL context needed.
+ * usage: cull_bench [--objects N] [--iterations N]
+ * Prints objects culled per second for every backend available on this CPU,
+ * single-threaded and split across the shared ThreadPool.
+ ***/
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Renderer/FrustumCulling.h"
+#include "Utils/ThreadPool.h"
+
+struct SceneData {
+    std::vector<float> x, y, z, radius, extentY, extentZ;
+};
+
+// 物体均匀散布在相机周围的立方体里，大约 1/6 落在 60 度视锥内
+static SceneData makeScene(size_t count) {
+    SceneData scene;
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-200.0f, 200.0f);
+    std::uniform_real_distribution<float> size(0.2f, 2.0f);
+    for (size_t i = 0; i < count; i++) {
+        scene.x.push_back(position(random));
+        scene.y.push_back(position(random));
+        scene.z.push_back(position(random));
+        scene.radius.push_back(size(random));
+        scene.extentY.push_back(size(random));
+        scene.extentZ.push_back(size(random));
+    }
+    return scene;
+}
+
+template<typename Fn>
+static double bestMs(int iterations, Fn&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void report(const char* shape, const char* name, size_t objects, size_t visible, double ms) {
+    printf("%-8s %-16s %9.3f ms  %8.1f M objects/s  visible %zu\n",
+           shape, name, ms, objects / (ms * 1000.0), visible);
+}
+
+int main(int argc, char *argv[]) {
+    size_t objects = 1000000;
+    int iterations = 50;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--objects" && i + 1 < argc) {
+            objects = (size_t)std::max(1, atoi(argv[++i]));
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else {
+            printf("usage: cull_bench [--objects N] [--iterations N]\n");
+            return -1;
+        }
+    }
+
+    SceneData scene = makeScene(objects);
+    SphereSoA spheres{scene.x.data(), scene.y.data(), scene.z.data(), scene.radius.data(), objects};
+    AabbSoA boxes{scene.x.data(), scene.y.data(), scene.z.data(),
+                  scene.radius.data(), scene.extentY.data(), scene.extentZ.data(), objects};
+    glm::mat4 projection = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 300.0f);
+    glm::mat4 view = glm::lookAt(glm::vec3(0.0f), glm::vec3(0.3f, 0.1f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+    Frustum frustum = Frustum::fromMatrix(projection * view);
+    std::vector<uint32_t> visible(objects);
+
+    ThreadPool& pool = ThreadPool::shared();
+    printf("%zu objects, best of %d runs, best backend %s, %zu worker threads\n", objects, iterations,
+           FrustumCulling::backendName(FrustumCulling::bestBackend()), pool.threadCount());
+
+    const FrustumCulling::Backend backends[] = {
+        FrustumCulling::Backend::Scalar, FrustumCulling::Backend::SSE,
+        FrustumCulling::Backend::AVX2, FrustumCulling::Backend::NEON,
+    };
+    for (FrustumCulling::Backend backend : backends) {
+        if (!FrustumCulling::backendSupported(backend)) {
+            continue;
+        }
+        size_t count = 0;
+        double ms = bestMs(iterations, [&] { count = FrustumCulling::cull(frustum, spheres, visible.data(), backend); });
+        report("sphere", FrustumCulling::backendName(backend), objects, count, ms);
+        ms = bestMs(iterations, [&] { count = FrustumCulling::cull(frustum, boxes, visible.data(), backend); });
+        report("aabb", FrustumCulling::backendName(backend), objects, count, ms);
+    }
+
+    size_t count = 0;
+    double ms = bestMs(iterations, [&] { count = FrustumCulling::cullParallel(frustum, spheres, visible.data(), pool); });
+    report("sphere", "parallel", objects, count, ms);
+    ms = bestMs(iterations, [&] { count = FrustumCulling::cullParallel(frustum, boxes, visible.data(), pool); });
+    report("aabb", "parallel", objects, count, ms);
+    return 0;
+}
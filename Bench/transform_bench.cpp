@@ -0,0 +1,128 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+/*
+ * Transform hierarchy micro-benchmark, no GL context needed.
+ * usage: transform_bench [--nodes N] [--iterations N]
+ * Builds root -> groups -> leaves and times TransformSystem::update when the root moves
+ * (every node recomputes), when 1% of the leaves move and when nothing moves,
+ * next to the per-object glm::mat4_cast + multiply it replaces.
+ ***/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "Renderer/TransformSystem.h"
+
+template<typename Fn>
+static double bestMs(int iterations, Fn&& fn) {
+    double best = 1e30;
+    for (int i = 0; i < iterations; i++) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        best = std::min(best, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+static void report(const char* name, size_t updated, double ms) {
+    printf("%-24s %9.3f ms  %8.1f M nodes/s  updated %zu\n", name, ms, ms > 0.0 ? updated / (ms * 1000.0) : 0.0, updated);
+}
+
+int main(int argc, char *argv[]) {
+    size_t nodes = 100000;
+    int iterations = 100;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--nodes" && i + 1 < argc) {
+            nodes = (size_t)std::max(2, atoi(argv[++i]));
+        } else if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else {
+            printf("usage: transform_bench [--nodes N] [--iterations N]\n");
+            return -1;
+        }
+    }
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+    std::uniform_real_distribution<float> angle(0.0f, 6.2831853f);
+    auto randomRotation = [&] { return glm::angleAxis(angle(random), glm::normalize(glm::vec3(0.3f, 1.0f, 0.2f))); };
+
+    // 根节点下挂 sqrt(N) 个分组，剩下的叶子平均分到各组
+    TransformSystem transforms;
+    transforms.reserve(nodes);
+    TransformSystem::Node root = transforms.create();
+    size_t groupCount = std::max<size_t>(1, (size_t)std::sqrt((double)nodes));
+    std::vector<TransformSystem::Node> groups;
+    for (size_t i = 0; i < groupCount && transforms.size() < nodes; i++) {
+        groups.push_back(transforms.create(root, glm::vec3(position(random), 0.0f, position(random)), randomRotation()));
+    }
+    std::vector<TransformSystem::Node> leaves;
+    while (transforms.size() < nodes) {
+        TransformSystem::Node group = groups[leaves.size() % groups.size()];
+        leaves.push_back(transforms.create(group, glm::vec3(position(random), position(random), position(random)),
+                                           randomRotation(), glm::vec3(0.5f)));
+    }
+    transforms.update();
+    printf("%zu nodes (%zu groups, %zu leaves), best of %d runs, 60 Hz budget 16.667 ms\n",
+           transforms.size(), groups.size(), leaves.size(), iterations);
+
+    float time = 0.0f;
+    size_t updated = 0;
+    double ms = bestMs(iterations, [&] {
+        time += 0.01f;
+        transforms.setRotation(root, glm::angleAxis(time, glm::vec3(0.0f, 1.0f, 0.0f)));
+        updated = transforms.update();
+    });
+    report("root moved", updated, ms);
+
+    size_t movingCount = std::max<size_t>(1, leaves.size() / 100);
+    ms = bestMs(iterations, [&] {
+        time += 0.01f;
+        for (size_t i = 0; i < movingCount; i++) {
+            TransformSystem::Node leaf = leaves[(i * 97) % leaves.size()];
+            transforms.setPosition(leaf, glm::vec3(std::sin(time + i), 0.0f, std::cos(time + i)));
+        }
+        updated = transforms.update();
+    });
+    report("1% leaves moved", updated, ms);
+
+    ms = bestMs(iterations, [&] { updated = transforms.update(); });
+    report("nothing moved", updated, ms);
+
+    // 对照：每个物体各自 translate * mat4_cast * scale 再乘父矩阵
+    std::vector<glm::mat4> world(transforms.size());
+    ms = bestMs(iterations, [&] {
+        for (size_t i = 0; i < transforms.size(); i++) {
+            TransformSystem::Node node = (TransformSystem::Node)i;
+            glm::mat4 local = glm::translate(glm::mat4(1.0f), transforms.position(node)) *
+                              glm::mat4_cast(transforms.rotation(node)) *
+                              glm::scale(glm::mat4(1.0f), transforms.scale(node));
+            TransformSystem::Node parent = transforms.parent(node);
+            world[i] = parent == TransformSystem::kNoParent ? local : world[parent] * local;
+        }
+    });
+    report("per-object glm", world.size(), ms);
+
+    // 两种算法的结果应该一致
+    float maxError = 0.0f;
+    for (size_t i = 0; i < world.size(); i++) {
+        const glm::mat4& a = world[i];
+        const glm::mat4& b = transforms.world((TransformSystem::Node)i);
+        for (int c = 0; c < 4; c++) {
+            for (int r = 0; r < 4; r++) {
+                maxError = std::max(maxError, std::abs(a[c][r] - b[c][r]) / std::max(1.0f, std::abs(a[c][r])));
+            }
+        }
+    }
+    printf("max relative difference vs glm: %g\n", maxError);
+    return 0;
+}
@@ -0,0 +1,112 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_DEMOGEOMETRY_H
+#define RENDERER_DEMOGEOMETRY_H
+#include <cstdint>
+#include <glm/glm.hpp>
+#include "Renderer/VertexLayout.h"
+
+// opengl_03 / opengl_04 的顶点格式和几何数据，Bench 的无窗口场景也用这一份，改顶点格式时只改这里
+
+// 位置(snorm16) + 颜色(unorm8) + 纹理坐标(half)，16 字节，原来 8 个 float 是 32 字节
+struct QuadVertex {
+    Snorm16x4 position;
+    Unorm8x4 color;
+    Half2 uv;
+
+    QuadVertex(float x, float y, float z, float r, float g, float b, float u, float v)
+        : position(glm::vec3(x, y, z)), color(r, g, b), uv(u, v) {}
+};
+using QuadVertexLayout = VertexLayout<QuadVertex,
+    VERTEX_ATTRIB(0, QuadVertex, position),
+    VERTEX_ATTRIB(1, QuadVertex, color),
+    VERTEX_ATTRIB(2, QuadVertex, uv)>;
+
+inline const QuadVertex QUAD_VERTICES[] = {
+    // position           // colors           // textures coords
+    { 0.5f,  0.5f, 0.0f,   1.0f, 0.0f, 0.0f,   1.0f, 1.0f}, // top right
+    { 0.5f, -0.5f, 0.0f,   0.0f, 1.0f, 0.0f,   1.0f, 0.0f}, // bottom right
+    {-0.5f, -0.5f, 0.0f,   0.0f, 0.0f, 1.0f,   0.0f, 0.0f}, // bottom left
+    {-0.5f,  0.5f, 0.0f,   1.0f, 0.0f, 0.0f,   0.0f, 1.0f}, // top left
+};
+
+inline const unsigned int QUAD_INDICES[] = {
+    0, 1, 3,   // first triangle
+    1, 2, 3    // second triangle
+};
+
+// 正方体顶点，16 字节(原来 6 个 float 是 24 字节)：
+// 坐标都在 [-1, 1] 内用 snorm16，UV 用 half，面ID 直接是整数，shader 里不用再从 float 转回来
+struct CubeVertex {
+    Snorm16x4 position;
+    Half2 uv;
+    uint8_t faceId;
+    uint8_t padding[3] = {};
+
+    CubeVertex(float x, float y, float z, float u, float v, uint8_t face)
+        : position(glm::vec3(x, y, z)), uv(u, v), faceId(face) {}
+};
+using CubeVertexLayout = VertexLayout<CubeVertex,
+    VERTEX_ATTRIB(0, CubeVertex, position),
+    VERTEX_ATTRIB(1, CubeVertex, uv),
+    VERTEX_ATTRIB(2, CubeVertex, faceId)>;
+
+// 正方体的顶点数据 (位置 + 纹理坐标 + 面ID)
+inline const CubeVertex CUBE_VERTICES[] = {
+    // 前面 (面ID = 0)
+    {-0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  0},
+    { 0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  0},
+    { 0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  0},
+    {-0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  0},
+
+    // 后面 (面ID = 1)
+    {-0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  1},
+    { 0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  1},
+    { 0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  1},
+    {-0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  1},
+
+    // 左面 (面ID = 2)
+    {-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  2},
+    {-0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  2},
+    {-0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  2},
+    {-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  2},
+
+    // 右面 (面ID = 3)
+    { 0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  3},
+    { 0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  3},
+    { 0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  3},
+    { 0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  3},
+
+    // 上面 (面ID = 4)
+    {-0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  4},
+    { 0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  4},
+    { 0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  4},
+    {-0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  4},
+
+    // 下面 (面ID = 5)
+    {-0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  5},
+    { 0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  5},
+    { 0.5f, -0.5f,  0.5f,  1.0f, 1.0f,  5},
+    {-0.5f, -0.5f,  0.5f,  0.0f, 1.0f,  5}
+};
+
+// 正方体的索引数据
+inline const unsigned int CUBE_INDICES[] = {
+    // 前面
+    0, 1, 2,   2, 3, 0,
+    // 后面
+    4, 5, 6,   6, 7, 4,
+    // 左面
+    8, 9, 10,  10, 11, 8,
+    // 右面
+    12, 13, 14, 14, 15, 12,
+    // 上面
+    16, 17, 18, 18, 19, 16,
+    // 下面
+    20, 21, 22, 22, 23, 20
+};
+
+
+#endif //RENDERER_DEMOGEOMETRY_H
@@ -9,22 +9,18 @@
 #include "GLFW/glfw3.h"
 #include "shader/Shader.h"
 #include "Utils/ImageLoader.h"
+#include "Utils/Profiler.h"
+#include "Utils/TextureManager.h"
+#include "Renderer/GLStateCache.h"
+#include "Renderer/VertexLayout.h"
+#include "GettingStarted/DemoGeometry.h"
 
 int SCREEN_WINDTH = 800;
 int SCREEN_HEIGHT = 600;
-
-float vertices[] = {
-    // position         // colors            // textures coords
-    0.5f, 0.5f, 0.0f,   1.0f, 0.0f, 0.0f,    1.0f, 1.0f, // top right
-    0.5f, -0.5f, 0.0f,  0.0f, 1.0f, 0.0f,    1.0f, 0.0f, // bottom right
-    -0.5f, -0.5f, 0.0f,  0.0f, 0.0f, 1.0f,   0.0f, 0.0f, // bottom left
-    -0.5f, 0.5f, 0.0f,  1.0f, 0.0f, 0.0f,    0.0f, 1.0f, // top left
-};
-
-unsigned int indices[] = {
-    0, 1, 3,   // first triangle
-    1, 2, 3    // second triangle
-};
+// 纹理显存预算，超出时 TextureManager 会降级或释放纹理
+constexpr size_t TEXTURE_BUDGET_BYTES = 64 * 1024 * 1024;
+// 每隔这么多帧把 profiler 各线程缓冲区取空一次，缓冲区满了之后的 zone 会被丢掉
+constexpr uint64_t PROFILE_COLLECT_FRAMES = 64;
 
 void FrameCallback(GLFWwindow* window, int width, int height);
 
@@ -32,6 +28,7 @@ void processInput(GLFWwindow* window);
 
 int main(int argc, char *argv[]) {
     Logger::init();
+    PROFILE_THREAD("main");
     LOG_INFO("Opengl 03 started");
 
     // NOTE: - INIT GLFW
@@ -74,40 +71,27 @@ int main(int argc, char *argv[]) {
     glGenBuffers(1, &EBO);
     
     // VAO - Tell OpenGL, since now, I'll use VAO to manage vertex resources.
-    glBindVertexArray(VAO);
+    GLStateCache::bindVertexArray(VAO);
     
     // VBO
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QUAD_VERTICES), QUAD_VERTICES, GL_STATIC_DRAW);
     
     // EBO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(QUAD_INDICES), QUAD_INDICES, GL_STATIC_DRAW);
 
-    // Position (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // Color (location = 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // Texture (location = 2)
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
-
-    // loadTexture
-    GLuint texture = ImageLoader::loadTexture("../Resources/jinx.png");
-    if (texture == 0) {
-        LOG_ERROR("Failed to load texture");
-        glfwTerminate();
-        return -1;
-    }
+    // Position (location = 0), Color (location = 1), Texture (location = 2)
+    QuadVertexLayout::apply();
+
+    // loadTexture: 纹理归 TextureManager 所有，后台加载，就绪前显示占位棋盘格
+    TextureManager textures(TEXTURE_BUDGET_BYTES);
+    TextureId jinxTexture = textures.load("../Resources/jinx.png");
 
     // use framebuffer size to fillup viewport
     int framebufferWidth, framebufferHeight;
     glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
-    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    GLStateCache::viewport(0, 0, framebufferWidth, framebufferHeight);
     glfwSetFramebufferSizeCallback(window, FrameCallback);
     
     // use uniform
@@ -116,43 +100,63 @@ int main(int argc, char *argv[]) {
     shader.setBool("flipY", true);
 
     // rend loop
+    uint64_t frameIndex = 0;
     while (!glfwWindowShouldClose(window)) {
+        if (++frameIndex % PROFILE_COLLECT_FRAMES == 0) {
+            PROFILE_COLLECT();
+        }
+        PROFILE_SCOPE("frame");
         processInput(window);
+
+        ImageLoader::processUploads();
+        textures.update();
+        if (textures.isFailed(jinxTexture)) {
+            LOG_ERROR("Failed to load texture");
+            glfwSetWindowShouldClose(window, true);
+        }
         
         // clear color
         glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
         
-        // bind texture
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        
-        // use shader
+        // bind texture, shader and VAO; after the first frame GLStateCache filters all of them
+        GLStateCache::bindTexture(0, GL_TEXTURE_2D, textures.use(jinxTexture));
         shader.use();
-        
-        // bind VAO
-        glBindVertexArray(VAO);
+        GLStateCache::bindVertexArray(VAO);
         glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
         
         glfwSwapBuffers(window);
         glfwPollEvents();
+        GLStateCache::endFrame();
     }
+    const GLStateStats& stateStats = GLStateCache::lastFrame();
+    LOG_INFO("GL state calls in the last frame: issued {}, filtered {}",
+             stateStats.totalIssued(), stateStats.totalFiltered());
     
+    const TextureManagerStats& textureStats = textures.stats();
+    LOG_INFO("Textures: {} resident of {}, {:.2f} MB / budget {:.2f} MB, evictions {}, mip drops {}",
+             textureStats.residentTextures, textureStats.textures, textureStats.residentBytes / (1024.0 * 1024.0),
+             textureStats.budgetBytes / (1024.0 * 1024.0), textureStats.evictions, textureStats.mipDrops);
+
     // clear resource
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
+    textures.destroy();
+    GLStateCache::deleteVertexArrays(1, &VAO);
+    GLStateCache::deleteBuffers(1, &VBO);
+    GLStateCache::deleteBuffers(1, &EBO);
 
     glfwTerminate();
+    PROFILE_WRITE_TRACE("logs/trace_opengl_03.json");
     LOG_INFO("App finished");
+    Logger::shutdown();
     return 0;
 }
 
 void FrameCallback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
+    GLStateCache::viewport(0, 0, width, height);
 }
 
 void processInput(GLFWwindow* window) {
+    PROFILE_FUNCTION();
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, true);
     }
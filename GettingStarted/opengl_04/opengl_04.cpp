@@ -3,33 +3,131 @@
 //
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include "../../Utils/Logger.h"
 #include "../../shader/Shader.h"
+#include "../../shader/ShaderLibrary.h"
 #include "../../Utils/ImageLoader.h"
+#include "../../Utils/TextureArrayBuilder.h"
+#include "../../Utils/TextureCache.h"
+#include "../../Utils/GpuProfiler.h"
+#include "../../Utils/Profiler.h"
+#include "../../Utils/ThreadPool.h"
+#include "../../Utils/TripleBuffer.h"
+#include "../../Renderer/FrustumCulling.h"
+#include "../../Renderer/GLStateCache.h"
+#include "../../Renderer/RenderQueue.h"
+#include "../../Renderer/StreamBuffer.h"
+#include "../../Renderer/TransformSystem.h"
+#include "../../Renderer/VertexLayout.h"
+#include "../DemoGeometry.h"
 
 int WINDOW_WIDTH = 800;
 int WINDOW_HEIGHT = 600;
 
-// 全局变量用于鼠标控制 - 使用四元数实现轨迹球旋转
-glm::quat currentRotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f); // 单位四元数
+// 场景变换层级：根节点跟着轨迹球旋转(四元数)，每个正方体是它的子节点
+TransformSystem sceneTransforms;
+TransformSystem::Node sceneRoot = sceneTransforms.create();
 float mouseSensitivity = 2.0f;
 
+// 滚轮缩放相机距离，进入网格内部后视锥剔除才有效果
+float cameraZoom = 1.0f;
+// 轨迹球或缩放改变了相机，--threaded 时主线程据此立即生成新的快照
+bool inputChanged = false;
+
 // 鼠标状态变量
 bool mousePressed = false;
 float lastX = WINDOW_WIDTH / 2.0f;
 float lastY = WINDOW_HEIGHT / 2.0f;
 
+// 正方体数量和绘制方式，用于比较逐 draw 和 instancing 的吞吐
+// usage: opengl_04 [--instances N] [--mode instanced|perdraw] [--cull] [--threaded]
+struct DemoOptions {
+    int instances = 1;
+    bool instanced = true;
+    bool cull = false;
+    bool threaded = false;
+    StreamBuffer::Mode streamMode = StreamBuffer::Mode::Auto;
+};
+
+// 每个实例的数据，和 opengl_04_instanced.vert 的 location 3-7 对应
+struct InstanceData {
+    glm::mat4 model;
+    int32_t layerOffset;
+};
+using InstanceLayout = VertexLayout<InstanceData,
+    VERTEX_ATTRIB(3, InstanceData, model),
+    VERTEX_ATTRIB(7, InstanceData, layerOffset)>;
+
+// perdraw 模式下每个 draw 包带的数据，回放时设置成 uniform
+struct CubeDrawData {
+    glm::mat4 model;
+    int32_t layerOffset;
+};
+// 每个录制任务处理的正方体数
+constexpr size_t RECORD_CHUNK_SIZE = 1024;
+// 每隔这么多帧把 profiler 各线程缓冲区取空一次；关掉 vsync 时一帧十来个 zone，不取的话几秒就满
+constexpr uint64_t PROFILE_COLLECT_FRAMES = 64;
+
+// 模拟一侧生成、渲染一侧只读的一帧数据，--threaded 时两边在不同线程，通过 TripleBuffer 交换
+struct FrameSnapshot {
+    glm::mat4 view;
+    glm::mat4 projection;
+    // 场景根节点的世界矩阵(轨迹球旋转)
+    glm::mat4 model;
+    // 每个正方体的世界矩阵；为空时渲染端用 model * 实例矩阵自己算
+    const glm::mat4* cubeWorlds = nullptr;
+    float time = 0.0f;
+    float deltaTime = 0.0f;
+    // 采样输入、开始模拟的时间，swap 返回后用来计算输入到上屏的延迟
+    double inputTime = 0.0;
+    std::vector<uint32_t> visibleIndices;
+    size_t visibleCount = 0;
+};
+
+bool parseOptions(int argc, char *argv[], DemoOptions& options);
+std::vector<InstanceData> buildInstanceGrid(int count, float spacing, int& gridSide);
 void processInput(GLFWwindow *window);
 void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 glm::vec3 screenToSphere(float x, float y);
 
 int main(int argc, char *argv[]) {
-    Logger::init();
+    // 渲染循环里不能被日志阻塞，队列满了宁可丢弃
+    LoggerOptions loggerOptions;
+    loggerOptions.overflowPolicy = LogOverflowPolicy::Drop;
+    Logger::init(loggerOptions);
+    PROFILE_THREAD("main");
+    DemoOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        Logger::shutdown();
+        return -1;
+    }
+
+    // 0. 着色器源码在后台线程读取，不需要等窗口创建
+    ShaderLibrary shaderLibrary;
+    std::shared_ptr<Shader> shader = options.instanced
+        ? shaderLibrary.load("cube_instanced",
+            "../GettingStarted/opengl_04/opengl_04_instanced.vert",
+            "../GettingStarted/opengl_04/opengl_04.frag")
+        : shaderLibrary.load("cube",
+            "../GettingStarted/opengl_04/opengl_04.vert",
+            "../GettingStarted/opengl_04/opengl_04.frag");
+
     // 1. Init glfw
     if (glfwInit() != GLFW_TRUE) {
         LOG_ERROR("GLFW Init Error");
@@ -53,6 +151,12 @@ int main(int argc, char *argv[]) {
     // 设置鼠标回调函数
     glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
+
+    // 测吞吐时不能被垂直同步限制在刷新率上
+    if (options.instances > 1) {
+        glfwSwapInterval(0);
+    }
 
     // 2. Init glad
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
@@ -61,66 +165,16 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
+    // 尽早把已读好的源码提交给驱动，编译和下面的资源准备并行进行
+    shaderLibrary.update();
+
     // 3. 设置视口
     // glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
     
     // 启用深度测试
-    glEnable(GL_DEPTH_TEST);
-
-    // 4. 创建正方体的顶点数据 (位置 + 纹理坐标 + 面ID)
-    float vertices[] = {
-        // 前面 (面ID = 0)
-        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  0.0f,
-         0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  0.0f,
-         0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  0.0f,
-        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  0.0f,
-        
-        // 后面 (面ID = 1)
-        -0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  1.0f,
-         0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  1.0f,
-         0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  1.0f,
-        -0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  1.0f,
-        
-        // 左面 (面ID = 2)
-        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  2.0f,
-        -0.5f, -0.5f,  0.5f,  1.0f, 0.0f,  2.0f,
-        -0.5f,  0.5f,  0.5f,  1.0f, 1.0f,  2.0f,
-        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  2.0f,
-        
-        // 右面 (面ID = 3)
-         0.5f, -0.5f,  0.5f,  0.0f, 0.0f,  3.0f,
-         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  3.0f,
-         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  3.0f,
-         0.5f,  0.5f,  0.5f,  0.0f, 1.0f,  3.0f,
-        
-        // 上面 (面ID = 4)
-        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f,  4.0f,
-         0.5f,  0.5f,  0.5f,  1.0f, 0.0f,  4.0f,
-         0.5f,  0.5f, -0.5f,  1.0f, 1.0f,  4.0f,
-        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f,  4.0f,
-        
-        // 下面 (面ID = 5)
-        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f,  5.0f,
-         0.5f, -0.5f, -0.5f,  1.0f, 0.0f,  5.0f,
-         0.5f, -0.5f,  0.5f,  1.0f, 1.0f,  5.0f,
-        -0.5f, -0.5f,  0.5f,  0.0f, 1.0f,  5.0f
-    };
+    GLStateCache::setEnabled(GL_DEPTH_TEST, true);
 
-    // 正方体的索引数据
-    unsigned int indices[] = {
-        // 前面
-        0, 1, 2,   2, 3, 0,
-        // 后面
-        4, 5, 6,   6, 7, 4,
-        // 左面
-        8, 9, 10,  10, 11, 8,
-        // 右面
-        12, 13, 14, 14, 15, 12,
-        // 上面
-        16, 17, 18, 18, 19, 16,
-        // 下面
-        20, 21, 22, 22, 23, 20
-    };
+    // 4. 正方体的顶点和索引数据在 DemoGeometry.h，布局见 CubeVertex
 
     // 5. 创建和配置VAO VBO EBO
     unsigned int VAO, VBO, EBO;
@@ -128,28 +182,42 @@ int main(int argc, char *argv[]) {
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
-    glBindVertexArray(VAO);
+    GLStateCache::bindVertexArray(VAO);
 
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(CUBE_VERTICES), CUBE_VERTICES, GL_STATIC_DRAW);
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+    GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(CUBE_INDICES), CUBE_INDICES, GL_STATIC_DRAW);
 
-    // 位置属性
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // 纹理坐标属性
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // 面ID属性
-    glVertexAttribPointer(2, 1, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(5 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+    // 位置(snorm16) + 纹理坐标(half) + 面ID(整数)
+    CubeVertexLayout::apply();
+
+    // 实例数据：正方体排成立方网格，每个实例一个 model 矩阵和贴图层偏移
+    int gridSide = 1;
+    const float gridSpacing = 1.5f;
+    std::vector<InstanceData> instances = buildInstanceGrid(options.instances, gridSpacing, gridSide);
+    sceneTransforms.reserve(instances.size() + 1);
+    TransformSystem::Node firstCubeNode = (TransformSystem::Node)sceneTransforms.size();
+    for (const InstanceData& instance : instances) {
+        sceneTransforms.create(sceneRoot, glm::vec3(instance.model[3]));
+    }
+    unsigned int instanceVBO = 0;
+    std::unique_ptr<StreamBuffer> instanceStream;
+    if (options.instanced && options.cull) {
+        // 开启剔除时每帧只上传可见的实例，写进映射好的环形缓冲，属性指针每帧指向本帧的区域
+        instanceStream = std::make_unique<StreamBuffer>((GLsizeiptr)(instances.size() * sizeof(InstanceData)),
+                                                        StreamBuffer::kDefaultFrameCount, options.streamMode);
+        LOG_INFO("Instance stream buffer mode = {}", StreamBuffer::modeName(instanceStream->mode()));
+    } else if (options.instanced) {
+        glGenBuffers(1, &instanceVBO);
+        GLStateCache::bindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+        glBufferData(GL_ARRAY_BUFFER, instances.size() * sizeof(InstanceData), instances.data(), GL_STATIC_DRAW);
+        // mat4 按列拆成 4 个 vec4 属性，layerOffset 是整数属性；divisor = 1 表示每个实例取一次
+        InstanceLayout::apply(1);
+    }
 
-    // 6. 加载6个不同的纹理
-    GLuint textures[6];
+    // 6. 把6个面的纹理打包进一个纹理数组，解码在线程池中并行进行，就绪前使用占位纹理
     const char* textureFiles[6] = {
         "../Resources/Gemini_Generated_Image_nxkhggnxkhggnxkh1.png", // 前面
         "../Resources/Gemini_Generated_Image_nxkhggnxkhggnxkh2.png", // 后面
@@ -158,91 +226,415 @@ int main(int argc, char *argv[]) {
         "../Resources/Gemini_Generated_Image_nxkhggnxkhggnxkh5.png", // 上面
         "../Resources/Gemini_Generated_Image_nxkhggnxkhggnxkh6.png"  // 下面
     };
-    
-    for (int i = 0; i < 6; i++) {
-        textures[i] = ImageLoader::loadTexture(textureFiles[i]);
-        if (textures[i] == 0) {
-            LOG_ERROR("Failed to load texture: {}", textureFiles[i]);
-            return -1;
-        }
+    TextureArrayBuilder faceTextureBuilder;
+    for (const char* file : textureFiles) {
+        faceTextureBuilder.addLayer(file);
     }
+    TextureHandle faceTextures = faceTextureBuilder.buildAsync();
 
     int framebufferWidth, framebufferHeight;
     glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
-    glViewport(0, 0, framebufferWidth, framebufferHeight);
+    GLStateCache::viewport(0, 0, framebufferWidth, framebufferHeight);
+
+    // 7. 着色器程序在循环中就绪后再设置一次性的 uniform
+    bool shaderConfigured = false;
+    UniformHandle<glm::mat4> modelUniform;
+    UniformHandle<int> layerOffsetUniform;
+
+    // 相机后退到能看到整个网格
+    float gridExtent = gridSide * gridSpacing;
+    float cameraDistance = options.instances > 1 ? 3.0f + gridExtent * 1.5f : 3.0f;
+    float farPlane = std::max(100.0f, cameraDistance + gridExtent * 2.0f);
+
+    // 视锥剔除用的包围球(网格局部空间，SoA)，正方体外接球半径 sqrt(3)/2
+    std::vector<float> boundsX, boundsY, boundsZ, boundsRadius;
+    if (options.cull) {
+        for (const InstanceData& instance : instances) {
+            boundsX.push_back(instance.model[3].x);
+            boundsY.push_back(instance.model[3].y);
+            boundsZ.push_back(instance.model[3].z);
+            boundsRadius.push_back(0.8660254f);
+        }
+        LOG_INFO("Frustum culling on, backend = {}",
+                 FrustumCulling::backendName(FrustumCulling::bestBackend()));
+    }
+    SphereSoA bounds{boundsX.data(), boundsY.data(), boundsZ.data(), boundsRadius.data(), boundsX.size()};
+
+    // view/projection 对所有 draw 都一样，放进每帧只更新一次的 UBO
+    UniformBuffer<FrameConstants> frameConstantsBuffer(FRAME_CONSTANTS_BINDING);
+    FrameConstants frameConstants{};
+    float lastFrameTime = (float)glfwGetTime();
+
+    // perdraw 模式的命令队列，bucket 和排序缓冲跨帧复用
+    RenderQueue renderQueue;
+
+    // GPU 分段计时，滚动平均定期写入文件日志
+    GpuProfiler gpuProfiler;
+    gpuProfiler.init();
+
+    // 模拟：更新变换、相机和视锥剔除，结果全部写进快照，不调用任何 GL 函数
+    auto simulate = [&](FrameSnapshot& snapshot) {
+        PROFILE_SCOPE("simulate");
+        // 只有轨迹球转过的帧才会重新计算世界矩阵
+        {
+            PROFILE_SCOPE("transform update");
+            sceneTransforms.update();
+        }
+        float currentTime = (float)glfwGetTime();
+        snapshot.time = currentTime;
+        snapshot.deltaTime = currentTime - lastFrameTime;
+        lastFrameTime = currentTime;
+        snapshot.inputTime = glfwGetTime();
+        snapshot.view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -cameraDistance * cameraZoom));
+        snapshot.projection = glm::perspective(glm::radians(60.0f),
+                                               (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT,
+                                               0.1f, farPlane);
+        snapshot.model = sceneTransforms.world(sceneRoot);
+        // 多线程时模拟线程随时会改写 TransformSystem，渲染端不能直接读它的矩阵
+        snapshot.cubeWorlds = options.threaded ? nullptr : sceneTransforms.worldMatrices() + firstCubeNode;
+        snapshot.visibleCount = instances.size();
+
+        // 包围球在网格局部空间，直接用 projection * view * model 提取视锥
+        if (options.cull) {
+            PROFILE_SCOPE("frustum culling");
+            snapshot.visibleIndices.resize(instances.size());
+            Frustum frustum = Frustum::fromMatrix(snapshot.projection * snapshot.view * snapshot.model);
+            snapshot.visibleCount = FrustumCulling::cullParallel(frustum, bounds, snapshot.visibleIndices.data(),
+                                                                 ThreadPool::shared());
+        }
+    };
+
+    // 渲染：只读快照，除 swap 以外的 GL 调用都在这里
+    auto renderFrame = [&](const FrameSnapshot& snapshot) {
+        gpuProfiler.beginFrame();
+        int frameScope = gpuProfiler.beginScope("frame");
+
+        // 提交/轮询着色器编译，就绪后解析每帧都要设置的 uniform
+        {
+            PROFILE_SCOPE("shaderLibrary.update");
+            shaderLibrary.update();
+        }
+        if (!shaderConfigured && shader->isReady()) {
+            shader->use();
+            shader->setInt("faceTextures", 0);
+            modelUniform = shader->uniform<glm::mat4>("model"_uniform);
+            if (!options.instanced) {
+                layerOffsetUniform = shader->uniform<int>("layerOffset"_uniform);
+            }
+            shaderConfigured = true;
+        }
+        if (!shaderConfigured && shader->isFailed() && !glfwWindowShouldClose(window)) {
+            // 着色器不会再就绪，继续运行只会一直清屏
+            LOG_ERROR("Cube shader failed to build, exiting");
+            glfwSetWindowShouldClose(window, true);
+            // --threaded 时主线程睡在 glfwWaitEvents 里
+            glfwPostEmptyEvent();
+        }
 
-    // 7. 创建着色器程序
-    Shader shader("../GettingStarted/opengl_04/opengl_04.vert",
-        "../GettingStarted/opengl_04/opengl_04.frag");
+        // 上传已解码完成的纹理
+        {
+            GPU_PROFILE_SCOPE(gpuProfiler, "texture upload");
+            if (ImageLoader::processUploads() > 0 && !ImageLoader::hasPendingLoads()) {
+                TextureCache::Stats cacheStats = TextureCache::stats();
+                LOG_INFO("Textures ready, cache hits = {}, misses = {}", cacheStats.hits, cacheStats.misses);
+            }
+        }
 
-    // 8. 主渲染循环
-    while (!glfwWindowShouldClose(window)) {
-        // 处理输入
-        processInput(window);
+        // 更新每帧常量
+        frameConstants.view = snapshot.view;
+        frameConstants.projection = snapshot.projection;
+        frameConstants.viewport = glm::vec4(0.0f, 0.0f, (float)framebufferWidth, (float)framebufferHeight);
+        frameConstants.time = glm::vec4(snapshot.time, snapshot.deltaTime, 0.0f, 0.0f);
+        frameConstantsBuffer.update(frameConstants);
 
         // 清除缓冲区
-        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        {
+            GPU_PROFILE_SCOPE(gpuProfiler, "clear");
+            glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
 
-        // 使用着色器程序
-        shader.use();
+        // 着色器还在编译时只清屏
+        if (shaderConfigured) {
+            // 使用着色器程序
+            shader->use();
+
+            // 所有面共用一个纹理数组，没有变化时 GLStateCache 会跳过这次绑定
+            {
+                GPU_PROFILE_SCOPE(gpuProfiler, "texture bind");
+                GLStateCache::bindTexture(0, GL_TEXTURE_2D_ARRAY, faceTextures.get());
+            }
+
+            // 绘制正方体
+            GPU_PROFILE_SCOPE(gpuProfiler, "cube draw");
+            size_t visibleCount = snapshot.visibleCount;
+            const uint32_t* visibleIndices = snapshot.visibleIndices.data();
+            GLStateCache::bindVertexArray(VAO);
+            if (options.instanced) {
+                if (instanceStream) {
+                    // 可见实例直接写进映射的内存，没有中间数组也没有 glBufferSubData 的驱动拷贝
+                    instanceStream->beginFrame();
+                    StreamAllocation allocation = instanceStream->allocate(
+                        (GLsizeiptr)(visibleCount * sizeof(InstanceData)), alignof(InstanceData));
+                    if (allocation.valid()) {
+                        InstanceData* visibleInstances = static_cast<InstanceData*>(allocation.data);
+                        for (size_t i = 0; i < visibleCount; i++) {
+                            visibleInstances[i] = instances[visibleIndices[i]];
+                        }
+                        instanceStream->commit(allocation);
+                        GLStateCache::bindBuffer(GL_ARRAY_BUFFER, allocation.buffer);
+                        InstanceLayout::apply(1, allocation.offset);
+                    } else {
+                        visibleCount = 0;
+                    }
+                }
+                // 实例数据已经在 GPU 上，一次 draw call 画完所有正方体
+                shader->set(modelUniform, snapshot.model);
+                if (visibleCount > 0) {
+                    glDrawElementsInstanced(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0, (GLsizei)visibleCount);
+                }
+                if (instanceStream) {
+                    instanceStream->endFrame();
+                }
+            } else {
+                // 每个正方体一个 draw 包：线程池并行录制，按 key 排序后从近到远回放，
+                // 每个 draw 一次 uniform 上传 + 一次 draw call
+                {
+                    PROFILE_SCOPE("render queue record");
+                    const glm::mat4& view = snapshot.view;
+                    // GL 名字在 GL 线程取好，录制任务里只读纯数据
+                    GLuint program = shader->ID;
+                    GLuint faceTexture = faceTextures.get();
+                    renderQueue.record(ThreadPool::shared(), visibleCount, RECORD_CHUNK_SIZE,
+                                       [&](CommandBucket& bucket, size_t begin, size_t end) {
+                        DrawPacket packet;
+                        packet.program = program;
+                        packet.vao = VAO;
+                        packet.textureTargets[0] = GL_TEXTURE_2D_ARRAY;
+                        packet.textures[0] = faceTexture;
+                        packet.textureCount = 1;
+                        packet.indexCount = 36;
+                        for (size_t i = begin; i < end; i++) {
+                            size_t index = options.cull ? visibleIndices[i] : i;
+                            glm::mat4 world = snapshot.cubeWorlds ? snapshot.cubeWorlds[index]
+                                                                  : snapshot.model * instances[index].model;
+                            CubeDrawData data{world, instances[index].layerOffset};
+                            float viewDepth = -(view * data.model[3]).z;
+                            packet.key = SortKey::make(0, 0, 0, SortKey::quantizeDepth(viewDepth, farPlane));
+                            bucket.add(packet, data);
+                        }
+                    });
+                }
+                {
+                    PROFILE_SCOPE("render queue sort");
+                    renderQueue.sort();
+                }
+                renderQueue.submit([&](const DrawPacket&, const void* data) {
+                    const CubeDrawData* drawData = static_cast<const CubeDrawData*>(data);
+                    shader->set(modelUniform, drawData->model);
+                    shader->set(layerOffsetUniform, drawData->layerOffset);
+                });
+            }
+        }
 
-        // 绑定多个纹理
-        for (int i = 0; i < 6; i++) {
-            glActiveTexture(GL_TEXTURE0 + i);
-            glBindTexture(GL_TEXTURE_2D, textures[i]);
+        // 交换前结束 frame scope，swap 本身不计入
+        gpuProfiler.endScope(frameScope);
+        gpuProfiler.endFrame();
+    };
+
+    LOG_INFO("Drawing {} cube(s), mode = {}, {}", options.instances, options.instanced ? "instanced" : "perdraw",
+             options.threaded ? "render thread" : "single thread");
+    double fpsWindowStart = glfwGetTime();
+    int fpsFrameCount = 0;
+    double latencySum = 0.0;
+    uint64_t presentedFrames = 0;
+
+    // swap 返回之后调用：统计帧率、输入到上屏的延迟和上一帧的 GL 状态调用数，每 2 秒输出一次
+    auto framePresented = [&](const FrameSnapshot& snapshot) {
+        GLStateCache::endFrame();
+        if (++presentedFrames % PROFILE_COLLECT_FRAMES == 0) {
+            PROFILE_COLLECT();
+        }
+        fpsFrameCount++;
+        double now = glfwGetTime();
+        latencySum += now - snapshot.inputTime;
+        if (now - fpsWindowStart >= 2.0) {
+            double seconds = now - fpsWindowStart;
+            const GLStateStats& stateStats = GLStateCache::lastFrame();
+            LOG_INFO("{} x{}: {:.1f} fps, {:.3f} ms/frame, input latency {:.3f} ms, visible {}, "
+                     "GL state calls issued {} filtered {}",
+                     options.instanced ? "instanced" : "perdraw", options.instances, fpsFrameCount / seconds,
+                     seconds * 1000.0 / fpsFrameCount, latencySum * 1000.0 / fpsFrameCount, snapshot.visibleCount,
+                     stateStats.totalIssued(), stateStats.totalFiltered());
+            if (!options.instanced) {
+                const RenderQueue::Stats& queueStats = renderQueue.stats();
+                LOG_INFO("render queue: {} packets, sort {:.3f} ms, submit {:.3f} ms, {} recording task(s)",
+                         queueStats.packets, queueStats.sortMs, queueStats.submitMs, renderQueue.bucketCount());
+            }
+            fpsWindowStart = now;
+            fpsFrameCount = 0;
+            latencySum = 0.0;
         }
-        
-        // 设置纹理采样器数组
-        shader.setInt("textures[0]", 0);
-        shader.setInt("textures[1]", 1);
-        shader.setInt("textures[2]", 2);
-        shader.setInt("textures[3]", 3);
-        shader.setInt("textures[4]", 4);
-        shader.setInt("textures[5]", 5);
-
-        // 创建变换矩阵 - 使用四元数
-        glm::mat4 model = glm::mat4(1.0f);
-        model = model * glm::mat4_cast(currentRotation);
-
-        glm::mat4 view = glm::mat4(1.0f);
-        view = glm::translate(view, glm::vec3(0.0f, 0.0f, -3.0f));
-
-        glm::mat4 projection = glm::perspective(glm::radians(60.0f),
-                                              (float)WINDOW_WIDTH / (float)WINDOW_HEIGHT, 
-                                              0.1f, 100.0f);
-
-        // 传递矩阵到着色器
-        shader.setMat4("model", model);
-        shader.setMat4("view", view);
-        shader.setMat4("projection", projection);
-
-        // 绘制正方体
-        glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-
-        // 交换缓冲区并轮询事件
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    };
+
+    // 8. 主循环
+    TripleBuffer<FrameSnapshot> snapshots;
+    if (!options.threaded) {
+        // 单线程：输入、模拟、提交、swap 依次进行，swap 阻塞时输入和模拟也跟着等
+        while (!glfwWindowShouldClose(window)) {
+            PROFILE_SCOPE("frame");
+            processInput(window);
+            FrameSnapshot& snapshot = snapshots.writeBuffer();
+            simulate(snapshot);
+            renderFrame(snapshot);
+
+            // 交换缓冲区并轮询事件
+            {
+                PROFILE_SCOPE("glfwSwapBuffers");
+                glfwSwapBuffers(window);
+            }
+            glfwPollEvents();
+            framePresented(snapshot);
+        }
+    } else {
+        // 渲染线程：主线程只处理窗口事件和模拟，渲染线程拥有 GL context，
+        // 每帧取最新的快照提交，CPU 模拟下一帧和 GL 提交/swap 重叠进行
+        std::atomic<bool> running{true};
+        simulate(snapshots.writeBuffer());
+        snapshots.publish();
+        glfwMakeContextCurrent(nullptr);
+        std::thread renderThread([&] {
+            PROFILE_THREAD("render");
+            glfwMakeContextCurrent(window);
+            while (running.load(std::memory_order_acquire)) {
+                if (!snapshots.acquire()) {
+                    // 模拟比渲染慢，下一份快照还没好：睡到主线程 publish
+                    snapshots.waitForPublish();
+                    continue;
+                }
+                // 取走快照后唤醒主线程，让下一帧的模拟和这一帧的提交同时进行
+                glfwPostEmptyEvent();
+                PROFILE_SCOPE("frame");
+                const FrameSnapshot& snapshot = snapshots.readBuffer();
+                renderFrame(snapshot);
+                {
+                    PROFILE_SCOPE("glfwSwapBuffers");
+                    glfwSwapBuffers(window);
+                }
+                framePresented(snapshot);
+            }
+            glfwMakeContextCurrent(nullptr);
+        });
+
+        while (!glfwWindowShouldClose(window)) {
+            // 没有输入时一直睡眠，渲染线程取走快照时会用空事件唤醒
+            glfwWaitEvents();
+            processInput(window);
+            // 上一份快照已经被取走，或者有新输入(直接替换还没渲染的旧快照)时才重新模拟
+            if (!snapshots.pending() || inputChanged) {
+                inputChanged = false;
+                simulate(snapshots.writeBuffer());
+                snapshots.publish();
+            }
+        }
+        running.store(false, std::memory_order_release);
+        // 渲染线程可能正睡在 waitForPublish() 里，再 publish 一次把它叫醒
+        snapshots.publish();
+        renderThread.join();
+        // 清理资源需要 context
+        glfwMakeContextCurrent(window);
     }
 
     // 清理资源
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
-    glDeleteBuffers(1, &EBO);
-    glDeleteTextures(6, textures);
+    GLStateCache::deleteVertexArrays(1, &VAO);
+    GLStateCache::deleteBuffers(1, &VBO);
+    GLStateCache::deleteBuffers(1, &EBO);
+    if (instanceVBO) {
+        GLStateCache::deleteBuffers(1, &instanceVBO);
+    }
+    if (instanceStream) {
+        LOG_INFO("Instance stream buffer stalled {} time(s) waiting for the GPU", instanceStream->stallCount());
+        instanceStream->destroy();
+    }
+    frameConstantsBuffer.destroy();
+    gpuProfiler.destroy();
+    if (faceTextures.isReady()) {
+        GLuint texture = faceTextures.get();
+        GLStateCache::deleteTextures(1, &texture);
+    }
 
     glfwTerminate();
+    PROFILE_WRITE_TRACE("logs/trace_opengl_04.json");
+    Logger::shutdown();
     return 0;
 }
 
+bool parseOptions(int argc, char *argv[], DemoOptions& options) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--instances" && hasValue) {
+            options.instances = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--mode" && hasValue) {
+            std::string mode = argv[++i];
+            if (mode != "instanced" && mode != "perdraw") {
+                LOG_ERROR("Unknown --mode {}, expected instanced or perdraw", mode);
+                return false;
+            }
+            options.instanced = mode == "instanced";
+        } else if (arg == "--cull") {
+            options.cull = true;
+        } else if (arg == "--threaded") {
+            options.threaded = true;
+        } else if (arg == "--stream" && hasValue) {
+            std::string mode = argv[++i];
+            const StreamBuffer::Mode modes[] = {StreamBuffer::Mode::Auto, StreamBuffer::Mode::Persistent,
+                                                StreamBuffer::Mode::Unsynchronized, StreamBuffer::Mode::Orphan};
+            auto match = std::find_if(std::begin(modes), std::end(modes),
+                                      [&](StreamBuffer::Mode m) { return mode == StreamBuffer::modeName(m); });
+            if (match == std::end(modes)) {
+                LOG_ERROR("Unknown --stream {}, expected auto, persistent, unsynchronized or orphan", mode);
+                return false;
+            }
+            options.streamMode = *match;
+        } else {
+            LOG_ERROR("Unknown argument {}", arg);
+            LOG_INFO("usage: opengl_04 [--instances N] [--mode instanced|perdraw] [--cull] [--threaded] [--stream auto|persistent|unsynchronized|orphan]");
+            return false;
+        }
+    }
+    return true;
+}
+
+// 把 count 个正方体排进边长为 gridSide 的立方网格，中心在原点
+std::vector<InstanceData> buildInstanceGrid(int count, float spacing, int& gridSide) {
+    gridSide = (int)std::ceil(std::cbrt((double)count));
+    // cbrt 有舍入误差，保证 gridSide^3 >= count
+    while ((long long)gridSide * gridSide * gridSide < count) {
+        gridSide++;
+    }
+    float origin = -(gridSide - 1) * spacing * 0.5f;
+    std::vector<InstanceData> instances;
+    instances.reserve(count);
+    for (int i = 0; i < count; i++) {
+        int x = i % gridSide;
+        int y = (i / gridSide) % gridSide;
+        int z = i / (gridSide * gridSide);
+        glm::vec3 position(origin + x * spacing, origin + y * spacing, origin + z * spacing);
+        instances.push_back({glm::translate(glm::mat4(1.0f), position), i % 6});
+    }
+    return instances;
+}
+
 void processInput(GLFWwindow *window) {
+    PROFILE_FUNCTION();
     if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 }
 
 // 鼠标移动回调函数 - 轨迹球旋转
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
+    PROFILE_FUNCTION();
     // 只有在鼠标按下时才处理旋转
     if (!mousePressed) {
         lastX = xpos;
@@ -276,11 +668,9 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
     // 创建旋转四元数
     glm::quat rotation = glm::angleAxis(angle, axis);
     
-    // 更新当前旋转（组合旋转）
-    currentRotation = rotation * currentRotation;
-    
-    // 归一化四元数避免累积误差
-    currentRotation = glm::normalize(currentRotation);
+    // 更新根节点旋转（组合旋转），归一化四元数避免累积误差；只标记 dirty，下一帧统一计算
+    sceneTransforms.setRotation(sceneRoot, glm::normalize(rotation * sceneTransforms.rotation(sceneRoot)));
+    inputChanged = true;
     
     lastX = xpos;
     lastY = ypos;
@@ -303,6 +693,12 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
     }
 }
 
+// 滚轮拉近/拉远相机
+void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
+    cameraZoom = glm::clamp(cameraZoom * (yoffset > 0 ? 0.9f : 1.1f), 0.02f, 1.5f);
+    inputChanged = true;
+}
+
 // 将屏幕坐标映射到单位球面上（轨迹球算法核心）
 glm::vec3 screenToSphere(float x, float y) {
     // 将屏幕坐标转换到[-1, 1]范围
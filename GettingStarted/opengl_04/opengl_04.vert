@@ -1,18 +1,26 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec2 aTexCoord;
-layout (location = 2) in float aFaceId;
+layout (location = 2) in uint aFaceId;
 
 out vec2 TexCoord;
-out float FaceId;
+flat out int FaceId;
+
+// 每帧共享的常量，和 shader/UniformBuffer.h 中的 FrameConstants 保持一致
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 viewport;
+    vec4 time;
+};
 
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// 逐 draw 模式下每个正方体的贴图层偏移，对应 instanced 版本的 aLayerOffset
+uniform int layerOffset;
 
 void main()
 {
     gl_Position = projection * view * model * vec4(aPos, 1.0);
     TexCoord = aTexCoord;
-    FaceId = aFaceId;
-}
\ No newline at end of file
+    FaceId = (int(aFaceId) + layerOffset) % 6;
+}
@@ -0,0 +1,29 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec2 aTexCoord;
+layout (location = 2) in uint aFaceId;
+// 每个实例一份(glVertexAttribDivisor = 1)：mat4 占 3-6 四个 location
+layout (location = 3) in mat4 aInstanceModel;
+layout (location = 7) in int aLayerOffset;
+
+out vec2 TexCoord;
+flat out int FaceId;
+
+// 每帧共享的常量，和 shader/UniformBuffer.h 中的 FrameConstants 保持一致
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 viewport;
+    vec4 time;
+};
+
+// 所有实例共用的轨迹球旋转
+uniform mat4 model;
+
+void main()
+{
+    gl_Position = projection * view * model * aInstanceModel * vec4(aPos, 1.0);
+    TexCoord = aTexCoord;
+    // 每个实例把6张贴图错开若干层，方便分辨不同的正方体
+    FaceId = (int(aFaceId) + aLayerOffset) % 6;
+}
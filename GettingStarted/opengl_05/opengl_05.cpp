@@ -0,0 +1,288 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+/*
+ * Target: draw many different meshes with one glMultiDrawElementsIndirect
+ * usage: opengl_05 [--objects N] [--mesh path.obj|.gltf|.glb]
+ ***/
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#include "Utils/Logger.h"
+#include "shader/Shader.h"
+#include "Renderer/MeshLoader.h"
+#include "Renderer/MeshOptimizer.h"
+#include "Renderer/MeshPool.h"
+#include "Renderer/GLStateCache.h"
+#include "Renderer/IndirectBatch.h"
+
+int WINDOW_WIDTH = 800;
+int WINDOW_HEIGHT = 600;
+
+// 所有 mesh 都在 [-1, 1] 内，和 MeshLoader 加载的模型共用 MeshVertex(snorm16 位置 + 2_10_10_10 法线 + half uv，16 字节)
+// 每个 draw 的数据，按 std430 布局，和 opengl_05.vert 中的 DrawData 保持一致
+struct DrawData {
+    glm::mat4 model;
+    glm::vec4 color;
+};
+static_assert(sizeof(DrawData) == 80, "DrawData must match the std430 layout");
+
+struct SceneObject {
+    int mesh;
+    float scale;
+    glm::vec3 position;
+    glm::vec3 axis;
+    float spin;
+    glm::vec4 color;
+};
+
+void processInput(GLFWwindow* window);
+MeshRange addFlatMesh(MeshPool& pool, const char* name, const std::vector<glm::vec3>& triangles);
+std::vector<MeshRange> createMeshes(MeshPool& pool);
+
+int main(int argc, char *argv[]) {
+    Logger::init();
+    int objectCount = 20000;
+    std::string meshPath;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--objects" && i + 1 < argc) {
+            objectCount = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--mesh" && i + 1 < argc) {
+            meshPath = argv[++i];
+        } else {
+            LOG_ERROR("Unknown argument {}", arg);
+            LOG_INFO("usage: opengl_05 [--objects N] [--mesh path.obj|.gltf|.glb]");
+            Logger::shutdown();
+            return -1;
+        }
+    }
+
+    if (glfwInit() != GLFW_TRUE) {
+        LOG_ERROR("GLFW Init Error");
+        return -1;
+    }
+    // 尽量拿到 4.6/4.3 的 context 以使用 multi draw indirect，拿不到(例如 macOS)就用 3.3 逐个绘制
+    const int versions[][2] = {{4, 6}, {4, 3}, {3, 3}};
+    GLFWwindow* window = nullptr;
+    for (const auto& version : versions) {
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, version[0]);
+        glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, version[1]);
+        glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+        glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+        window = glfwCreateWindow(WINDOW_WIDTH, WINDOW_HEIGHT, "Multi Draw Indirect", NULL, NULL);
+        if (window) {
+            break;
+        }
+    }
+    if (!window) {
+        glfwTerminate();
+        LOG_ERROR("GLFW window create Error");
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    // 测吞吐时不能被垂直同步限制在刷新率上
+    glfwSwapInterval(0);
+
+    if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
+        LOG_ERROR("GLAD Init Error");
+        glfwTerminate();
+        return -1;
+    }
+    LOG_INFO("OpenGL {}", (const char*)glGetString(GL_VERSION));
+    GLStateCache::setEnabled(GL_DEPTH_TEST, true);
+
+    // 1. 所有 mesh 共用一个顶点格式，放进同一个 MeshPool
+    MeshData loadedMesh;
+    if (!meshPath.empty()) {
+        loadedMesh = MeshLoader::load(meshPath);
+        if (!loadedMesh.valid()) {
+            LOG_ERROR("Failed to load mesh {}", meshPath);
+        }
+    }
+    MeshPool meshPool(MeshVertexLayout::stride, MeshVertexLayout::attributes(),
+                      4096 + loadedMesh.vertexCount, 4096 + loadedMesh.indexCount);
+    std::vector<MeshRange> meshes = createMeshes(meshPool);
+    // 内置的形状大约是 [-0.5, 0.5]，加载的模型量化到了 [-1, 1]，缩小一半放进同样的格子
+    std::vector<float> meshScales(meshes.size(), 1.0f);
+    if (loadedMesh.valid()) {
+        meshes.push_back(meshPool.add(loadedMesh.vertices, loadedMesh.vertexCount,
+                                      loadedMesh.indices, loadedMesh.indexCount));
+        meshScales.push_back(0.5f);
+        // 数据已经在 VBO/EBO 中，释放 mmap 或者堆上的内存
+        loadedMesh = MeshData();
+    }
+
+    // 2. 选择绘制路径
+    IndirectBatch<DrawData> batch;
+    bool indirect = IndirectBatch<DrawData>::supported();
+    Shader shader = indirect
+        ? Shader("../GettingStarted/opengl_05/opengl_05.vert", "../GettingStarted/opengl_05/opengl_05.frag")
+        : Shader("../GettingStarted/opengl_05/opengl_05_fallback.vert", "../GettingStarted/opengl_05/opengl_05.frag");
+    UniformHandle<glm::mat4> modelUniform;
+    UniformHandle<glm::vec4> colorUniform;
+    if (!indirect) {
+        LOG_WARN("Multi draw indirect not supported, falling back to one glDrawElementsBaseVertex per object");
+        modelUniform = shader.uniform<glm::mat4>("model"_uniform);
+        colorUniform = shader.uniform<glm::vec4>("color"_uniform);
+    }
+
+    // 3. 物体排成立方网格，每个随机选一个 mesh、旋转轴和颜色
+    std::vector<SceneObject> objects;
+    objects.reserve(objectCount);
+    int gridSide = (int)std::ceil(std::cbrt((double)objectCount));
+    const float spacing = 1.6f;
+    float origin = -(gridSide - 1) * spacing * 0.5f;
+    srand(5);
+    auto random01 = [] { return (float)rand() / (float)RAND_MAX; };
+    for (int i = 0; i < objectCount; i++) {
+        SceneObject object;
+        object.mesh = i % (int)meshes.size();
+        object.scale = meshScales[object.mesh];
+        object.position = glm::vec3(origin + (i % gridSide) * spacing,
+                                    origin + ((i / gridSide) % gridSide) * spacing,
+                                    origin + (i / (gridSide * gridSide)) * spacing);
+        object.axis = glm::normalize(glm::vec3(random01() - 0.5f, random01() - 0.5f, random01() - 0.5f) + glm::vec3(0.0f, 0.01f, 0.0f));
+        object.spin = 0.5f + random01() * 2.0f;
+        object.color = glm::vec4(0.3f + 0.7f * random01(), 0.3f + 0.7f * random01(), 0.3f + 0.7f * random01(), 1.0f);
+        objects.push_back(object);
+    }
+
+    UniformBuffer<FrameConstants> frameConstantsBuffer(FRAME_CONSTANTS_BINDING);
+    FrameConstants frameConstants{};
+    float cameraDistance = 3.0f + gridSide * spacing * 1.5f;
+    float lastFrameTime = (float)glfwGetTime();
+    double fpsWindowStart = glfwGetTime();
+    int fpsFrameCount = 0;
+    LOG_INFO("Drawing {} objects, path = {}", objectCount, indirect ? "multi draw indirect" : "per-draw fallback");
+
+    while (!glfwWindowShouldClose(window)) {
+        processInput(window);
+
+        int framebufferWidth, framebufferHeight;
+        glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+        GLStateCache::viewport(0, 0, framebufferWidth, framebufferHeight);
+
+        // 相机绕网格缓慢旋转
+        float currentTime = (float)glfwGetTime();
+        glm::mat4 orbit = glm::rotate(glm::mat4(1.0f), currentTime * 0.2f, glm::vec3(0.0f, 1.0f, 0.0f));
+        frameConstants.view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -cameraDistance)) * orbit;
+        frameConstants.projection = glm::perspective(glm::radians(60.0f),
+                                                     (float)framebufferWidth / (float)std::max(framebufferHeight, 1),
+                                                     0.1f, cameraDistance * 3.0f);
+        frameConstants.viewport = glm::vec4(0.0f, 0.0f, (float)framebufferWidth, (float)framebufferHeight);
+        frameConstants.time = glm::vec4(currentTime, currentTime - lastFrameTime, 0.0f, 0.0f);
+        lastFrameTime = currentTime;
+        frameConstantsBuffer.update(frameConstants);
+
+        glClearColor(0.2f, 0.3f, 0.3f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        // 每帧重新生成命令，CPU 只填数组，GL 调用次数和物体数量无关
+        batch.clear();
+        for (const SceneObject& object : objects) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), object.position);
+            model = glm::rotate(model, currentTime * object.spin, object.axis);
+            model = glm::scale(model, glm::vec3(object.scale));
+            batch.add(meshes[object.mesh], {model, object.color});
+        }
+        shader.use();
+        batch.draw(meshPool, [&](const DrawData& data) {
+            shader.set(modelUniform, data.model);
+            shader.set(colorUniform, data.color);
+        });
+
+        glfwSwapBuffers(window);
+        glfwPollEvents();
+        GLStateCache::endFrame();
+
+        // 每 2 秒输出一次平均帧率和上一帧的 GL 状态调用数
+        fpsFrameCount++;
+        double now = glfwGetTime();
+        if (now - fpsWindowStart >= 2.0) {
+            double seconds = now - fpsWindowStart;
+            const GLStateStats& stateStats = GLStateCache::lastFrame();
+            LOG_INFO("{} objects: {:.1f} fps, {:.3f} ms/frame, GL state calls issued {} filtered {}", objectCount,
+                     fpsFrameCount / seconds, seconds * 1000.0 / fpsFrameCount,
+                     stateStats.totalIssued(), stateStats.totalFiltered());
+            fpsWindowStart = now;
+            fpsFrameCount = 0;
+        }
+    }
+
+    meshPool.destroy();
+    batch.destroy();
+    frameConstantsBuffer.destroy();
+    glDeleteProgram(shader.ID);
+
+    glfwTerminate();
+    Logger::shutdown();
+    return 0;
+}
+
+void processInput(GLFWwindow* window) {
+    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
+        glfwSetWindowShouldClose(window, true);
+    }
+}
+
+// 三个点一个三角形，按面法线展开成平面着色的顶点
+MeshRange addFlatMesh(MeshPool& pool, const char* name, const std::vector<glm::vec3>& triangles) {
+    std::vector<MeshVertex> vertices;
+    std::vector<uint32_t> indices;
+    for (size_t i = 0; i + 2 < triangles.size(); i += 3) {
+        glm::vec3 normal = glm::normalize(glm::cross(triangles[i + 1] - triangles[i], triangles[i + 2] - triangles[i]));
+        for (int corner = 0; corner < 3; corner++) {
+            indices.push_back((uint32_t)vertices.size());
+            vertices.push_back({Snorm16x4(triangles[i + corner]), PackedNormal(normal), Half2(0.0f, 0.0f)});
+        }
+    }
+    // 同一个面上的顶点会被合并，三角形按顶点缓存重排
+    MeshOptimizer::optimize(name, vertices, indices, [](const MeshVertex& vertex) { return vertex.position.unpack(); });
+    return pool.add(vertices.data(), (uint32_t)vertices.size(), indices.data(), (uint32_t)indices.size());
+}
+
+// 正方体、四棱锥、八面体、四面体，顶点数和索引数都不同
+std::vector<MeshRange> createMeshes(MeshPool& pool) {
+    std::vector<MeshRange> meshes;
+
+    const glm::vec3 c[8] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f,  0.5f}, {0.5f, -0.5f,  0.5f}, {0.5f, 0.5f,  0.5f}, {-0.5f, 0.5f,  0.5f},
+    };
+    meshes.push_back(addFlatMesh(pool, "cube", {
+        c[4], c[5], c[6], c[6], c[7], c[4],   // 前
+        c[1], c[0], c[3], c[3], c[2], c[1],   // 后
+        c[0], c[4], c[7], c[7], c[3], c[0],   // 左
+        c[5], c[1], c[2], c[2], c[6], c[5],   // 右
+        c[7], c[6], c[2], c[2], c[3], c[7],   // 上
+        c[0], c[1], c[5], c[5], c[4], c[0],   // 下
+    }));
+
+    const glm::vec3 apex(0.0f, 0.6f, 0.0f);
+    meshes.push_back(addFlatMesh(pool, "pyramid", {
+        c[4], c[5], apex,   c[5], c[1], apex,   c[1], c[0], apex,   c[0], c[4], apex,
+        c[0], c[1], c[5],   c[5], c[4], c[0],
+    }));
+
+    const glm::vec3 px(0.6f, 0, 0), nx(-0.6f, 0, 0), py(0, 0.6f, 0), ny(0, -0.6f, 0), pz(0, 0, 0.6f), nz(0, 0, -0.6f);
+    meshes.push_back(addFlatMesh(pool, "octahedron", {
+        px, py, pz,   pz, py, nx,   nx, py, nz,   nz, py, px,
+        px, pz, ny,   pz, nx, ny,   nx, nz, ny,   nz, px, ny,
+    }));
+
+    const glm::vec3 t0(0.5f, 0.5f, 0.5f), t1(-0.5f, -0.5f, 0.5f), t2(-0.5f, 0.5f, -0.5f), t3(0.5f, -0.5f, -0.5f);
+    meshes.push_back(addFlatMesh(pool, "tetrahedron", {
+        t0, t1, t3,   t0, t2, t1,   t0, t3, t2,   t1, t2, t3,
+    }));
+    return meshes;
+}
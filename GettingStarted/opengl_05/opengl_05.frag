@@ -0,0 +1,13 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec3 Normal;
+in vec4 Color;
+
+void main()
+{
+    // 简单的方向光 + 环境光，只是为了看清各个面
+    vec3 lightDir = normalize(vec3(0.4, 0.8, 0.6));
+    float diffuse = max(dot(normalize(Normal), lightDir), 0.0);
+    FragColor = vec4(Color.rgb * (0.25 + 0.75 * diffuse), Color.a);
+}
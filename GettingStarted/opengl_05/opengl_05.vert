@@ -0,0 +1,33 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+out vec3 Normal;
+out vec4 Color;
+
+// 每帧共享的常量，和 shader/UniformBuffer.h 中的 FrameConstants 保持一致
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 viewport;
+    vec4 time;
+};
+
+// 每个 draw 一项，和 opengl_05.cpp 中的 DrawData 保持一致 (std430)
+struct DrawData {
+    mat4 model;
+    vec4 color;
+};
+layout (std430, binding = 0) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+};
+
+void main()
+{
+    // glMultiDrawElementsIndirect 中当前命令的序号
+    DrawData draw = draws[gl_DrawIDARB];
+    gl_Position = projection * view * draw.model * vec4(aPos, 1.0);
+    Normal = mat3(draw.model) * aNormal;
+    Color = draw.color;
+}
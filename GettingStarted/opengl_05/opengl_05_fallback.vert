@@ -0,0 +1,25 @@
+#version 330 core
+layout (location = 0) in vec3 aPos;
+layout (location = 1) in vec3 aNormal;
+
+out vec3 Normal;
+out vec4 Color;
+
+// 每帧共享的常量，和 shader/UniformBuffer.h 中的 FrameConstants 保持一致
+layout (std140) uniform FrameConstants {
+    mat4 view;
+    mat4 projection;
+    vec4 viewport;
+    vec4 time;
+};
+
+// 不支持 multi draw indirect 时逐个 draw 设置
+uniform mat4 model;
+uniform vec4 color;
+
+void main()
+{
+    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    Normal = mat3(model) * aNormal;
+    Color = color;
+}
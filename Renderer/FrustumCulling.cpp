@@ -0,0 +1,346 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "FrustumCulling.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RENDERER_CULL_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define RENDERER_CULL_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2 的函数单独打开指令集，其余代码仍按默认目标编译，运行时再决定走哪条路径
+#if defined(RENDERER_CULL_X86) && (defined(__GNUC__) || defined(__clang__))
+#define RENDERER_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define RENDERER_TARGET_AVX2
+#endif
+
+namespace {
+    // 球和盒子共用的输入，球只用到 extentX(半径)
+    struct Bounds {
+        const float* centerX;
+        const float* centerY;
+        const float* centerZ;
+        const float* extentX;
+        const float* extentY;
+        const float* extentZ;
+    };
+
+    // 每个平面预先算好的系数，盒子需要法线的绝对值
+    struct PlaneSet {
+        float nx[6], ny[6], nz[6], d[6];
+        float ax[6], ay[6], az[6];
+    };
+
+    PlaneSet makePlaneSet(const Frustum& frustum) {
+        PlaneSet set{};
+        for (int p = 0; p < 6; p++) {
+            set.nx[p] = frustum.planes[p].x;
+            set.ny[p] = frustum.planes[p].y;
+            set.nz[p] = frustum.planes[p].z;
+            set.d[p] = frustum.planes[p].w;
+            set.ax[p] = std::fabs(frustum.planes[p].x);
+            set.ay[p] = std::fabs(frustum.planes[p].y);
+            set.az[p] = std::fabs(frustum.planes[p].z);
+        }
+        return set;
+    }
+
+    // 无分支压缩：每个下标都写一次，可见时才前进
+    inline size_t emitMask(uint32_t mask, int lanes, uint32_t base, uint32_t* out, size_t written) {
+        for (int lane = 0; lane < lanes; lane++) {
+            out[written] = base + (uint32_t)lane;
+            written += (mask >> lane) & 1u;
+        }
+        return written;
+    }
+
+    template<bool kBoxes>
+    size_t cullScalar(const PlaneSet& planes, const Bounds& in, size_t begin, size_t end, uint32_t* out) {
+        size_t written = 0;
+        for (size_t i = begin; i < end; i++) {
+            bool inside = true;
+            for (int p = 0; p < 6; p++) {
+                float distance = planes.nx[p] * in.centerX[i] + planes.ny[p] * in.centerY[i] +
+                                 planes.nz[p] * in.centerZ[i] + planes.d[p];
+                float radius = kBoxes
+                    ? planes.ax[p] * in.extentX[i] + planes.ay[p] * in.extentY[i] + planes.az[p] * in.extentZ[i]
+                    : in.extentX[i];
+                inside = inside && distance >= -radius;
+            }
+            out[written] = (uint32_t)i;
+            written += inside ? 1 : 0;
+        }
+        return written;
+    }
+
+#ifdef RENDERER_CULL_X86
+    template<bool kBoxes>
+    size_t cullSSE(const PlaneSet& planes, const Bounds& in, size_t begin, size_t end, uint32_t* out) {
+        size_t written = 0;
+        size_t i = begin;
+        for (; i + 4 <= end; i += 4) {
+            __m128 x = _mm_loadu_ps(in.centerX + i);
+            __m128 y = _mm_loadu_ps(in.centerY + i);
+            __m128 z = _mm_loadu_ps(in.centerZ + i);
+            __m128 ex = _mm_loadu_ps(in.extentX + i);
+            __m128 ey = kBoxes ? _mm_loadu_ps(in.extentY + i) : ex;
+            __m128 ez = kBoxes ? _mm_loadu_ps(in.extentZ + i) : ex;
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                __m128 distance = _mm_add_ps(
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nx[p]), x), _mm_mul_ps(_mm_set1_ps(planes.ny[p]), y)),
+                    _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.nz[p]), z), _mm_set1_ps(planes.d[p])));
+                __m128 radius = kBoxes
+                    ? _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(planes.ax[p]), ex), _mm_mul_ps(_mm_set1_ps(planes.ay[p]), ey)),
+                                 _mm_mul_ps(_mm_set1_ps(planes.az[p]), ez))
+                    : ex;
+                // distance + radius >= 0
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+            }
+            written = emitMask((uint32_t)_mm_movemask_ps(inside), 4, (uint32_t)i, out, written);
+        }
+        return written + cullScalar<kBoxes>(planes, in, i, end, out + written);
+    }
+
+    template<bool kBoxes>
+    RENDERER_TARGET_AVX2 size_t cullAVX2(const PlaneSet& planes, const Bounds& in, size_t begin, size_t end, uint32_t* out) {
+        size_t written = 0;
+        size_t i = begin;
+        for (; i + 8 <= end; i += 8) {
+            __m256 x = _mm256_loadu_ps(in.centerX + i);
+            __m256 y = _mm256_loadu_ps(in.centerY + i);
+            __m256 z = _mm256_loadu_ps(in.centerZ + i);
+            __m256 ex = _mm256_loadu_ps(in.extentX + i);
+            __m256 ey = kBoxes ? _mm256_loadu_ps(in.extentY + i) : ex;
+            __m256 ez = kBoxes ? _mm256_loadu_ps(in.extentZ + i) : ex;
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (int p = 0; p < 6; p++) {
+                __m256 distance = _mm256_add_ps(
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nx[p]), x), _mm256_mul_ps(_mm256_set1_ps(planes.ny[p]), y)),
+                    _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.nz[p]), z), _mm256_set1_ps(planes.d[p])));
+                __m256 radius = kBoxes
+                    ? _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(planes.ax[p]), ex), _mm256_mul_ps(_mm256_set1_ps(planes.ay[p]), ey)),
+                                    _mm256_mul_ps(_mm256_set1_ps(planes.az[p]), ez))
+                    : ex;
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+            }
+            written = emitMask((uint32_t)_mm256_movemask_ps(inside), 8, (uint32_t)i, out, written);
+        }
+        // 剩下不足 8 个的交给 SSE/标量
+        return written + cullSSE<kBoxes>(planes, in, i, end, out + written);
+    }
+
+    bool cpuHasAVX2() {
+#if defined(_MSC_VER)
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7) {
+            return false;
+        }
+        __cpuid(info, 1);
+        // 操作系统必须开启 OSXSAVE 并保存 YMM 寄存器
+        bool osxsave = (info[2] & (1 << 27)) != 0;
+        if (!osxsave || (_xgetbv(0) & 0x6) != 0x6) {
+            return false;
+        }
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        return __builtin_cpu_supports("avx2");
+#endif
+    }
+#endif
+
+#ifdef RENDERER_CULL_NEON
+    template<bool kBoxes>
+    size_t cullNEON(const PlaneSet& planes, const Bounds& in, size_t begin, size_t end, uint32_t* out) {
+        size_t written = 0;
+        size_t i = begin;
+        const uint32_t laneBitsData[4] = {1, 2, 4, 8};
+        uint32x4_t laneBits = vld1q_u32(laneBitsData);
+        for (; i + 4 <= end; i += 4) {
+            float32x4_t x = vld1q_f32(in.centerX + i);
+            float32x4_t y = vld1q_f32(in.centerY + i);
+            float32x4_t z = vld1q_f32(in.centerZ + i);
+            float32x4_t ex = vld1q_f32(in.extentX + i);
+            float32x4_t ey = kBoxes ? vld1q_f32(in.extentY + i) : ex;
+            float32x4_t ez = kBoxes ? vld1q_f32(in.extentZ + i) : ex;
+            uint32x4_t inside = vdupq_n_u32(0xFFFFFFFFu);
+            for (int p = 0; p < 6; p++) {
+                float32x4_t distance = vdupq_n_f32(planes.d[p]);
+                distance = vmlaq_n_f32(distance, x, planes.nx[p]);
+                distance = vmlaq_n_f32(distance, y, planes.ny[p]);
+                distance = vmlaq_n_f32(distance, z, planes.nz[p]);
+                float32x4_t radius = ex;
+                if (kBoxes) {
+                    radius = vmulq_n_f32(ex, planes.ax[p]);
+                    radius = vmlaq_n_f32(radius, ey, planes.ay[p]);
+                    radius = vmlaq_n_f32(radius, ez, planes.az[p]);
+                }
+                inside = vandq_u32(inside, vcgeq_f32(vaddq_f32(distance, radius), vdupq_n_f32(0.0f)));
+            }
+            uint32_t mask = vaddvq_u32(vandq_u32(inside, laneBits));
+            written = emitMask(mask, 4, (uint32_t)i, out, written);
+        }
+        return written + cullScalar<kBoxes>(planes, in, i, end, out + written);
+    }
+#endif
+
+    template<bool kBoxes>
+    size_t cullRange(FrustumCulling::Backend backend, const PlaneSet& planes, const Bounds& in,
+                     size_t begin, size_t end, uint32_t* out) {
+        switch (backend) {
+#ifdef RENDERER_CULL_X86
+            case FrustumCulling::Backend::AVX2:
+                return cullAVX2<kBoxes>(planes, in, begin, end, out);
+            case FrustumCulling::Backend::SSE:
+                return cullSSE<kBoxes>(planes, in, begin, end, out);
+#endif
+#ifdef RENDERER_CULL_NEON
+            case FrustumCulling::Backend::NEON:
+                return cullNEON<kBoxes>(planes, in, begin, end, out);
+#endif
+            default:
+                return cullScalar<kBoxes>(planes, in, begin, end, out);
+        }
+    }
+
+    template<bool kBoxes>
+    size_t cullParallelImpl(const Frustum& frustum, const Bounds& in, size_t count, uint32_t* visible,
+                            ThreadPool& pool, size_t minChunk) {
+        FrustumCulling::Backend backend = FrustumCulling::bestBackend();
+        PlaneSet planes = makePlaneSet(frustum);
+        // 块大小取 8 的倍数，让每块都能整组走 SIMD
+        size_t chunkSize = std::max(minChunk, (count + pool.threadCount()) / (pool.threadCount() + 1));
+        chunkSize = (chunkSize + 7) & ~(size_t)7;
+        if (count <= chunkSize) {
+            return cullRange<kBoxes>(backend, planes, in, 0, count, visible);
+        }
+
+        // 可见下标一定落在本块范围内，所以每块直接写到 visible + begin，互不重叠
+        std::vector<size_t> written((count + chunkSize - 1) / chunkSize);
+        pool.parallelFor(count, chunkSize, [&](size_t begin, size_t end) {
+            written[begin / chunkSize] = cullRange<kBoxes>(backend, planes, in, begin, end, visible + begin);
+        });
+
+        size_t total = written[0];
+        for (size_t chunk = 1; chunk < written.size(); chunk++) {
+            std::memmove(visible + total, visible + chunk * chunkSize, written[chunk] * sizeof(uint32_t));
+            total += written[chunk];
+        }
+        return total;
+    }
+
+    Bounds toBounds(const SphereSoA& spheres) {
+        return {spheres.centerX, spheres.centerY, spheres.centerZ, spheres.radius, nullptr, nullptr};
+    }
+
+    Bounds toBounds(const AabbSoA& boxes) {
+        return {boxes.centerX, boxes.centerY, boxes.centerZ, boxes.extentX, boxes.extentY, boxes.extentZ};
+    }
+}
+
+Frustum Frustum::fromMatrix(const glm::mat4& viewProjection) {
+    // Gribb/Hartmann：裁剪空间 -w <= x,y,z <= w 对应矩阵第 4 行加/减前三行
+    const glm::mat4& m = viewProjection;
+    glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum frustum;
+    frustum.planes[0] = row3 + row0;   // left
+    frustum.planes[1] = row3 - row0;   // right
+    frustum.planes[2] = row3 + row1;   // bottom
+    frustum.planes[3] = row3 - row1;   // top
+    frustum.planes[4] = row3 + row2;   // near
+    frustum.planes[5] = row3 - row2;   // far
+    for (glm::vec4& plane : frustum.planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) {
+            plane /= length;
+        }
+    }
+    return frustum;
+}
+
+bool FrustumCulling::backendSupported(Backend backend) {
+    switch (backend) {
+        case Backend::Scalar:
+            return true;
+#ifdef RENDERER_CULL_X86
+        case Backend::SSE:
+            return true;
+        case Backend::AVX2: {
+            static const bool s_avx2 = cpuHasAVX2();
+            return s_avx2;
+        }
+#endif
+#ifdef RENDERER_CULL_NEON
+        case Backend::NEON:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+FrustumCulling::Backend FrustumCulling::bestBackend() {
+    static const Backend s_best = [] {
+        for (Backend backend : {Backend::AVX2, Backend::NEON, Backend::SSE}) {
+            if (backendSupported(backend)) {
+                return backend;
+            }
+        }
+        return Backend::Scalar;
+    }();
+    return s_best;
+}
+
+const char* FrustumCulling::backendName(Backend backend) {
+    switch (backend) {
+        case Backend::SSE: return "SSE";
+        case Backend::AVX2: return "AVX2";
+        case Backend::NEON: return "NEON";
+        default: return "Scalar";
+    }
+}
+
+size_t FrustumCulling::cull(const Frustum& frustum, const SphereSoA& spheres, uint32_t* visible, Backend backend) {
+    if (!backendSupported(backend)) {
+        backend = Backend::Scalar;
+    }
+    return cullRange<false>(backend, makePlaneSet(frustum), toBounds(spheres), 0, spheres.count, visible);
+}
+
+size_t FrustumCulling::cull(const Frustum& frustum, const AabbSoA& boxes, uint32_t* visible, Backend backend) {
+    if (!backendSupported(backend)) {
+        backend = Backend::Scalar;
+    }
+    return cullRange<true>(backend, makePlaneSet(frustum), toBounds(boxes), 0, boxes.count, visible);
+}
+
+size_t FrustumCulling::cullParallel(const Frustum& frustum, const SphereSoA& spheres, uint32_t* visible,
+                                    ThreadPool& pool, size_t minChunk) {
+    return cullParallelImpl<false>(frustum, toBounds(spheres), spheres.count, visible, pool, minChunk);
+}
+
+size_t FrustumCulling::cullParallel(const Frustum& frustum, const AabbSoA& boxes, uint32_t* visible,
+                                    ThreadPool& pool, size_t minChunk) {
+    return cullParallelImpl<true>(frustum, toBounds(boxes), boxes.count, visible, pool, minChunk);
+}
@@ -0,0 +1,70 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_FRUSTUMCULLING_H
+#define RENDERER_FRUSTUMCULLING_H
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+
+class ThreadPool;
+
+// 从 projection * view (* model) 中提取的 6 个平面，法线朝内并已归一化，
+// 点 p 在平面内侧当且仅当 dot(plane.xyz, p) + plane.w >= 0
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromMatrix(const glm::mat4& viewProjection);
+};
+
+// 包围球，SoA 布局，每个分量一个连续数组
+struct SphereSoA {
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* radius;
+    size_t count;
+};
+
+// 轴对齐包围盒，用中心 + 半边长表示，SoA 布局
+struct AabbSoA {
+    const float* centerX;
+    const float* centerY;
+    const float* centerZ;
+    const float* extentX;
+    const float* extentY;
+    const float* extentZ;
+    size_t count;
+};
+
+// 批量视锥剔除：一次测试 8 个(AVX2)或 4 个(SSE/NEON)物体，输出按升序排列的可见物体下标。
+// visible 至少要能放下 count 个下标，返回值是可见物体的数量。
+class FrustumCulling {
+public:
+    enum class Backend {
+        Scalar,
+        SSE,
+        AVX2,
+        NEON,
+    };
+
+    // 当前 CPU 上最快的实现，运行时检测一次
+    static Backend bestBackend();
+    static bool backendSupported(Backend backend);
+    static const char* backendName(Backend backend);
+
+    static size_t cull(const Frustum& frustum, const SphereSoA& spheres, uint32_t* visible,
+                       Backend backend = bestBackend());
+    static size_t cull(const Frustum& frustum, const AabbSoA& boxes, uint32_t* visible,
+                       Backend backend = bestBackend());
+
+    // 数量超过 minChunk 时切块放进线程池，每块各自写到 visible 中自己的区间，最后再压紧
+    static size_t cullParallel(const Frustum& frustum, const SphereSoA& spheres, uint32_t* visible,
+                               ThreadPool& pool, size_t minChunk = 16384);
+    static size_t cullParallel(const Frustum& frustum, const AabbSoA& boxes, uint32_t* visible,
+                               ThreadPool& pool, size_t minChunk = 16384);
+};
+
+
+#endif //RENDERER_FRUSTUMCULLING_H
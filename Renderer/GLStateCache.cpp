@@ -0,0 +1,380 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "GLStateCache.h"
+
+namespace {
+    // 记录值未知时必须发出调用
+    constexpr GLuint kUnknown = 0xFFFFFFFFu;
+
+    enum BufferSlot {
+        ArrayBufferSlot,
+        ElementArrayBufferSlot,
+        UniformBufferSlot,
+        ShaderStorageBufferSlot,
+        DrawIndirectBufferSlot,
+        BufferSlotCount,
+    };
+
+    enum TextureSlot {
+        Texture2DSlot,
+        Texture2DArraySlot,
+        TextureCubeMapSlot,
+        Texture3DSlot,
+        TextureSlotCount,
+    };
+
+    enum CapabilitySlot {
+        BlendSlot,
+        DepthTestSlot,
+        CullFaceSlot,
+        ScissorTestSlot,
+        CapabilitySlotCount,
+    };
+
+    struct IndexedBinding {
+        GLuint buffer = kUnknown;
+        GLintptr offset = 0;
+        GLsizeiptr size = 0;
+    };
+
+    struct State {
+        GLuint program = kUnknown;
+        GLuint vao = kUnknown;
+        GLuint buffers[BufferSlotCount];
+        IndexedBinding uniformBindings[GLStateCache::kMaxBufferBindings];
+        IndexedBinding storageBindings[GLStateCache::kMaxBufferBindings];
+        GLuint activeUnit = kUnknown;
+        GLuint textures[GLStateCache::kMaxTextureUnits][TextureSlotCount];
+        GLuint samplers[GLStateCache::kMaxTextureUnits];
+        // -1 未知，0 关闭，1 开启
+        int capabilities[CapabilitySlotCount];
+        GLenum blendSource = kUnknown;
+        GLenum blendDestination = kUnknown;
+        GLenum depthFunc = kUnknown;
+        int depthMask = -1;
+        GLint viewport[4] = {};
+        bool viewportKnown = false;
+
+        State() {
+            for (GLuint& buffer : buffers) buffer = kUnknown;
+            for (auto& unit : textures) {
+                for (GLuint& texture : unit) texture = kUnknown;
+            }
+            for (GLuint& sampler : samplers) sampler = kUnknown;
+            for (int& capability : capabilities) capability = -1;
+        }
+    };
+
+    State s_state;
+    GLStateStats s_currentFrame;
+    GLStateStats s_lastFrame;
+
+    // 和记录相同时计为 filtered 并返回 true，否则计为 issued
+    bool redundant(GLStateStats::Category category, bool same) {
+        if (same) {
+            s_currentFrame.filtered[category]++;
+            return true;
+        }
+        s_currentFrame.issued[category]++;
+        return false;
+    }
+
+    int bufferSlot(GLenum target) {
+        switch (target) {
+            case GL_ARRAY_BUFFER: return ArrayBufferSlot;
+            case GL_ELEMENT_ARRAY_BUFFER: return ElementArrayBufferSlot;
+            case GL_UNIFORM_BUFFER: return UniformBufferSlot;
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_shader_storage_buffer_object)
+            case GL_SHADER_STORAGE_BUFFER: return ShaderStorageBufferSlot;
+#endif
+#if defined(GL_VERSION_4_0) || defined(GL_ARB_draw_indirect)
+            case GL_DRAW_INDIRECT_BUFFER: return DrawIndirectBufferSlot;
+#endif
+            default: return -1;
+        }
+    }
+
+    IndexedBinding* indexedBinding(GLenum target, GLuint index) {
+        if (index >= GLStateCache::kMaxBufferBindings) {
+            return nullptr;
+        }
+        switch (bufferSlot(target)) {
+            case UniformBufferSlot: return &s_state.uniformBindings[index];
+            case ShaderStorageBufferSlot: return &s_state.storageBindings[index];
+            default: return nullptr;
+        }
+    }
+
+    int textureSlot(GLenum target) {
+        switch (target) {
+            case GL_TEXTURE_2D: return Texture2DSlot;
+            case GL_TEXTURE_2D_ARRAY: return Texture2DArraySlot;
+            case GL_TEXTURE_CUBE_MAP: return TextureCubeMapSlot;
+            case GL_TEXTURE_3D: return Texture3DSlot;
+            default: return -1;
+        }
+    }
+
+    int capabilitySlot(GLenum capability) {
+        switch (capability) {
+            case GL_BLEND: return BlendSlot;
+            case GL_DEPTH_TEST: return DepthTestSlot;
+            case GL_CULL_FACE: return CullFaceSlot;
+            case GL_SCISSOR_TEST: return ScissorTestSlot;
+            default: return -1;
+        }
+    }
+
+    void activeTexture(GLuint unit) {
+        if (redundant(GLStateStats::Texture, s_state.activeUnit == unit)) {
+            return;
+        }
+        glActiveTexture(GL_TEXTURE0 + unit);
+        s_state.activeUnit = unit;
+    }
+}
+
+uint32_t GLStateStats::totalIssued() const {
+    uint32_t total = 0;
+    for (uint32_t count : issued) total += count;
+    return total;
+}
+
+uint32_t GLStateStats::totalFiltered() const {
+    uint32_t total = 0;
+    for (uint32_t count : filtered) total += count;
+    return total;
+}
+
+const char* GLStateStats::categoryName(Category category) {
+    switch (category) {
+        case Program: return "program";
+        case VertexArray: return "vao";
+        case Buffer: return "buffer";
+        case Texture: return "texture";
+        case Sampler: return "sampler";
+        case Capability: return "capability";
+        case Viewport: return "viewport";
+        default: return "unknown";
+    }
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (redundant(GLStateStats::Program, s_state.program == program)) {
+        return;
+    }
+    glUseProgram(program);
+    s_state.program = program;
+}
+
+void GLStateCache::bindVertexArray(GLuint vao) {
+    if (redundant(GLStateStats::VertexArray, s_state.vao == vao)) {
+        return;
+    }
+    glBindVertexArray(vao);
+    s_state.vao = vao;
+    // element buffer 绑定属于 VAO
+    s_state.buffers[ElementArrayBufferSlot] = kUnknown;
+}
+
+void GLStateCache::bindBuffer(GLenum target, GLuint buffer) {
+    int slot = bufferSlot(target);
+    if (redundant(GLStateStats::Buffer, slot >= 0 && s_state.buffers[slot] == buffer)) {
+        return;
+    }
+    glBindBuffer(target, buffer);
+    if (slot >= 0) {
+        s_state.buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    IndexedBinding* binding = indexedBinding(target, index);
+    // size 为 0 表示整个缓冲
+    if (redundant(GLStateStats::Buffer, binding && binding->buffer == buffer && binding->offset == 0 && binding->size == 0)) {
+        return;
+    }
+    glBindBufferBase(target, index, buffer);
+    if (binding) {
+        *binding = {buffer, 0, 0};
+    }
+    int slot = bufferSlot(target);
+    if (slot >= 0) {
+        s_state.buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+    IndexedBinding* binding = indexedBinding(target, index);
+    if (redundant(GLStateStats::Buffer,
+                  binding && binding->buffer == buffer && binding->offset == offset && binding->size == size)) {
+        return;
+    }
+    glBindBufferRange(target, index, buffer, offset, size);
+    if (binding) {
+        *binding = {buffer, offset, size};
+    }
+    int slot = bufferSlot(target);
+    if (slot >= 0) {
+        s_state.buffers[slot] = buffer;
+    }
+}
+
+void GLStateCache::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+    int slot = textureSlot(target);
+    if (unit >= kMaxTextureUnits || slot < 0) {
+        s_currentFrame.issued[GLStateStats::Texture] += 2;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        glBindTexture(target, texture);
+        s_state.activeUnit = unit < kMaxTextureUnits ? unit : kUnknown;
+        return;
+    }
+    if (redundant(GLStateStats::Texture, s_state.textures[unit][slot] == texture)) {
+        return;
+    }
+    activeTexture(unit);
+    glBindTexture(target, texture);
+    s_state.textures[unit][slot] = texture;
+}
+
+void GLStateCache::bindTexture(GLenum target, GLuint texture) {
+    if (s_state.activeUnit == kUnknown) {
+        // 不知道当前是哪个单元，统一切到 0
+        activeTexture(0);
+    }
+    bindTexture(s_state.activeUnit, target, texture);
+}
+
+void GLStateCache::bindSampler(GLuint unit, GLuint sampler) {
+    bool cached = unit < kMaxTextureUnits;
+    if (redundant(GLStateStats::Sampler, cached && s_state.samplers[unit] == sampler)) {
+        return;
+    }
+    glBindSampler(unit, sampler);
+    if (cached) {
+        s_state.samplers[unit] = sampler;
+    }
+}
+
+void GLStateCache::setEnabled(GLenum capability, bool enabled) {
+    int slot = capabilitySlot(capability);
+    if (redundant(GLStateStats::Capability, slot >= 0 && s_state.capabilities[slot] == (int)enabled)) {
+        return;
+    }
+    if (enabled) {
+        glEnable(capability);
+    } else {
+        glDisable(capability);
+    }
+    if (slot >= 0) {
+        s_state.capabilities[slot] = enabled ? 1 : 0;
+    }
+}
+
+void GLStateCache::blendFunc(GLenum source, GLenum destination) {
+    if (redundant(GLStateStats::Capability, s_state.blendSource == source && s_state.blendDestination == destination)) {
+        return;
+    }
+    glBlendFunc(source, destination);
+    s_state.blendSource = source;
+    s_state.blendDestination = destination;
+}
+
+void GLStateCache::depthFunc(GLenum func) {
+    if (redundant(GLStateStats::Capability, s_state.depthFunc == func)) {
+        return;
+    }
+    glDepthFunc(func);
+    s_state.depthFunc = func;
+}
+
+void GLStateCache::depthMask(bool write) {
+    if (redundant(GLStateStats::Capability, s_state.depthMask == (int)write)) {
+        return;
+    }
+    glDepthMask(write ? GL_TRUE : GL_FALSE);
+    s_state.depthMask = write ? 1 : 0;
+}
+
+void GLStateCache::viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    const GLint* current = s_state.viewport;
+    if (redundant(GLStateStats::Viewport, s_state.viewportKnown && current[0] == x && current[1] == y &&
+                                          current[2] == width && current[3] == height)) {
+        return;
+    }
+    glViewport(x, y, width, height);
+    s_state.viewport[0] = x;
+    s_state.viewport[1] = y;
+    s_state.viewport[2] = width;
+    s_state.viewport[3] = height;
+    s_state.viewportKnown = true;
+}
+
+void GLStateCache::deleteTextures(GLsizei count, const GLuint* textures) {
+    glDeleteTextures(count, textures);
+    for (GLsizei i = 0; i < count; i++) {
+        if (textures[i] == 0) {
+            continue;
+        }
+        for (auto& unit : s_state.textures) {
+            for (GLuint& texture : unit) {
+                if (texture == textures[i]) {
+                    texture = 0;
+                }
+            }
+        }
+    }
+}
+
+void GLStateCache::deleteBuffers(GLsizei count, const GLuint* buffers) {
+    glDeleteBuffers(count, buffers);
+    for (GLsizei i = 0; i < count; i++) {
+        if (buffers[i] == 0) {
+            continue;
+        }
+        for (GLuint& buffer : s_state.buffers) {
+            if (buffer == buffers[i]) {
+                buffer = 0;
+            }
+        }
+        for (IndexedBinding& binding : s_state.uniformBindings) {
+            if (binding.buffer == buffers[i]) {
+                binding = {0, 0, 0};
+            }
+        }
+        for (IndexedBinding& binding : s_state.storageBindings) {
+            if (binding.buffer == buffers[i]) {
+                binding = {0, 0, 0};
+            }
+        }
+    }
+}
+
+void GLStateCache::deleteVertexArrays(GLsizei count, const GLuint* vaos) {
+    glDeleteVertexArrays(count, vaos);
+    for (GLsizei i = 0; i < count; i++) {
+        if (vaos[i] != 0 && s_state.vao == vaos[i]) {
+            s_state.vao = 0;
+            s_state.buffers[ElementArrayBufferSlot] = kUnknown;
+        }
+    }
+}
+
+void GLStateCache::invalidate() {
+    s_state = State();
+}
+
+void GLStateCache::endFrame() {
+    s_lastFrame = s_currentFrame;
+    s_currentFrame = GLStateStats();
+}
+
+const GLStateStats& GLStateCache::currentFrame() {
+    return s_currentFrame;
+}
+
+const GLStateStats& GLStateCache::lastFrame() {
+    return s_lastFrame;
+}
@@ -0,0 +1,80 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_GLSTATECACHE_H
+#define RENDERER_GLSTATECACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+
+// 每帧的 GL 状态调用统计，issued 是真正发给驱动的调用，filtered 是和当前状态相同被跳过的调用
+struct GLStateStats {
+    enum Category {
+        Program,
+        VertexArray,
+        Buffer,
+        Texture,
+        Sampler,
+        Capability,
+        Viewport,
+        CategoryCount,
+    };
+
+    uint32_t issued[CategoryCount] = {};
+    uint32_t filtered[CategoryCount] = {};
+
+    uint32_t totalIssued() const;
+    uint32_t totalFiltered() const;
+    static const char* categoryName(Category category);
+};
+
+// 记录当前 context 的绑定和固定管线状态，和记录值相同的调用直接跳过。
+// 只在持有 GL context 的线程上使用；绕过它直接调用 glBind* / glUseProgram 会让记录失效，
+// 这种情况(例如第三方库改了状态)之后要调用 invalidate()。
+// 删除纹理、缓冲、VAO 要走这里的 delete*，否则名字被重新分配后可能误判为已经绑定。
+// 初始状态都是"未知"，每种状态的第一次调用一定会发出。
+class GLStateCache {
+public:
+    static constexpr GLuint kMaxTextureUnits = 32;
+    static constexpr GLuint kMaxBufferBindings = 16;
+
+    static void useProgram(GLuint program);
+    static void bindVertexArray(GLuint vao);
+
+    // 支持 GL_ARRAY_BUFFER / GL_ELEMENT_ARRAY_BUFFER / GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER /
+    // GL_DRAW_INDIRECT_BUFFER，其他 target 不做缓存直接调用
+    static void bindBuffer(GLenum target, GLuint buffer);
+    // GL_UNIFORM_BUFFER / GL_SHADER_STORAGE_BUFFER 的 indexed binding，同时会改变 target 的通用绑定
+    static void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    static void bindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+
+    // 绑定到指定纹理单元，需要时先切换 glActiveTexture
+    static void bindTexture(GLuint unit, GLenum target, GLuint texture);
+    // 绑定到当前激活的纹理单元，用于创建/上传纹理
+    static void bindTexture(GLenum target, GLuint texture);
+    static void bindSampler(GLuint unit, GLuint sampler);
+
+    // GL_BLEND / GL_DEPTH_TEST / GL_CULL_FACE / GL_SCISSOR_TEST 会被缓存，其他直接调用
+    static void setEnabled(GLenum capability, bool enabled);
+    static void blendFunc(GLenum source, GLenum destination);
+    static void depthFunc(GLenum func);
+    static void depthMask(bool write);
+    static void viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    // 删除对象并清掉引用它的记录(GL 会把被删除的对象从当前绑定上解除)
+    static void deleteTextures(GLsizei count, const GLuint* textures);
+    static void deleteBuffers(GLsizei count, const GLuint* buffers);
+    static void deleteVertexArrays(GLsizei count, const GLuint* vaos);
+
+    // 把所有记录标记为未知，之后每种状态的第一次调用都会发出
+    static void invalidate();
+
+    // 一帧结束时调用：保存这一帧的统计并清零
+    static void endFrame();
+    static const GLStateStats& currentFrame();
+    static const GLStateStats& lastFrame();
+};
+
+
+#endif //RENDERER_GLSTATECACHE_H
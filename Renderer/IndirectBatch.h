@@ -0,0 +1,152 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_INDIRECTBATCH_H
+#define RENDERER_INDIRECTBATCH_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "Renderer/GLStateCache.h"
+#include "Renderer/MeshPool.h"
+#include "Renderer/StreamBuffer.h"
+
+// glMultiDrawElementsIndirect 读取的命令格式，布局由 GL 规定
+struct DrawElementsIndirectCommand {
+    uint32_t count;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t baseInstance;
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20, "DrawElementsIndirectCommand must be tightly packed");
+
+// 每个 draw 自己的数据放在 SSBO 的这个 binding，shader 里用 gl_DrawIDARB 取
+constexpr GLuint DRAW_DATA_BINDING = 0;
+
+// 把同一个 MeshPool 里的任意多个 mesh 合成一次 glMultiDrawElementsIndirect。
+// 每帧 clear + add，draw 时把命令缓冲和 PerDraw 数组(std430 布局的 SSBO)写进 StreamBuffer，
+// 驱动调用次数和 draw 数量无关。每次 draw 占用 StreamBuffer 的一个区域。
+// 需要 GL 4.3 (或 ARB_multi_draw_indirect + ARB_shader_storage_buffer_object) 以及 ARB_shader_draw_parameters；
+// 不支持时(例如 macOS 的 4.1)退回逐个 glDrawElementsBaseVertex，PerDraw 由调用方用 uniform 设置。
+template<typename PerDraw>
+class IndirectBatch {
+public:
+    IndirectBatch() = default;
+    IndirectBatch(const IndirectBatch&) = delete;
+    IndirectBatch& operator=(const IndirectBatch&) = delete;
+
+    static bool supported()
+    {
+        static const bool s_supported = [] {
+            bool multiDraw = false;
+            bool drawParameters = false;
+#ifdef GL_VERSION_4_3
+            multiDraw = multiDraw || GLAD_GL_VERSION_4_3;
+#endif
+#if defined(GL_ARB_multi_draw_indirect) && defined(GL_ARB_shader_storage_buffer_object)
+            multiDraw = multiDraw || (GLAD_GL_ARB_multi_draw_indirect && GLAD_GL_ARB_shader_storage_buffer_object);
+#endif
+#ifdef GL_ARB_shader_draw_parameters
+            drawParameters = GLAD_GL_ARB_shader_draw_parameters;
+#endif
+            return multiDraw && drawParameters;
+        }();
+        return s_supported;
+    }
+
+    void clear()
+    {
+        m_commands.clear();
+        m_drawData.clear();
+    }
+
+    void add(const MeshRange& mesh, const PerDraw& data)
+    {
+        // baseInstance 也写成 draw 序号，方便不支持 gl_DrawID 的驱动改用实例属性
+        m_commands.push_back({mesh.indexCount, 1, mesh.firstIndex, mesh.baseVertex, (uint32_t)m_commands.size()});
+        m_drawData.push_back(data);
+    }
+
+    size_t size() const { return m_commands.size(); }
+
+    // fallbackPerDraw 只在退回逐个绘制时调用，用来把 PerDraw 设置成 uniform
+    void draw(const MeshPool& pool, const std::function<void(const PerDraw&)>& fallbackPerDraw = {})
+    {
+        if (m_commands.empty()) {
+            return;
+        }
+        pool.bind();
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_multi_draw_indirect)
+        if (supported()) {
+            // 命令和 PerDraw 写进映射好的环形缓冲，不再每帧 glBufferData 重新分配存储
+            GLsizeiptr commandBytes = (GLsizeiptr)(m_commands.size() * sizeof(DrawElementsIndirectCommand));
+            GLsizeiptr drawDataBytes = (GLsizeiptr)(m_drawData.size() * sizeof(PerDraw));
+            GLsizeiptr alignment = StreamBuffer::rangeAlignment();
+            GLsizeiptr frameBytes = commandBytes + drawDataBytes + alignment;
+            if (!m_stream || m_stream->frameSize() < frameBytes) {
+                // 容量不够时按两倍重建，旧缓冲由驱动在 GPU 用完后回收
+                if (m_stream) {
+                    m_stream->destroy();
+                }
+                m_stream = std::make_unique<StreamBuffer>(frameBytes * 2);
+            }
+            m_stream->beginFrame();
+            StreamAllocation commands = m_stream->allocate(commandBytes, 4);
+            if (commands.valid()) {
+                memcpy(commands.data, m_commands.data(), commandBytes);
+                m_stream->commit(commands);
+            }
+            StreamAllocation drawData = m_stream->allocate(drawDataBytes, alignment);
+            if (drawData.valid()) {
+                memcpy(drawData.data, m_drawData.data(), drawDataBytes);
+                m_stream->commit(drawData);
+            }
+            if (!commands.valid() || !drawData.valid()) {
+                // 映射失败，这一帧不画
+                m_stream->endFrame();
+                return;
+            }
+
+            GLStateCache::bindBuffer(GL_DRAW_INDIRECT_BUFFER, m_stream->id());
+            GLStateCache::bindBufferRange(GL_SHADER_STORAGE_BUFFER, DRAW_DATA_BINDING, m_stream->id(),
+                                          drawData.offset, drawDataBytes);
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (void*)commands.offset,
+                                        (GLsizei)m_commands.size(), 0);
+            m_stream->endFrame();
+            return;
+        }
+#endif
+        for (size_t i = 0; i < m_commands.size(); i++) {
+            const DrawElementsIndirectCommand& command = m_commands[i];
+            if (fallbackPerDraw) {
+                fallbackPerDraw(m_drawData[i]);
+            }
+            glDrawElementsBaseVertex(GL_TRIANGLES, (GLsizei)command.count, GL_UNSIGNED_INT,
+                                     (void*)(command.firstIndex * sizeof(uint32_t)), command.baseVertex);
+        }
+    }
+
+    // 和其他 GL 资源一样，需要在 context 销毁之前手动释放
+    void destroy()
+    {
+        if (m_stream) {
+            m_stream->destroy();
+            m_stream.reset();
+        }
+    }
+
+    // 当前使用的流式缓冲，还没 draw 过时为 nullptr
+    const StreamBuffer* stream() const { return m_stream.get(); }
+
+private:
+    std::vector<DrawElementsIndirectCommand> m_commands;
+    std::vector<PerDraw> m_drawData;
+    std::unique_ptr<StreamBuffer> m_stream;
+};
+
+#endif //RENDERER_INDIRECTBATCH_H
@@ -0,0 +1,1027 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "MeshLoader.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include "MeshOptimizer.h"
+#include "Utils/Hash.h"
+#include "Utils/Json.h"
+#include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
+#include "Utils/Profiler.h"
+#include "Utils/ThreadPool.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[4] = {'R', 'M', 'S', 'H'};
+    constexpr uint32_t kVersion = 1;
+    constexpr uint32_t kMissing = UINT32_MAX;
+
+    // cooked 文件布局: CookedHeader | MeshVertex[vertexCount] | uint32_t[indexCount]
+    // 两段数据都从 16 字节对齐的位置开始，mmap 之后可以直接交给 glBufferData
+    struct CookedHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+        float positionOffset[3];
+        float positionScale;
+        uint64_t contentHash;
+        uint64_t vertexOffset;
+        uint64_t indexOffset;
+        uint64_t reserved;
+    };
+
+    std::mutex s_directoryMutex;
+    std::string s_directory = "cache/meshes";
+
+    std::string cacheDirectory() {
+        std::lock_guard<std::mutex> lock(s_directoryMutex);
+        return s_directory;
+    }
+
+    fs::path cacheFilePath(const std::string& directory, const std::string& sourcePath) {
+        std::error_code ec;
+        std::string key = fs::absolute(sourcePath, ec).string();
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.meshc", (unsigned long long)fnv1a(key));
+        return fs::path(directory) / name;
+    }
+
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool readCookedHeader(const std::string& path, CookedHeader& header) {
+        std::ifstream in(path, std::ios::binary);
+        return in.read(reinterpret_cast<char*>(&header), sizeof(header)) &&
+               memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kVersion;
+    }
+
+    // 解析后、量化前的网格，顶点属性已经按索引去重
+    struct RawMesh {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec2> uvs;
+        std::vector<uint32_t> indices;
+        bool hasNormals = false;
+    };
+
+    // 解析得到的网格自己持有顶点和索引
+    struct OwnedMesh {
+        std::vector<MeshVertex> vertices;
+        std::vector<uint32_t> indices;
+    };
+
+    // 没有法线时按面积加权累加面法线
+    void computeNormals(RawMesh& raw) {
+        raw.normals.assign(raw.positions.size(), glm::vec3(0.0f));
+        for (size_t i = 0; i + 2 < raw.indices.size(); i += 3) {
+            uint32_t a = raw.indices[i], b = raw.indices[i + 1], c = raw.indices[i + 2];
+            glm::vec3 normal = glm::cross(raw.positions[b] - raw.positions[a], raw.positions[c] - raw.positions[a]);
+            raw.normals[a] = raw.normals[a] + normal;
+            raw.normals[b] = raw.normals[b] + normal;
+            raw.normals[c] = raw.normals[c] + normal;
+        }
+        raw.hasNormals = true;
+    }
+
+    // 量化成 MeshVertex 并做 mesh 优化
+    MeshData finalizeMesh(const std::string& name, RawMesh& raw) {
+        MeshData mesh;
+        if (raw.indices.empty() || raw.positions.empty()) {
+            return mesh;
+        }
+        if (!raw.hasNormals) {
+            computeNormals(raw);
+        }
+        raw.uvs.resize(raw.positions.size(), glm::vec2(0.0f));
+
+        glm::vec3 boundsMin = raw.positions[0], boundsMax = raw.positions[0];
+        for (const glm::vec3& p : raw.positions) {
+            boundsMin = glm::min(boundsMin, p);
+            boundsMax = glm::max(boundsMax, p);
+        }
+        glm::vec3 halfExtent = (boundsMax - boundsMin) * 0.5f;
+        mesh.positionOffset = (boundsMin + boundsMax) * 0.5f;
+        // 三个轴用同一个缩放，量化后的形状不变形
+        mesh.positionScale = std::max(halfExtent.x, std::max(halfExtent.y, halfExtent.z));
+        if (mesh.positionScale <= 0.0f) {
+            mesh.positionScale = 1.0f;
+        }
+
+        auto owned = std::make_shared<OwnedMesh>();
+        owned->vertices.resize(raw.positions.size());
+        const float inverseScale = 1.0f / mesh.positionScale;
+        const glm::vec3 offset = mesh.positionOffset;
+        ThreadPool::shared().parallelFor(raw.positions.size(), 65536, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++) {
+                glm::vec3 normal = raw.normals[i];
+                float length = glm::length(normal);
+                normal = length > 0.0f ? normal * (1.0f / length) : glm::vec3(0.0f, 0.0f, 1.0f);
+                owned->vertices[i].position = Snorm16x4((raw.positions[i] - offset) * inverseScale);
+                owned->vertices[i].normal = PackedNormal(normal);
+                owned->vertices[i].uv = Half2(raw.uvs[i].x, raw.uvs[i].y);
+            }
+        });
+        owned->indices = std::move(raw.indices);
+
+        MeshOptimizer::optimize(name.c_str(), owned->vertices, owned->indices,
+                                [](const MeshVertex& vertex) { return vertex.position.unpack(); });
+
+        mesh.vertices = owned->vertices.data();
+        mesh.vertexCount = (uint32_t)owned->vertices.size();
+        mesh.indices = owned->indices.data();
+        mesh.indexCount = (uint32_t)owned->indices.size();
+        mesh.storage = owned;
+        return mesh;
+    }
+
+    // ---- OBJ ----
+
+    inline bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+    const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) {
+            p++;
+        }
+        return p;
+    }
+
+    // 不依赖 '\0' 结尾的浮点解析(mmap 的文件末尾没有 '\0')，精度对网格数据足够
+    const char* parseFloat(const char* p, const char* end, float& out) {
+        static const double kPow10[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+                                        1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18};
+        p = skipSpaces(p, end);
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            p++;
+        }
+        uint64_t mantissa = 0;
+        int exponent = 0;
+        int digits = 0;
+        const char* start = p;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            if (digits < 18) {
+                mantissa = mantissa * 10 + (*p - '0');
+                digits += mantissa != 0;
+            } else {
+                exponent++;
+            }
+        }
+        if (p < end && *p == '.') {
+            p++;
+            for (; p < end && *p >= '0' && *p <= '9'; p++) {
+                if (digits < 18) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    digits += mantissa != 0;
+                    exponent--;
+                }
+            }
+        }
+        if (p == start || (p == start + 1 && *start == '.')) {
+            return nullptr;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            p++;
+            bool negativeExponent = false;
+            if (p < end && (*p == '-' || *p == '+')) {
+                negativeExponent = *p == '-';
+                p++;
+            }
+            int value = 0;
+            for (; p < end && *p >= '0' && *p <= '9'; p++) {
+                value = std::min(value * 10 + (*p - '0'), 1000);
+            }
+            exponent += negativeExponent ? -value : value;
+        }
+        double result = (double)mantissa;
+        if (exponent != 0) {
+            int magnitude = exponent < 0 ? -exponent : exponent;
+            double scale = magnitude <= 18 ? kPow10[magnitude] : std::pow(10.0, magnitude);
+            result = exponent < 0 ? result / scale : result * scale;
+        }
+        out = (float)(negative ? -result : result);
+        return p;
+    }
+
+    const char* parseInt(const char* p, const char* end, int64_t& out) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            p++;
+        }
+        const char* start = p;
+        int64_t value = 0;
+        for (; p < end && *p >= '0' && *p <= '9'; p++) {
+            value = value * 10 + (*p - '0');
+        }
+        if (p == start) {
+            return nullptr;
+        }
+        out = negative ? -value : value;
+        return p;
+    }
+
+    enum class ObjLine {
+        Other,
+        Position,
+        TexCoord,
+        Normal,
+        Face,
+    };
+
+    // 返回行类型，rest 指向关键字之后
+    ObjLine classifyLine(const char* p, const char* end, const char*& rest) {
+        p = skipSpaces(p, end);
+        if (end - p >= 2 && p[0] == 'v' && isSpace(p[1])) {
+            rest = p + 2;
+            return ObjLine::Position;
+        }
+        if (end - p >= 3 && p[0] == 'v' && p[1] == 't' && isSpace(p[2])) {
+            rest = p + 3;
+            return ObjLine::TexCoord;
+        }
+        if (end - p >= 3 && p[0] == 'v' && p[1] == 'n' && isSpace(p[2])) {
+            rest = p + 3;
+            return ObjLine::Normal;
+        }
+        if (end - p >= 2 && p[0] == 'f' && isSpace(p[1])) {
+            rest = p + 2;
+            return ObjLine::Face;
+        }
+        return ObjLine::Other;
+    }
+
+    const char* lineEnd(const char* p, const char* end) {
+        const void* newline = memchr(p, '\n', (size_t)(end - p));
+        return newline ? static_cast<const char*>(newline) : end;
+    }
+
+    struct ObjChunk {
+        const char* begin;
+        const char* end;
+        // 第一遍统计的数量
+        size_t positions = 0;
+        size_t texCoords = 0;
+        size_t normals = 0;
+        size_t triangles = 0;
+        // 前面所有块的数量之和，第二遍写入全局数组的起点
+        size_t positionBase = 0;
+        size_t texCoordBase = 0;
+        size_t normalBase = 0;
+        size_t triangleBase = 0;
+    };
+
+    void countChunk(ObjChunk& chunk) {
+        for (const char* p = chunk.begin; p < chunk.end;) {
+            const char* next = lineEnd(p, chunk.end);
+            const char* rest;
+            switch (classifyLine(p, next, rest)) {
+                case ObjLine::Position: chunk.positions++; break;
+                case ObjLine::TexCoord: chunk.texCoords++; break;
+                case ObjLine::Normal: chunk.normals++; break;
+                case ObjLine::Face: {
+                    size_t corners = 0;
+                    for (const char* q = skipSpaces(rest, next); q < next; q = skipSpaces(q, next)) {
+                        corners++;
+                        while (q < next && !isSpace(*q)) {
+                            q++;
+                        }
+                    }
+                    chunk.triangles += corners >= 3 ? corners - 2 : 0;
+                    break;
+                }
+                default: break;
+            }
+            p = next + 1;
+        }
+    }
+
+    struct ObjArrays {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec2> texCoords;
+        std::vector<glm::vec3> normals;
+        // 每个三角形角一组 (position, texCoord, normal) 下标，缺失为 kMissing
+        std::vector<uint32_t> corners;
+    };
+
+    // OBJ 下标从 1 开始，负数表示相对当前已出现的数量
+    uint32_t resolveIndex(int64_t index, size_t countSoFar, size_t total) {
+        int64_t resolved = index > 0 ? index - 1 : (int64_t)countSoFar + index;
+        return resolved >= 0 && resolved < (int64_t)total ? (uint32_t)resolved : kMissing - 1;
+    }
+
+    // 出错时返回出错的行首
+    const char* parseChunk(const ObjChunk& chunk, ObjArrays& arrays) {
+        size_t positionIndex = chunk.positionBase;
+        size_t texCoordIndex = chunk.texCoordBase;
+        size_t normalIndex = chunk.normalBase;
+        uint32_t* corner = arrays.corners.data() + chunk.triangleBase * 9;
+        const size_t positionTotal = arrays.positions.size();
+        const size_t texCoordTotal = arrays.texCoords.size();
+        const size_t normalTotal = arrays.normals.size();
+
+        for (const char* p = chunk.begin; p < chunk.end;) {
+            const char* next = lineEnd(p, chunk.end);
+            const char* rest;
+            switch (classifyLine(p, next, rest)) {
+                case ObjLine::Position: {
+                    glm::vec3& v = arrays.positions[positionIndex++];
+                    if (!(rest = parseFloat(rest, next, v.x)) || !(rest = parseFloat(rest, next, v.y)) ||
+                        !parseFloat(rest, next, v.z)) {
+                        return p;
+                    }
+                    break;
+                }
+                case ObjLine::TexCoord: {
+                    glm::vec2& t = arrays.texCoords[texCoordIndex++];
+                    if (!(rest = parseFloat(rest, next, t.x))) {
+                        return p;
+                    }
+                    // v 分量可以省略
+                    if (!parseFloat(rest, next, t.y)) {
+                        t.y = 0.0f;
+                    }
+                    break;
+                }
+                case ObjLine::Normal: {
+                    glm::vec3& n = arrays.normals[normalIndex++];
+                    if (!(rest = parseFloat(rest, next, n.x)) || !(rest = parseFloat(rest, next, n.y)) ||
+                        !parseFloat(rest, next, n.z)) {
+                        return p;
+                    }
+                    break;
+                }
+                case ObjLine::Face: {
+                    // 多边形按扇形三角化：(0, i - 1, i)
+                    uint32_t first[3], previous[3];
+                    int cornerCount = 0;
+                    for (const char* q = skipSpaces(rest, next); q < next; q = skipSpaces(q, next)) {
+                        uint32_t current[3] = {kMissing, kMissing, kMissing};
+                        int64_t value;
+                        if (!(q = parseInt(q, next, value))) {
+                            return p;
+                        }
+                        current[0] = resolveIndex(value, positionIndex, positionTotal);
+                        if (q < next && *q == '/') {
+                            q++;
+                            if (q < next && *q != '/') {
+                                if (!(q = parseInt(q, next, value))) {
+                                    return p;
+                                }
+                                current[1] = resolveIndex(value, texCoordIndex, texCoordTotal);
+                            }
+                            if (q < next && *q == '/') {
+                                if (!(q = parseInt(q + 1, next, value))) {
+                                    return p;
+                                }
+                                current[2] = resolveIndex(value, normalIndex, normalTotal);
+                            }
+                        }
+                        if (current[0] == kMissing - 1 || current[1] == kMissing - 1 || current[2] == kMissing - 1) {
+                            return p;
+                        }
+                        if (cornerCount == 0) {
+                            memcpy(first, current, sizeof(first));
+                        } else if (cornerCount >= 2) {
+                            memcpy(corner, first, sizeof(first));
+                            memcpy(corner + 3, previous, sizeof(previous));
+                            memcpy(corner + 6, current, sizeof(current));
+                            corner += 9;
+                        }
+                        memcpy(previous, current, sizeof(previous));
+                        cornerCount++;
+                    }
+                    break;
+                }
+                default: break;
+            }
+            p = next + 1;
+        }
+        return nullptr;
+    }
+
+    // ---- glTF ----
+
+    constexpr uint32_t kGlbMagic = 0x46546C67;      // "glTF"
+    constexpr uint32_t kGlbChunkJson = 0x4E4F534A;  // "JSON"
+    constexpr uint32_t kGlbChunkBin = 0x004E4942;   // "BIN\0"
+
+    enum GltfComponentType {
+        GltfByte = 5120,
+        GltfUnsignedByte = 5121,
+        GltfShort = 5122,
+        GltfUnsignedShort = 5123,
+        GltfUnsignedInt = 5125,
+        GltfFloat = 5126,
+    };
+
+    bool decodeBase64(std::string_view text, std::vector<uint8_t>& out) {
+        auto value = [](char c) -> int {
+            if (c >= 'A' && c <= 'Z') return c - 'A';
+            if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+            if (c >= '0' && c <= '9') return c - '0' + 52;
+            if (c == '+') return 62;
+            if (c == '/') return 63;
+            return -1;
+        };
+        uint32_t bits = 0;
+        int bitCount = 0;
+        for (char c : text) {
+            if (c == '=') {
+                break;
+            }
+            int v = value(c);
+            if (v < 0) {
+                return false;
+            }
+            bits = (bits << 6) | (uint32_t)v;
+            bitCount += 6;
+            if (bitCount >= 8) {
+                bitCount -= 8;
+                out.push_back((uint8_t)(bits >> bitCount));
+            }
+        }
+        return true;
+    }
+
+    // 一个 accessor 解析后的视图，只读
+    struct GltfAccessor {
+        const uint8_t* data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        int componentType = 0;
+        int components = 0;
+        bool normalized = false;
+
+        bool valid() const { return data != nullptr; }
+
+        float component(size_t index, int c) const {
+            const uint8_t* element = data + index * stride;
+            switch (componentType) {
+                case GltfFloat: { float v; memcpy(&v, element + c * 4, 4); return v; }
+                case GltfUnsignedByte: { uint8_t v = element[c]; return normalized ? v / 255.0f : v; }
+                case GltfByte: { int8_t v = (int8_t)element[c]; return normalized ? std::max(v / 127.0f, -1.0f) : v; }
+                case GltfUnsignedShort: { uint16_t v; memcpy(&v, element + c * 2, 2); return normalized ? v / 65535.0f : v; }
+                case GltfShort: { int16_t v; memcpy(&v, element + c * 2, 2); return normalized ? std::max(v / 32767.0f, -1.0f) : v; }
+                case GltfUnsignedInt: { uint32_t v; memcpy(&v, element + c * 4, 4); return (float)v; }
+                default: return 0.0f;
+            }
+        }
+
+        uint32_t index(size_t i) const {
+            const uint8_t* element = data + i * stride;
+            switch (componentType) {
+                case GltfUnsignedByte: return element[0];
+                case GltfUnsignedShort: { uint16_t v; memcpy(&v, element, 2); return v; }
+                case GltfUnsignedInt: { uint32_t v; memcpy(&v, element, 4); return v; }
+                default: return 0;
+            }
+        }
+    };
+
+    struct GltfDocument {
+        JsonValue json;
+        std::vector<std::pair<const uint8_t*, size_t>> buffers;
+        // 外部 .bin / data URI 的内存
+        std::vector<std::shared_ptr<MappedFile>> mappedBuffers;
+        std::vector<std::vector<uint8_t>> decodedBuffers;
+
+        GltfAccessor accessor(const JsonValue& index) const {
+            GltfAccessor result;
+            if (!index.isNumber()) {
+                return result;
+            }
+            const JsonValue& accessor = json["accessors"][(size_t)index.number()];
+            const JsonValue& view = json["bufferViews"][(size_t)accessor["bufferView"].number(-1)];
+            if (accessor.has("sparse")) {
+                LOG_WARN("glTF sparse accessors are not supported");
+                return result;
+            }
+            size_t buffer = (size_t)view["buffer"].number(-1);
+            if (!view.isObject() || buffer >= buffers.size()) {
+                return result;
+            }
+            static const std::pair<const char*, int> kTypes[] = {
+                {"SCALAR", 1}, {"VEC2", 2}, {"VEC3", 3}, {"VEC4", 4}, {"MAT4", 16},
+            };
+            for (const auto& type : kTypes) {
+                if (accessor["type"].string() == type.first) {
+                    result.components = type.second;
+                }
+            }
+            result.componentType = (int)accessor["componentType"].number();
+            result.normalized = accessor["normalized"].boolean();
+            result.count = (size_t)accessor["count"].number();
+            size_t componentSize = result.componentType == GltfFloat || result.componentType == GltfUnsignedInt ? 4
+                                 : result.componentType == GltfShort || result.componentType == GltfUnsignedShort ? 2 : 1;
+            size_t elementSize = componentSize * result.components;
+            result.stride = (size_t)view["byteStride"].number((double)elementSize);
+            size_t offset = (size_t)view["byteOffset"].number() + (size_t)accessor["byteOffset"].number();
+            // 越界的 accessor 当作无效
+            if (result.components == 0 || result.count == 0 ||
+                offset + (result.count - 1) * result.stride + elementSize > buffers[buffer].second) {
+                return result;
+            }
+            result.data = buffers[buffer].first + offset;
+            return result;
+        }
+    };
+
+    glm::mat4 nodeMatrix(const JsonValue& node) {
+        const JsonValue& matrix = node["matrix"];
+        if (matrix.size() == 16) {
+            glm::mat4 result;
+            for (int i = 0; i < 16; i++) {
+                result[i / 4][i % 4] = (float)matrix[i].number();
+            }
+            return result;
+        }
+        const JsonValue& t = node["translation"];
+        const JsonValue& r = node["rotation"];
+        const JsonValue& s = node["scale"];
+        glm::mat4 result = glm::translate(glm::mat4(1.0f),
+                                          glm::vec3(t[0].number(), t[1].number(), t[2].number()));
+        // glTF 四元数顺序是 x, y, z, w
+        result = result * glm::mat4_cast(glm::quat((float)r[3].number(1.0), (float)r[0].number(),
+                                                   (float)r[1].number(), (float)r[2].number()));
+        return glm::scale(result, glm::vec3(s[0].number(1.0), s[1].number(1.0), s[2].number(1.0)));
+    }
+
+    struct GltfPrimitiveInstance {
+        const JsonValue* primitive;
+        glm::mat4 world;
+        size_t vertexBase = 0;
+        size_t indexBase = 0;
+        GltfAccessor positions, normals, uvs, indices;
+    };
+
+    void collectNodes(const GltfDocument& document, size_t nodeIndex, const glm::mat4& parent, int depth,
+                      std::vector<GltfPrimitiveInstance>& out) {
+        const JsonValue& node = document.json["nodes"][nodeIndex];
+        if (!node.isObject() || depth > 64) {
+            return;
+        }
+        glm::mat4 world = parent * nodeMatrix(node);
+        if (node["mesh"].isNumber()) {
+            const JsonValue& primitives = document.json["meshes"][(size_t)node["mesh"].number()]["primitives"];
+            for (size_t i = 0; i < primitives.size(); i++) {
+                out.push_back({&primitives[i], world});
+            }
+        }
+        const JsonValue& children = node["children"];
+        for (size_t i = 0; i < children.size(); i++) {
+            collectNodes(document, (size_t)children[i].number(), world, depth + 1, out);
+        }
+    }
+}
+
+glm::mat4 MeshData::dequantizeMatrix() const {
+    return glm::scale(glm::translate(glm::mat4(1.0f), positionOffset), glm::vec3(positionScale));
+}
+
+void MeshLoader::setCacheDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(s_directoryMutex);
+    s_directory = directory;
+}
+
+MeshData MeshLoader::load(const std::string& path) {
+    PROFILE_SCOPE("MeshLoader::load");
+    auto start = std::chrono::steady_clock::now();
+    std::string extension = fs::path(path).extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), [](unsigned char c) { return (char)tolower(c); });
+    if (extension == ".meshc") {
+        return loadCooked(path);
+    }
+
+    // 先查 cooked 缓存，源文件比缓存新时比较内容哈希
+    std::string directory = cacheDirectory();
+    fs::path cachePath;
+    if (!directory.empty()) {
+        cachePath = cacheFilePath(directory, path);
+        std::error_code ec;
+        auto cacheTime = fs::last_write_time(cachePath, ec);
+        if (!ec) {
+            MeshData cached = loadCooked(cachePath.string());
+            auto sourceTime = fs::last_write_time(path, ec);
+            if (cached.valid() && !ec && sourceTime > cacheTime) {
+                // 只是被 touch 过或者重新拷贝过的源文件，内容没变就继续用缓存
+                CookedHeader header;
+                MappedFile source;
+                if (!readCookedHeader(cachePath.string(), header) || !source.open(path) ||
+                    fnv1aBytes(source.data(), source.size()) != header.contentHash) {
+                    cached = MeshData();
+                } else {
+                    fs::last_write_time(cachePath, fs::file_time_type::clock::now(), ec);
+                }
+            }
+            if (cached.valid()) {
+                LOG_INFO("MeshLoader: {} loaded from cooked cache in {:.1f} ms, {} triangles",
+                         path, elapsedMs(start), cached.indexCount / 3);
+                return cached;
+            }
+        }
+    }
+
+    MeshData mesh;
+    if (extension == ".obj") {
+        mesh = loadObj(path);
+    } else if (extension == ".gltf" || extension == ".glb") {
+        mesh = loadGltf(path);
+    } else {
+        LOG_ERROR("MeshLoader: unsupported mesh format {}", path);
+        return mesh;
+    }
+    if (!mesh.valid()) {
+        return mesh;
+    }
+    LOG_INFO("MeshLoader: {} parsed in {:.1f} ms, {} vertices, {} triangles",
+             path, elapsedMs(start), mesh.vertexCount, mesh.indexCount / 3);
+
+    if (!cachePath.empty()) {
+        std::error_code ec;
+        fs::create_directories(directory, ec);
+        MappedFile source;
+        uint64_t contentHash = source.open(path) ? fnv1aBytes(source.data(), source.size()) : 0;
+        writeCooked(cachePath.string(), mesh, contentHash);
+    }
+    return mesh;
+}
+
+MeshData MeshLoader::loadObj(const std::string& path) {
+    PROFILE_SCOPE("MeshLoader::loadObj");
+    MappedFile file;
+    if (!file.open(path)) {
+        LOG_ERROR("MeshLoader: failed to open {}", path);
+        return MeshData();
+    }
+    const char* data = reinterpret_cast<const char*>(file.data());
+    const char* end = data + file.size();
+
+    // 1. 按行边界切块，每块大约 1MB
+    ThreadPool& pool = ThreadPool::shared();
+    size_t chunkCount = std::max<size_t>(1, std::min(file.size() / (1 << 20), (pool.threadCount() + 1) * 4));
+    std::vector<ObjChunk> chunks;
+    const char* chunkBegin = data;
+    for (size_t i = 1; i <= chunkCount && chunkBegin < end; i++) {
+        const char* chunkEnd = i == chunkCount ? end : data + file.size() * i / chunkCount;
+        if (chunkEnd < chunkBegin) {
+            chunkEnd = chunkBegin;
+        }
+        chunkEnd = std::min(end, lineEnd(chunkEnd, end) + 1);
+        chunks.push_back({chunkBegin, chunkEnd});
+        chunkBegin = chunkEnd;
+    }
+
+    // 2. 并行统计每块的数量，前缀和得到每块写入的位置
+    pool.parallelFor(chunks.size(), 1, [&](size_t begin, size_t finish) {
+        for (size_t i = begin; i < finish; i++) {
+            countChunk(chunks[i]);
+        }
+    });
+    ObjArrays arrays;
+    size_t positions = 0, texCoords = 0, normals = 0, triangles = 0;
+    for (ObjChunk& chunk : chunks) {
+        chunk.positionBase = positions;
+        chunk.texCoordBase = texCoords;
+        chunk.normalBase = normals;
+        chunk.triangleBase = triangles;
+        positions += chunk.positions;
+        texCoords += chunk.texCoords;
+        normals += chunk.normals;
+        triangles += chunk.triangles;
+    }
+    if (triangles == 0) {
+        LOG_ERROR("MeshLoader: no faces in {}", path);
+        return MeshData();
+    }
+    arrays.positions.resize(positions);
+    arrays.texCoords.resize(texCoords);
+    arrays.normals.resize(normals);
+    arrays.corners.resize(triangles * 9);
+
+    // 3. 并行解析到各自的区间
+    std::atomic<const char*> errorLine{nullptr};
+    pool.parallelFor(chunks.size(), 1, [&](size_t begin, size_t finish) {
+        for (size_t i = begin; i < finish; i++) {
+            if (const char* error = parseChunk(chunks[i], arrays)) {
+                errorLine = error;
+            }
+        }
+    });
+    if (const char* error = errorLine.load()) {
+        size_t line = 1 + std::count(data, error, '\n');
+        LOG_ERROR("MeshLoader: malformed or out of range data in {} line {}", path, line);
+        return MeshData();
+    }
+
+    // 4. (position, texCoord, normal) 组合去重，remap 就是索引
+    size_t cornerCount = triangles * 3;
+    RawMesh raw;
+    raw.indices.resize(cornerCount);
+    size_t vertexCount = MeshOptimizer::generateVertexRemap(raw.indices.data(), arrays.corners.data(), cornerCount,
+                                                            3 * sizeof(uint32_t));
+    raw.positions.resize(vertexCount);
+    raw.uvs.resize(vertexCount, glm::vec2(0.0f));
+    raw.normals.resize(vertexCount, glm::vec3(0.0f));
+    raw.hasNormals = normals > 0;
+    // 多个 corner 会映射到同一个顶点，按 corner 并行写会有数据竞争；
+    // 顶点编号按第一次出现的顺序分配，先串行记下每个顶点第一次出现的 corner，再按顶点并行取数据
+    std::vector<uint32_t> firstCorner(vertexCount);
+    for (size_t i = 0, next = 0; i < cornerCount; i++) {
+        if (raw.indices[i] == next) {
+            firstCorner[next++] = (uint32_t)i;
+        }
+    }
+    pool.parallelFor(vertexCount, 65536, [&](size_t begin, size_t finish) {
+        for (size_t vertex = begin; vertex < finish; vertex++) {
+            const uint32_t* corner = arrays.corners.data() + (size_t)firstCorner[vertex] * 3;
+            raw.positions[vertex] = arrays.positions[corner[0]];
+            if (corner[1] != kMissing) {
+                raw.uvs[vertex] = arrays.texCoords[corner[1]];
+            }
+            if (corner[2] != kMissing) {
+                raw.normals[vertex] = arrays.normals[corner[2]];
+            }
+        }
+    });
+    return finalizeMesh(path, raw);
+}
+
+MeshData MeshLoader::loadGltf(const std::string& path) {
+    PROFILE_SCOPE("MeshLoader::loadGltf");
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        LOG_ERROR("MeshLoader: failed to open {}", path);
+        return MeshData();
+    }
+
+    // 1. .glb 是 12 字节文件头 + JSON chunk + 可选的 BIN chunk
+    GltfDocument document;
+    std::string_view jsonText(reinterpret_cast<const char*>(file->data()), file->size());
+    std::pair<const uint8_t*, size_t> binChunk{nullptr, 0};
+    uint32_t magic = 0;
+    if (file->size() >= 4) {
+        memcpy(&magic, file->data(), 4);
+    }
+    if (magic == kGlbMagic) {
+        jsonText = std::string_view();
+        size_t offset = 12;
+        while (offset + 8 <= file->size()) {
+            uint32_t chunkLength, chunkType;
+            memcpy(&chunkLength, file->data() + offset, 4);
+            memcpy(&chunkType, file->data() + offset + 4, 4);
+            if (offset + 8 + chunkLength > file->size()) {
+                break;
+            }
+            if (chunkType == kGlbChunkJson) {
+                jsonText = std::string_view(reinterpret_cast<const char*>(file->data() + offset + 8), chunkLength);
+            } else if (chunkType == kGlbChunkBin && !binChunk.first) {
+                binChunk = {file->data() + offset + 8, chunkLength};
+            }
+            offset += 8 + ((chunkLength + 3) & ~3u);
+        }
+    }
+    std::string error;
+    if (!JsonValue::parse(jsonText, document.json, &error)) {
+        LOG_ERROR("MeshLoader: invalid glTF JSON in {}: {}", path, error);
+        return MeshData();
+    }
+
+    // 2. buffer: glb 内嵌、data URI 或者相对路径的外部文件
+    const JsonValue& buffers = document.json["buffers"];
+    fs::path directory = fs::path(path).parent_path();
+    for (size_t i = 0; i < buffers.size(); i++) {
+        const JsonValue& uri = buffers[i]["uri"];
+        std::pair<const uint8_t*, size_t> buffer{nullptr, 0};
+        if (!uri.isString()) {
+            buffer = binChunk;
+        } else if (uri.string().rfind("data:", 0) == 0) {
+            size_t comma = uri.string().find(',');
+            document.decodedBuffers.emplace_back();
+            if (comma != std::string::npos &&
+                decodeBase64(std::string_view(uri.string()).substr(comma + 1), document.decodedBuffers.back())) {
+                buffer = {document.decodedBuffers.back().data(), document.decodedBuffers.back().size()};
+            }
+        } else {
+            auto external = std::make_shared<MappedFile>();
+            if (external->open((directory / uri.string()).string())) {
+                buffer = {external->data(), external->size()};
+                document.mappedBuffers.push_back(external);
+            }
+        }
+        if (!buffer.first) {
+            LOG_ERROR("MeshLoader: failed to load buffer {} of {}", i, path);
+            return MeshData();
+        }
+        document.buffers.push_back(buffer);
+    }
+
+    // 3. 从场景根节点遍历，收集每个 primitive 和它的世界矩阵；没有场景时按单位矩阵取所有 mesh
+    std::vector<GltfPrimitiveInstance> instances;
+    const JsonValue& scenes = document.json["scenes"];
+    if (scenes.size() > 0) {
+        const JsonValue& roots = scenes[(size_t)document.json["scene"].number(0)]["nodes"];
+        for (size_t i = 0; i < roots.size(); i++) {
+            collectNodes(document, (size_t)roots[i].number(), glm::mat4(1.0f), 0, instances);
+        }
+    } else {
+        const JsonValue& meshes = document.json["meshes"];
+        for (size_t m = 0; m < meshes.size(); m++) {
+            const JsonValue& primitives = meshes[m]["primitives"];
+            for (size_t i = 0; i < primitives.size(); i++) {
+                instances.push_back({&primitives[i], glm::mat4(1.0f)});
+            }
+        }
+    }
+
+    size_t vertexCount = 0, indexCount = 0;
+    std::vector<GltfPrimitiveInstance> valid;
+    for (GltfPrimitiveInstance& instance : instances) {
+        const JsonValue& primitive = *instance.primitive;
+        // 只处理三角形列表
+        if (primitive["mode"].number(4) != 4) {
+            LOG_WARN("MeshLoader: skip non-triangle primitive in {}", path);
+            continue;
+        }
+        const JsonValue& attributes = primitive["attributes"];
+        instance.positions = document.accessor(attributes["POSITION"]);
+        instance.normals = document.accessor(attributes["NORMAL"]);
+        instance.uvs = document.accessor(attributes["TEXCOORD_0"]);
+        instance.indices = document.accessor(primitive["indices"]);
+        if (!instance.positions.valid() || instance.positions.componentType != GltfFloat ||
+            instance.positions.components != 3) {
+            LOG_WARN("MeshLoader: skip primitive without float3 POSITION in {}", path);
+            continue;
+        }
+        instance.vertexBase = vertexCount;
+        instance.indexBase = indexCount;
+        vertexCount += instance.positions.count;
+        indexCount += instance.indices.valid() ? instance.indices.count : instance.positions.count;
+        valid.push_back(instance);
+    }
+    if (valid.empty()) {
+        LOG_ERROR("MeshLoader: no triangle geometry in {}", path);
+        return MeshData();
+    }
+
+    // 4. 每个 primitive 切成固定大小的任务并行读取，所有 primitive 合并成一个 mesh
+    RawMesh raw;
+    raw.positions.resize(vertexCount);
+    raw.normals.resize(vertexCount, glm::vec3(0.0f));
+    raw.uvs.resize(vertexCount, glm::vec2(0.0f));
+    raw.indices.resize(indexCount);
+    raw.hasNormals = std::all_of(valid.begin(), valid.end(),
+                                 [](const GltfPrimitiveInstance& instance) { return instance.normals.valid(); });
+    struct Task {
+        size_t instance;
+        bool indices;
+        size_t begin;
+        size_t end;
+    };
+    constexpr size_t kTaskSize = 65536;
+    std::vector<Task> tasks;
+    for (size_t i = 0; i < valid.size(); i++) {
+        size_t vertices = valid[i].positions.count;
+        size_t indices = valid[i].indices.valid() ? valid[i].indices.count : vertices;
+        for (size_t begin = 0; begin < vertices; begin += kTaskSize) {
+            tasks.push_back({i, false, begin, std::min(vertices, begin + kTaskSize)});
+        }
+        for (size_t begin = 0; begin < indices; begin += kTaskSize) {
+            tasks.push_back({i, true, begin, std::min(indices, begin + kTaskSize)});
+        }
+    }
+    std::atomic<bool> outOfRange{false};
+    ThreadPool::shared().parallelFor(tasks.size(), 1, [&](size_t begin, size_t finish) {
+        for (size_t t = begin; t < finish; t++) {
+            const Task& task = tasks[t];
+            const GltfPrimitiveInstance& instance = valid[task.instance];
+            if (task.indices) {
+                for (size_t i = task.begin; i < task.end; i++) {
+                    uint32_t index = instance.indices.valid() ? instance.indices.index(i) : (uint32_t)i;
+                    if (index >= instance.positions.count) {
+                        outOfRange = true;
+                        index = 0;
+                    }
+                    raw.indices[instance.indexBase + i] = (uint32_t)instance.vertexBase + index;
+                }
+                continue;
+            }
+            glm::mat4 normalMatrix = glm::transpose(glm::inverse(instance.world));
+            for (size_t i = task.begin; i < task.end; i++) {
+                const GltfAccessor& p = instance.positions;
+                glm::vec4 position = instance.world * glm::vec4(p.component(i, 0), p.component(i, 1), p.component(i, 2), 1.0f);
+                raw.positions[instance.vertexBase + i] = glm::vec3(position);
+                if (instance.normals.valid()) {
+                    const GltfAccessor& n = instance.normals;
+                    glm::vec4 normal = normalMatrix * glm::vec4(n.component(i, 0), n.component(i, 1), n.component(i, 2), 0.0f);
+                    raw.normals[instance.vertexBase + i] = glm::vec3(normal);
+                }
+                if (instance.uvs.valid()) {
+                    raw.uvs[instance.vertexBase + i] = glm::vec2(instance.uvs.component(i, 0), instance.uvs.component(i, 1));
+                }
+            }
+        }
+    });
+    if (outOfRange) {
+        LOG_WARN("MeshLoader: out of range indices in {} were clamped", path);
+    }
+    // glTF 的 UV 原点在左上角，翻转成 OpenGL 的左下角
+    for (glm::vec2& uv : raw.uvs) {
+        uv.y = 1.0f - uv.y;
+    }
+    return finalizeMesh(path, raw);
+}
+
+MeshData MeshLoader::loadCooked(const std::string& path) {
+    PROFILE_SCOPE("MeshLoader::loadCooked");
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path) || file->size() < sizeof(CookedHeader)) {
+        return MeshData();
+    }
+    const auto* header = reinterpret_cast<const CookedHeader*>(file->data());
+    if (memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) {
+        LOG_WARN("MeshLoader: {} is not a cooked mesh or has an old version", path);
+        return MeshData();
+    }
+    if (header->vertexOffset < sizeof(CookedHeader) ||
+        header->vertexOffset + (uint64_t)header->vertexCount * sizeof(MeshVertex) > header->indexOffset ||
+        header->indexOffset + (uint64_t)header->indexCount * sizeof(uint32_t) > file->size()) {
+        LOG_WARN("MeshLoader: cooked mesh {} is truncated", path);
+        return MeshData();
+    }
+    MeshData mesh;
+    mesh.vertices = reinterpret_cast<const MeshVertex*>(file->data() + header->vertexOffset);
+    mesh.indices = reinterpret_cast<const uint32_t*>(file->data() + header->indexOffset);
+    mesh.vertexCount = header->vertexCount;
+    mesh.indexCount = header->indexCount;
+    mesh.positionOffset = glm::vec3(header->positionOffset[0], header->positionOffset[1], header->positionOffset[2]);
+    mesh.positionScale = header->positionScale;
+    mesh.storage = file;
+    return mesh;
+}
+
+bool MeshLoader::writeCooked(const std::string& path, const MeshData& mesh, uint64_t contentHash) {
+    if (!mesh.valid()) {
+        return false;
+    }
+    CookedHeader header{};
+    memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.vertexCount = mesh.vertexCount;
+    header.indexCount = mesh.indexCount;
+    header.positionOffset[0] = mesh.positionOffset.x;
+    header.positionOffset[1] = mesh.positionOffset.y;
+    header.positionOffset[2] = mesh.positionOffset.z;
+    header.positionScale = mesh.positionScale;
+    header.contentHash = contentHash;
+    static_assert(sizeof(CookedHeader) % 16 == 0, "vertex data must stay 16-byte aligned");
+    header.vertexOffset = sizeof(CookedHeader);
+    uint64_t vertexBytes = (uint64_t)mesh.vertexCount * sizeof(MeshVertex);
+    header.indexOffset = (header.vertexOffset + vertexBytes + 15) & ~(uint64_t)15;
+
+    // 先写临时文件再 rename，避免其他进程读到写了一半的文件
+    fs::path tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::error_code ec;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_WARN("MeshLoader: failed to write {}", tempPath.string());
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(mesh.vertices), (std::streamsize)vertexBytes);
+        const char padding[16] = {};
+        out.write(padding, (std::streamsize)(header.indexOffset - header.vertexOffset - vertexBytes));
+        out.write(reinterpret_cast<const char*>(mesh.indices), (std::streamsize)(mesh.indexCount * sizeof(uint32_t)));
+        if (!out) {
+            LOG_WARN("MeshLoader: failed to write {}", tempPath.string());
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        LOG_WARN("MeshLoader: failed to write {}, {}", path, ec.message());
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,62 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_MESHLOADER_H
+#define RENDERER_MESHLOADER_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <glm/glm.hpp>
+#include "VertexLayout.h"
+
+// 加载出来的顶点，16 字节。位置按整个 mesh 的包围盒量化到 snorm16，
+// 原始坐标 = MeshData::positionOffset + 解码值 * MeshData::positionScale
+struct MeshVertex {
+    Snorm16x4 position;
+    PackedNormal normal;
+    Half2 uv;
+};
+using MeshVertexLayout = VertexLayout<MeshVertex,
+    VERTEX_ATTRIB(0, MeshVertex, position),
+    VERTEX_ATTRIB(1, MeshVertex, normal),
+    VERTEX_ATTRIB(2, MeshVertex, uv)>;
+
+// 顶点和索引可以直接交给 glBufferData / MeshPool::add
+struct MeshData {
+    const MeshVertex* vertices = nullptr;
+    const uint32_t* indices = nullptr;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    glm::vec3 positionOffset = glm::vec3(0.0f);
+    float positionScale = 1.0f;
+    // 持有 vertices / indices 指向的内存(cooked 文件的 MappedFile 或者堆上的数组)
+    std::shared_ptr<void> storage;
+
+    bool valid() const { return vertices != nullptr && indices != nullptr && indexCount > 0; }
+    // 把量化后的 [-1, 1] 坐标还原到模型原始坐标，乘在 model 矩阵右边
+    glm::mat4 dequantizeMatrix() const;
+};
+
+// OBJ / glTF 2.0(.gltf + .bin / .glb) 网格加载，源文件整个 mmap 进来解析：
+// OBJ 按行边界切块，各块先并行统计再并行解析到预先算好的区间，不为每行分配 std::string；
+// glTF 的 JSON 很小，顶点数据按 accessor 从 buffer 中并行读取。
+// 解析后经 MeshOptimizer 优化，结果写进 cache/meshes 下的 cooked 文件，
+// 之后的运行直接 mmap cooked 文件，不再解析也不再优化。
+class MeshLoader {
+public:
+    // 按扩展名选择解析器(.obj / .gltf / .glb / .meshc)，失败时返回无效的 MeshData
+    static MeshData load(const std::string& path);
+    static MeshData loadObj(const std::string& path);
+    static MeshData loadGltf(const std::string& path);
+
+    // cooked 二进制格式，文件布局见 MeshLoader.cpp
+    static MeshData loadCooked(const std::string& path);
+    static bool writeCooked(const std::string& path, const MeshData& mesh, uint64_t contentHash = 0);
+
+    // 默认是 cache/meshes，传空字符串关闭缓存
+    static void setCacheDirectory(const std::string& directory);
+};
+
+
+#endif //RENDERER_MESHLOADER_H
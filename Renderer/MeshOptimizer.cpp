@@ -0,0 +1,389 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "Utils/Hash.h"
+#include "Utils/Logger.h"
+
+namespace {
+
+constexpr uint32_t kInvalid = UINT32_MAX;
+
+// 用时间戳模拟 FIFO：只有 miss 时时间前进，顶点在缓存里当且仅当它进入缓存之后又发生了不到 cacheSize 次 miss
+struct FifoCache {
+    std::vector<uint32_t> insertedAt;
+    uint32_t time;
+    uint32_t size;
+
+    FifoCache(size_t vertexCount, uint32_t cacheSize)
+        : insertedAt(vertexCount, 0), time(cacheSize + 1), size(cacheSize) {}
+
+    // 返回是否 miss
+    bool access(uint32_t vertex) {
+        if (time - insertedAt[vertex] < size) {
+            return false;
+        }
+        insertedAt[vertex] = time++;
+        return true;
+    }
+    // 让所有顶点失效
+    void reset() { time += size + 1; }
+};
+
+// Forsyth 算法参数，见 "Linear-Speed Vertex Cache Optimisation"
+constexpr int kForsythCacheSize = 32;
+constexpr float kCacheDecayPower = 1.5f;
+constexpr float kLastTriangleScore = 0.75f;
+constexpr float kValenceBoostScale = 2.0f;
+constexpr float kValenceBoostPower = 0.5f;
+
+constexpr uint32_t kMaxValenceTable = 64;
+
+// 分数只和缓存位置、剩余三角形数有关，预先算成表，避免在内循环里调用 pow
+struct ForsythScoreTable {
+    float cache[kForsythCacheSize];
+    float valence[kMaxValenceTable];
+
+    ForsythScoreTable() {
+        for (int i = 0; i < kForsythCacheSize; i++) {
+            if (i < 3) {
+                // 刚用过的三角形的顶点，分数固定，避免总是沿着同一条边走
+                cache[i] = kLastTriangleScore;
+            } else {
+                float scaler = 1.0f / (kForsythCacheSize - 3);
+                cache[i] = std::pow(1.0f - (i - 3) * scaler, kCacheDecayPower);
+            }
+        }
+        for (uint32_t i = 0; i < kMaxValenceTable; i++) {
+            // 剩余三角形少的顶点优先处理掉，避免留下零散的孤立三角形
+            valence[i] = i == 0 ? 0.0f : kValenceBoostScale * std::pow((float)i, -kValenceBoostPower);
+        }
+    }
+};
+
+float forsythVertexScore(int cachePosition, uint32_t remainingTriangles) {
+    static const ForsythScoreTable table;
+    if (remainingTriangles == 0) {
+        return -1.0f;
+    }
+    float score = cachePosition >= 0 ? table.cache[cachePosition] : 0.0f;
+    score += remainingTriangles < kMaxValenceTable
+             ? table.valence[remainingTriangles]
+             : kValenceBoostScale * std::pow((float)remainingTriangles, -kValenceBoostPower);
+    return score;
+}
+
+}
+
+VertexCacheStats MeshOptimizer::analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                                   uint32_t cacheSize) {
+    VertexCacheStats stats;
+    FifoCache cache(vertexCount, cacheSize);
+    std::vector<uint8_t> referenced(vertexCount, 0);
+    size_t uniqueVertices = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t vertex = indices[i];
+        if (cache.access(vertex)) {
+            stats.transforms++;
+        }
+        if (!referenced[vertex]) {
+            referenced[vertex] = 1;
+            uniqueVertices++;
+        }
+    }
+    size_t triangleCount = indexCount / 3;
+    stats.acmr = triangleCount ? (float)stats.transforms / triangleCount : 0.0f;
+    stats.atvr = uniqueVertices ? (float)stats.transforms / uniqueVertices : 0.0f;
+    return stats;
+}
+
+size_t MeshOptimizer::generateVertexRemap(uint32_t* remap, const void* vertices, size_t vertexCount, size_t stride) {
+    const uint8_t* bytes = static_cast<const uint8_t*>(vertices);
+    // 开放寻址哈希表，存放每个不同顶点第一次出现的下标
+    size_t tableSize = 1;
+    while (tableSize < vertexCount * 2) {
+        tableSize *= 2;
+    }
+    std::vector<uint32_t> table(tableSize, kInvalid);
+    size_t uniqueCount = 0;
+    for (size_t i = 0; i < vertexCount; i++) {
+        const uint8_t* vertex = bytes + i * stride;
+        size_t slot = fnv1aBytes(vertex, stride) & (tableSize - 1);
+        while (table[slot] != kInvalid && memcmp(bytes + table[slot] * stride, vertex, stride) != 0) {
+            slot = (slot + 1) & (tableSize - 1);
+        }
+        if (table[slot] == kInvalid) {
+            table[slot] = (uint32_t)i;
+            remap[i] = (uint32_t)uniqueCount++;
+        } else {
+            remap[i] = remap[table[slot]];
+        }
+    }
+    return uniqueCount;
+}
+
+void MeshOptimizer::remapVertices(void* dst, const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap) {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    const uint8_t* in = static_cast<const uint8_t*>(vertices);
+    for (size_t i = 0; i < vertexCount; i++) {
+        if (remap[i] != kInvalid) {
+            memcpy(out + (size_t)remap[i] * stride, in + i * stride, stride);
+        }
+    }
+}
+
+void MeshOptimizer::remapIndices(uint32_t* dst, const uint32_t* indices, size_t indexCount, const uint32_t* remap) {
+    for (size_t i = 0; i < indexCount; i++) {
+        dst[i] = remap[indices[i]];
+    }
+}
+
+void MeshOptimizer::optimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // 每个顶点相邻的三角形(CSR)，前 liveTriangles[v] 个是还没输出的
+    std::vector<uint32_t> adjacencyOffset(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; i++) {
+        adjacencyOffset[indices[i] + 1]++;
+    }
+    for (size_t v = 0; v < vertexCount; v++) {
+        adjacencyOffset[v + 1] += adjacencyOffset[v];
+    }
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t vertex = indices[t * 3 + corner];
+            adjacency[adjacencyOffset[vertex] + liveTriangles[vertex]++] = (uint32_t)t;
+        }
+    }
+
+    std::vector<int> cachePosition(vertexCount, -1);
+    std::vector<float> vertexScore(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++) {
+        vertexScore[v] = forsythVertexScore(-1, liveTriangles[v]);
+    }
+    std::vector<float> triangleScore(triangleCount);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    uint32_t bestTriangle = kInvalid;
+    float bestScore = -1.0f;
+    for (size_t t = 0; t < triangleCount; t++) {
+        const uint32_t* triangle = indices + t * 3;
+        triangleScore[t] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+        if (triangleScore[t] > bestScore) {
+            bestScore = triangleScore[t];
+            bestTriangle = (uint32_t)t;
+        }
+    }
+
+    uint32_t cache[kForsythCacheSize + 3];
+    int cacheCount = 0;
+    size_t searchCursor = 0;
+    for (size_t output = 0; output < triangleCount; output++) {
+        // 缓存里没有可用的三角形时，从头顺序找下一个没输出的
+        if (bestTriangle == kInvalid) {
+            while (emitted[searchCursor]) {
+                searchCursor++;
+            }
+            bestTriangle = (uint32_t)searchCursor;
+        }
+        const uint32_t* triangle = indices + (size_t)bestTriangle * 3;
+        dst[output * 3 + 0] = triangle[0];
+        dst[output * 3 + 1] = triangle[1];
+        dst[output * 3 + 2] = triangle[2];
+        emitted[bestTriangle] = 1;
+
+        // 从三个顶点的可用三角形列表中移除
+        for (int corner = 0; corner < 3; corner++) {
+            uint32_t vertex = triangle[corner];
+            uint32_t* begin = adjacency.data() + adjacencyOffset[vertex];
+            uint32_t* end = begin + liveTriangles[vertex];
+            uint32_t* found = std::find(begin, end, bestTriangle);
+            std::swap(*found, *(end - 1));
+            liveTriangles[vertex]--;
+        }
+
+        // LRU：新三角形的三个顶点放到最前面，其余依次后移
+        uint32_t newCache[kForsythCacheSize + 3];
+        int newCount = 0;
+        for (int corner = 0; corner < 3; corner++) {
+            newCache[newCount++] = triangle[corner];
+        }
+        for (int i = 0; i < cacheCount; i++) {
+            uint32_t vertex = cache[i];
+            if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2]) {
+                newCache[newCount++] = vertex;
+            }
+        }
+
+        // 更新缓存中(包括刚被挤出去的)顶点的分数，并把差值累加到相邻三角形上
+        bestTriangle = kInvalid;
+        bestScore = -1.0f;
+        for (int i = 0; i < newCount; i++) {
+            uint32_t vertex = newCache[i];
+            int position = i < kForsythCacheSize ? i : -1;
+            cachePosition[vertex] = position;
+            float score = forsythVertexScore(position, liveTriangles[vertex]);
+            float delta = score - vertexScore[vertex];
+            vertexScore[vertex] = score;
+            const uint32_t* begin = adjacency.data() + adjacencyOffset[vertex];
+            for (uint32_t j = 0; j < liveTriangles[vertex]; j++) {
+                uint32_t adjacent = begin[j];
+                triangleScore[adjacent] += delta;
+            }
+        }
+        // 下一个三角形只在缓存顶点的相邻三角形里找
+        cacheCount = std::min(newCount, kForsythCacheSize);
+        for (int i = 0; i < cacheCount; i++) {
+            uint32_t vertex = newCache[i];
+            cache[i] = vertex;
+            const uint32_t* begin = adjacency.data() + adjacencyOffset[vertex];
+            for (uint32_t j = 0; j < liveTriangles[vertex]; j++) {
+                uint32_t adjacent = begin[j];
+                if (triangleScore[adjacent] > bestScore) {
+                    bestScore = triangleScore[adjacent];
+                    bestTriangle = adjacent;
+                }
+            }
+        }
+    }
+}
+
+void MeshOptimizer::optimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                                     const float* positions, size_t vertexCount, float threshold) {
+    const size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+
+    // 1. 沿缓存优化后的顺序切簇：每个簇从冷缓存开始，簇内 ACMR 降到整体的 threshold 倍以内就断开，
+    //    这样簇之间随意重排也不会让顶点缓存效率明显变差
+    float targetAcmr = analyzeVertexCache(indices, indexCount, vertexCount).acmr * threshold;
+    std::vector<size_t> clusterStart;
+    FifoCache cache(vertexCount, kCacheSize);
+    size_t misses = 0;
+    size_t clusterTriangles = 0;
+    clusterStart.push_back(0);
+    for (size_t t = 0; t < triangleCount; t++) {
+        for (int corner = 0; corner < 3; corner++) {
+            misses += cache.access(indices[t * 3 + corner]);
+        }
+        clusterTriangles++;
+        if (t + 1 < triangleCount && misses <= targetAcmr * clusterTriangles) {
+            clusterStart.push_back(t + 1);
+            cache.reset();
+            misses = 0;
+            clusterTriangles = 0;
+        }
+    }
+    clusterStart.push_back(triangleCount);
+    const size_t clusterCount = clusterStart.size() - 1;
+
+    // 2. 每个簇的面积加权中心和法线
+    std::vector<glm::vec3> clusterCentroid(clusterCount, glm::vec3(0.0f));
+    std::vector<glm::vec3> clusterNormal(clusterCount, glm::vec3(0.0f));
+    glm::vec3 meshCentroid(0.0f);
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; c++) {
+        float clusterArea = 0.0f;
+        for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; t++) {
+            const uint32_t* triangle = indices + t * 3;
+            glm::vec3 p0(positions[triangle[0] * 3], positions[triangle[0] * 3 + 1], positions[triangle[0] * 3 + 2]);
+            glm::vec3 p1(positions[triangle[1] * 3], positions[triangle[1] * 3 + 1], positions[triangle[1] * 3 + 2]);
+            glm::vec3 p2(positions[triangle[2] * 3], positions[triangle[2] * 3 + 1], positions[triangle[2] * 3 + 2]);
+            glm::vec3 normal = glm::cross(p1 - p0, p2 - p0);
+            float area = glm::length(normal);
+            clusterCentroid[c] += (p0 + p1 + p2) * (area / 3.0f);
+            clusterNormal[c] += normal;
+            clusterArea += area;
+        }
+        meshCentroid += clusterCentroid[c];
+        meshArea += clusterArea;
+        if (clusterArea > 0.0f) {
+            clusterCentroid[c] = clusterCentroid[c] * (1.0f / clusterArea);
+        }
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid = meshCentroid * (1.0f / meshArea);
+    }
+
+    // 3. 越朝外(法线和"中心 -> 簇中心"方向越一致)的簇越先画，它们更可能遮挡后面的簇
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        float length = glm::length(clusterNormal[c]);
+        glm::vec3 normal = length > 0.0f ? clusterNormal[c] * (1.0f / length) : glm::vec3(0.0f);
+        sortKey[c] = glm::dot(clusterCentroid[c] - meshCentroid, normal);
+    }
+    std::vector<uint32_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++) {
+        order[c] = (uint32_t)c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    size_t output = 0;
+    for (uint32_t c : order) {
+        size_t begin = clusterStart[c] * 3;
+        size_t end = clusterStart[c + 1] * 3;
+        memcpy(dst + output, indices + begin, (end - begin) * sizeof(uint32_t));
+        output += end - begin;
+    }
+}
+
+size_t MeshOptimizer::optimizeVertexFetch(void* dst, uint32_t* indices, size_t indexCount,
+                                          const void* vertices, size_t vertexCount, size_t stride) {
+    uint8_t* out = static_cast<uint8_t*>(dst);
+    const uint8_t* in = static_cast<const uint8_t*>(vertices);
+    std::vector<uint32_t> remap(vertexCount, kInvalid);
+    uint32_t next = 0;
+    for (size_t i = 0; i < indexCount; i++) {
+        uint32_t vertex = indices[i];
+        if (remap[vertex] == kInvalid) {
+            remap[vertex] = next;
+            memcpy(out + (size_t)next * stride, in + (size_t)vertex * stride, stride);
+            next++;
+        }
+        indices[i] = remap[vertex];
+    }
+    return next;
+}
+
+size_t MeshOptimizer::optimize(const char* name, void* dstVertices, const void* vertices, size_t vertexCount, size_t stride,
+                               uint32_t* indices, size_t indexCount, const float* positions, MeshOptimizeReport* report) {
+    MeshOptimizeReport result;
+    result.verticesBefore = vertexCount;
+    result.before = analyzeVertexCache(indices, indexCount, vertexCount);
+
+    // 1. 去重，顶点和位置用同一张 remap 表
+    std::vector<uint32_t> remap(vertexCount);
+    size_t uniqueCount = generateVertexRemap(remap.data(), vertices, vertexCount, stride);
+    std::vector<uint8_t> uniqueVertices(uniqueCount * stride);
+    std::vector<float> uniquePositions(uniqueCount * 3);
+    remapVertices(uniqueVertices.data(), vertices, vertexCount, stride, remap.data());
+    remapVertices(uniquePositions.data(), positions, vertexCount, 3 * sizeof(float), remap.data());
+    remapIndices(indices, indices, indexCount, remap.data());
+
+    // 2. 顶点缓存 3. overdraw
+    std::vector<uint32_t> cacheOptimized(indexCount);
+    optimizeVertexCache(cacheOptimized.data(), indices, indexCount, uniqueCount);
+    optimizeOverdraw(indices, cacheOptimized.data(), indexCount, uniquePositions.data(), uniqueCount);
+
+    // 4. 顶点读取顺序
+    size_t finalCount = optimizeVertexFetch(dstVertices, indices, indexCount, uniqueVertices.data(), uniqueCount, stride);
+
+    result.verticesAfter = finalCount;
+    result.after = analyzeVertexCache(indices, indexCount, finalCount);
+    LOG_INFO("MeshOptimizer {}: {} triangles, vertices {} -> {}, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+             name, indexCount / 3, result.verticesBefore, result.verticesAfter,
+             result.before.acmr, result.after.acmr, result.before.atvr, result.after.atvr);
+    if (report) {
+        *report = result;
+    }
+    return finalCount;
+}
@@ -0,0 +1,83 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_MESHOPTIMIZER_H
+#define RENDERER_MESHOPTIMIZER_H
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <glm/glm.hpp>
+
+// 顶点缓存模拟的结果
+// ACMR = 变换次数 / 三角形数(越接近 0.5 越好，最差 3)
+// ATVR = 变换次数 / 顶点数(越接近 1 越好)
+struct VertexCacheStats {
+    size_t transforms = 0;
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+struct MeshOptimizeReport {
+    size_t verticesBefore = 0;
+    size_t verticesAfter = 0;
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+// 离线/加载时的 mesh 优化，输入就是上传给 glBufferData 的交错顶点数组和 uint32 索引数组：
+// 1. 去重：字节完全相同的顶点合并成一个
+// 2. 顶点缓存优化：Forsyth 算法重排三角形
+// 3. overdraw 优化：把缓存友好的三角形序列切成簇，朝外的簇先画
+// 4. 顶点读取优化：按第一次被引用的顺序重排顶点
+// 一般直接用 optimize()，它依次执行以上步骤并打印每个 mesh 优化前后的 ACMR/ATVR。
+class MeshOptimizer {
+public:
+    // 大多数 GPU 的 post-transform cache 近似为 16 项 FIFO
+    static constexpr uint32_t kCacheSize = 16;
+
+    static VertexCacheStats analyzeVertexCache(const uint32_t* indices, size_t indexCount, size_t vertexCount,
+                                               uint32_t cacheSize = kCacheSize);
+
+    // remap[old] = new，返回去重后的顶点数
+    static size_t generateVertexRemap(uint32_t* remap, const void* vertices, size_t vertexCount, size_t stride);
+    static void remapVertices(void* dst, const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap);
+    static void remapIndices(uint32_t* dst, const uint32_t* indices, size_t indexCount, const uint32_t* remap);
+
+    // dst 和 indices 不能是同一块内存
+    static void optimizeVertexCache(uint32_t* dst, const uint32_t* indices, size_t indexCount, size_t vertexCount);
+    // positions 是每个顶点 3 个 float，threshold 允许簇的 ACMR 比整体差多少
+    static void optimizeOverdraw(uint32_t* dst, const uint32_t* indices, size_t indexCount,
+                                 const float* positions, size_t vertexCount, float threshold = 1.05f);
+    // 就地改写 indices，没有被引用的顶点会被丢弃，返回新的顶点数
+    static size_t optimizeVertexFetch(void* dst, uint32_t* indices, size_t indexCount,
+                                      const void* vertices, size_t vertexCount, size_t stride);
+
+    // 完整流程；position(vertex) 返回顶点的位置，用于 overdraw 排序(压缩格式的顶点可以在这里解码)
+    template<typename Vertex, typename PositionFn>
+    static MeshOptimizeReport optimize(const char* name, std::vector<Vertex>& vertices, std::vector<uint32_t>& indices,
+                                       PositionFn&& position) {
+        static_assert(std::is_trivially_copyable_v<Vertex>, "vertices are copied as raw bytes");
+        std::vector<float> positions;
+        positions.reserve(vertices.size() * 3);
+        for (const Vertex& vertex : vertices) {
+            glm::vec3 p = position(vertex);
+            positions.insert(positions.end(), {p.x, p.y, p.z});
+        }
+        std::vector<Vertex> optimized(vertices);
+        MeshOptimizeReport report;
+        size_t vertexCount = optimize(name, optimized.data(), vertices.data(), vertices.size(), sizeof(Vertex),
+                                      indices.data(), indices.size(), positions.data(), &report);
+        optimized.erase(optimized.begin() + vertexCount, optimized.end());
+        vertices.swap(optimized);
+        return report;
+    }
+
+    // 非模板版本：dstVertices 至少 vertexCount * stride 字节，indices 就地改写，返回新的顶点数
+    static size_t optimize(const char* name, void* dstVertices, const void* vertices, size_t vertexCount, size_t stride,
+                           uint32_t* indices, size_t indexCount, const float* positions, MeshOptimizeReport* report);
+};
+
+
+#endif //RENDERER_MESHOPTIMIZER_H
@@ -0,0 +1,62 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "MeshPool.h"
+#include "GLStateCache.h"
+#include "Utils/Logger.h"
+
+MeshPool::MeshPool(GLsizei vertexStride, const std::vector<VertexAttribute>& attributes,
+                   uint32_t maxVertices, uint32_t maxIndices)
+    : m_vertexStride(vertexStride), m_maxVertices(maxVertices), m_maxIndices(maxIndices) {
+    glGenVertexArrays(1, &m_vao);
+    glGenBuffers(1, &m_vbo);
+    glGenBuffers(1, &m_ebo);
+
+    GLStateCache::bindVertexArray(m_vao);
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)maxVertices * vertexStride, nullptr, GL_STATIC_DRAW);
+    // EBO 绑定记录在 VAO 里，之后只需要绑定 VAO
+    GLStateCache::bindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, (GLsizeiptr)maxIndices * sizeof(uint32_t), nullptr, GL_STATIC_DRAW);
+
+    applyVertexAttributes(attributes, vertexStride);
+    GLStateCache::bindVertexArray(0);
+}
+
+MeshRange MeshPool::add(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount) {
+    if (m_vertexCount + vertexCount > m_maxVertices || m_indexCount + indexCount > m_maxIndices) {
+        LOG_ERROR("MeshPool is full: {} + {} vertices (max {}), {} + {} indices (max {})",
+                  m_vertexCount, vertexCount, m_maxVertices, m_indexCount, indexCount, m_maxIndices);
+        return MeshRange();
+    }
+
+    GLStateCache::bindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)m_vertexCount * m_vertexStride,
+                    (GLsizeiptr)vertexCount * m_vertexStride, vertices);
+    // 修改 EBO 之前先绑定自己的 VAO，避免改掉其他 VAO 的 element buffer 绑定
+    GLStateCache::bindVertexArray(m_vao);
+    glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, (GLintptr)m_indexCount * sizeof(uint32_t),
+                    (GLsizeiptr)indexCount * sizeof(uint32_t), indices);
+    GLStateCache::bindVertexArray(0);
+
+    // 索引保持相对值，绘制时由 baseVertex 加上偏移
+    MeshRange range;
+    range.firstIndex = m_indexCount;
+    range.indexCount = indexCount;
+    range.baseVertex = (int32_t)m_vertexCount;
+    m_vertexCount += vertexCount;
+    m_indexCount += indexCount;
+    return range;
+}
+
+void MeshPool::bind() const {
+    GLStateCache::bindVertexArray(m_vao);
+}
+
+void MeshPool::destroy() {
+    GLStateCache::deleteVertexArrays(1, &m_vao);
+    GLStateCache::deleteBuffers(1, &m_vbo);
+    GLStateCache::deleteBuffers(1, &m_ebo);
+    m_vao = m_vbo = m_ebo = 0;
+}
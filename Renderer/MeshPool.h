@@ -0,0 +1,55 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_MESHPOOL_H
+#define RENDERER_MESHPOOL_H
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "VertexLayout.h"
+
+// 一个 mesh 在 MeshPool 大缓冲里的位置，正好是 glDrawElementsBaseVertex / indirect command 需要的参数
+struct MeshRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t baseVertex = 0;
+
+    bool valid() const { return indexCount > 0; }
+};
+
+// 顶点格式相同的多个 mesh 共用一个 VAO + 一个大 VBO/EBO。
+// 容量在创建时固定，add 只是顺序往后追加(不支持单独释放)，所以所有 mesh 可以在一次绑定下绘制，
+// 也可以交给 IndirectBatch 用一次 glMultiDrawElementsIndirect 画完。
+class MeshPool {
+public:
+    MeshPool(GLsizei vertexStride, const std::vector<VertexAttribute>& attributes,
+             uint32_t maxVertices, uint32_t maxIndices);
+    MeshPool(const MeshPool&) = delete;
+    MeshPool& operator=(const MeshPool&) = delete;
+
+    // indices 是相对这个 mesh 自己的顶点编号，空间不够时返回无效的 MeshRange
+    MeshRange add(const void* vertices, uint32_t vertexCount, const uint32_t* indices, uint32_t indexCount);
+
+    void bind() const;
+    // 和其他 GL 资源一样，需要在 context 销毁之前手动释放
+    void destroy();
+
+    GLuint vao() const { return m_vao; }
+    uint32_t vertexCount() const { return m_vertexCount; }
+    uint32_t indexCount() const { return m_indexCount; }
+
+private:
+    GLuint m_vao = 0;
+    GLuint m_vbo = 0;
+    GLuint m_ebo = 0;
+    GLsizei m_vertexStride;
+    uint32_t m_maxVertices;
+    uint32_t m_maxIndices;
+    uint32_t m_vertexCount = 0;
+    uint32_t m_indexCount = 0;
+};
+
+
+#endif //RENDERER_MESHPOOL_H
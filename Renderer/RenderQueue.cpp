@@ -0,0 +1,128 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "RenderQueue.h"
+#include <chrono>
+#include "GLStateCache.h"
+#include "Utils/ThreadPool.h"
+
+namespace {
+    double elapsedMs(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+}
+
+void RenderQueue::beginFrame(size_t bucketCount) {
+    // bucket 只增不减，保留上一帧的容量
+    if (m_buckets.size() < bucketCount) {
+        m_buckets.resize(bucketCount);
+    }
+    m_bucketCount = bucketCount;
+    for (size_t i = 0; i < m_bucketCount; i++) {
+        m_buckets[i].clear();
+    }
+    m_entries.clear();
+}
+
+void RenderQueue::record(ThreadPool& pool, size_t count, size_t chunkSize,
+                         const std::function<void(CommandBucket& bucket, size_t begin, size_t end)>& body) {
+    chunkSize = chunkSize > 0 ? chunkSize : 1;
+    beginFrame((count + chunkSize - 1) / chunkSize);
+    if (count == 0) {
+        return;
+    }
+    // parallelFor 按 chunkSize 对齐切块，begin / chunkSize 就是块号，每块写自己的 bucket，不需要锁
+    pool.parallelFor(count, chunkSize, [&](size_t begin, size_t end) {
+        body(m_buckets[begin / chunkSize], begin, end);
+    });
+}
+
+void RenderQueue::sort() {
+    auto start = std::chrono::steady_clock::now();
+    size_t total = 0;
+    for (size_t i = 0; i < m_bucketCount; i++) {
+        total += m_buckets[i].size();
+    }
+    m_entries.resize(total);
+    size_t next = 0;
+    for (size_t b = 0; b < m_bucketCount; b++) {
+        const CommandBucket& bucket = m_buckets[b];
+        for (size_t i = 0; i < bucket.size(); i++) {
+            m_entries[next++] = {bucket.packet(i).key, (uint32_t)b, (uint32_t)i};
+        }
+    }
+
+    // LSD 基数排序：一次遍历统计 8 个字节的直方图，之后每趟稳定地按一个字节分配。
+    // 所有 key 在某个字节上都相同(例如 layer 只用了一个值)时这一趟什么也不改变，直接跳过
+    size_t histograms[8][256] = {};
+    for (const Entry& entry : m_entries) {
+        for (int pass = 0; pass < 8; pass++) {
+            histograms[pass][(entry.key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+    m_scratch.resize(total);
+    for (int pass = 0; pass < 8 && total > 1; pass++) {
+        size_t* histogram = histograms[pass];
+        uint32_t firstByte = (uint32_t)((m_entries[0].key >> (pass * 8)) & 0xFF);
+        if (histogram[firstByte] == total) {
+            continue;
+        }
+        size_t offset = 0;
+        for (int bin = 0; bin < 256; bin++) {
+            size_t binCount = histogram[bin];
+            histogram[bin] = offset;
+            offset += binCount;
+        }
+        for (const Entry& entry : m_entries) {
+            m_scratch[histogram[(entry.key >> (pass * 8)) & 0xFF]++] = entry;
+        }
+        m_entries.swap(m_scratch);
+    }
+
+    m_stats = Stats();
+    m_stats.packets = total;
+    m_stats.sortMs = elapsedMs(start);
+}
+
+void RenderQueue::submit(const PerDrawCallback& perDraw) {
+    auto start = std::chrono::steady_clock::now();
+    const DrawPacket* previous = nullptr;
+    for (const Entry& entry : m_entries) {
+        const CommandBucket& bucket = m_buckets[entry.bucket];
+        const DrawPacket& packet = bucket.packet(entry.index);
+
+        // 排序后相邻的 draw 大多共用状态，重复的绑定由 GLStateCache 过滤
+        if (!previous || previous->program != packet.program) {
+            m_stats.programChanges++;
+        }
+        GLStateCache::useProgram(packet.program);
+        if (!previous || previous->vao != packet.vao) {
+            m_stats.vaoChanges++;
+        }
+        GLStateCache::bindVertexArray(packet.vao);
+        bool texturesChanged = !previous || previous->textureCount != packet.textureCount;
+        for (uint32_t unit = 0; unit < packet.textureCount; unit++) {
+            texturesChanged = texturesChanged || previous->textures[unit] != packet.textures[unit];
+            GLStateCache::bindTexture(unit, packet.textureTargets[unit], packet.textures[unit]);
+        }
+        if (texturesChanged) {
+            m_stats.textureChanges++;
+        }
+
+        if (perDraw) {
+            perDraw(packet, bucket.data(packet));
+        }
+
+        const void* indices = (const void*)(uintptr_t)(packet.firstIndex * sizeof(GLuint));
+        if (packet.instanceCount > 1) {
+            glDrawElementsInstancedBaseVertex(packet.mode, (GLsizei)packet.indexCount, GL_UNSIGNED_INT, indices,
+                                              (GLsizei)packet.instanceCount, packet.baseVertex);
+        } else if (packet.instanceCount == 1) {
+            glDrawElementsBaseVertex(packet.mode, (GLsizei)packet.indexCount, GL_UNSIGNED_INT, indices,
+                                     packet.baseVertex);
+        }
+        previous = &packet;
+    }
+    m_stats.submitMs = elapsedMs(start);
+}
@@ -0,0 +1,167 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_RENDERQUEUE_H
+#define RENDERER_RENDERQUEUE_H
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool;
+
+// 64 位排序键，从高位到低位：
+//   [63:60] layer    4 位，先画不透明再画透明等大的分组
+//   [59:48] program 12 位，调用方分配的小整数编号(不是 GL 名字)
+//   [47:24] textures 24 位，纹理组合的编号
+//   [23:0]  depth   24 位，量化后的视空间深度
+// 按键升序回放时，同一层内相同 program、相同纹理的 draw 排在一起，状态切换最少；
+// 不透明物体用 depth 从近到远减少 overdraw，透明物体传 invertDepth 变成从远到近。
+struct SortKey {
+    static constexpr uint32_t kLayerBits = 4;
+    static constexpr uint32_t kProgramBits = 12;
+    static constexpr uint32_t kTextureBits = 24;
+    static constexpr uint32_t kDepthBits = 24;
+
+    static uint64_t make(uint32_t layer, uint32_t program, uint32_t textureSet, uint32_t depth) {
+        return ((uint64_t)(layer & ((1u << kLayerBits) - 1)) << 60) |
+               ((uint64_t)(program & ((1u << kProgramBits) - 1)) << 48) |
+               ((uint64_t)(textureSet & ((1u << kTextureBits) - 1)) << 24) |
+               (uint64_t)(depth & ((1u << kDepthBits) - 1));
+    }
+
+    // viewDepth 是到相机的距离(视空间 -z)，按 [0, farPlane] 量化
+    static uint32_t quantizeDepth(float viewDepth, float farPlane, bool invertDepth = false) {
+        float t = farPlane > 0.0f ? viewDepth / farPlane : 0.0f;
+        t = t < 0.0f ? 0.0f : (t > 1.0f ? 1.0f : t);
+        uint32_t depth = (uint32_t)(t * (float)((1u << kDepthBits) - 1));
+        return invertDepth ? ((1u << kDepthBits) - 1) - depth : depth;
+    }
+};
+
+// 一次 draw 需要的全部状态，纯数据，可以在任意线程填写
+struct DrawPacket {
+    static constexpr uint32_t kMaxTextures = 4;
+
+    uint64_t key = 0;
+    GLuint program = 0;
+    GLuint vao = 0;
+    // textures[i] 绑定到纹理单元 i
+    GLenum textureTargets[kMaxTextures] = {};
+    GLuint textures[kMaxTextures] = {};
+    uint32_t textureCount = 0;
+    GLenum mode = GL_TRIANGLES;
+    uint32_t indexCount = 0;
+    uint32_t firstIndex = 0;
+    int32_t baseVertex = 0;
+    uint32_t instanceCount = 1;
+    // 这个 draw 自己的数据(model 矩阵等)在所属 bucket 数据区中的位置，回放时交给 PerDrawCallback
+    uint32_t dataOffset = 0;
+    uint32_t dataSize = 0;
+};
+
+// 一个录制线程(或一个任务块)独占的命令缓冲，录制时不需要加锁。
+// clear 保留容量，稳定之后每帧不再分配内存。
+class CommandBucket {
+public:
+    void clear() {
+        m_packets.clear();
+        m_dataSize = 0;
+    }
+
+    void add(const DrawPacket& packet) { m_packets.push_back(packet); }
+
+    // PerDraw 按值拷贝进数据区，回放时以 const void* 传回。数据区按 16 字节对齐，glm 类型可以直接读
+    template<typename PerDraw>
+    void add(DrawPacket packet, const PerDraw& data) {
+        static_assert(std::is_trivially_copyable_v<PerDraw>, "per-draw data is copied as raw bytes");
+        static_assert(alignof(PerDraw) <= sizeof(DataBlock), "per-draw data alignment above 16 is not supported");
+        size_t offset = (m_dataSize + alignof(PerDraw) - 1) / alignof(PerDraw) * alignof(PerDraw);
+        reserveData(offset + sizeof(PerDraw));
+        memcpy(dataBytes() + offset, &data, sizeof(PerDraw));
+        m_dataSize = offset + sizeof(PerDraw);
+        packet.dataOffset = (uint32_t)offset;
+        packet.dataSize = (uint32_t)sizeof(PerDraw);
+        m_packets.push_back(packet);
+    }
+
+    size_t size() const { return m_packets.size(); }
+    const DrawPacket& packet(size_t index) const { return m_packets[index]; }
+    const void* data(const DrawPacket& packet) const {
+        return packet.dataSize > 0 ? m_data.data()->bytes + packet.dataOffset : nullptr;
+    }
+
+private:
+    struct alignas(16) DataBlock {
+        unsigned char bytes[16];
+    };
+
+    void reserveData(size_t size) {
+        if (size > m_data.size() * sizeof(DataBlock)) {
+            m_data.resize((size + sizeof(DataBlock) - 1) / sizeof(DataBlock) * 2);
+        }
+    }
+    unsigned char* dataBytes() { return m_data.data()->bytes; }
+
+    std::vector<DrawPacket> m_packets;
+    std::vector<DataBlock> m_data;
+    size_t m_dataSize = 0;
+};
+
+// 每帧的流程：
+//   queue.beginFrame(bucketCount);
+//   各线程往 queue.bucket(i) 录制 DrawPacket(可以用 record 在线程池上并行遍历场景)；
+//   queue.sort();                 // GL 线程，合并所有 bucket 并按 key 基数排序
+//   queue.submit(perDraw);        // GL 线程，状态经 GLStateCache 设置，按顺序发出 draw
+// 同 key 的 draw 保持 bucket 顺序 + 录制顺序，结果和线程调度无关。
+class RenderQueue {
+public:
+    // 设置每个 draw 自己的 uniform，data 是 CommandBucket::add 时拷贝的数据
+    using PerDrawCallback = std::function<void(const DrawPacket& packet, const void* data)>;
+
+    struct Stats {
+        size_t packets = 0;
+        double sortMs = 0.0;
+        double submitMs = 0.0;
+        // 相邻 draw 之间 program / VAO / 纹理组合发生变化的次数
+        size_t programChanges = 0;
+        size_t vaoChanges = 0;
+        size_t textureChanges = 0;
+    };
+
+    void beginFrame(size_t bucketCount);
+    CommandBucket& bucket(size_t index) { return m_buckets[index]; }
+    size_t bucketCount() const { return m_bucketCount; }
+
+    // 把 [0, count) 按 chunkSize 切块在线程池上并行执行，第 i 块写入 bucket(i)。
+    // 会先按块数调用 beginFrame
+    void record(ThreadPool& pool, size_t count, size_t chunkSize,
+                const std::function<void(CommandBucket& bucket, size_t begin, size_t end)>& body);
+
+    // 合并所有 bucket，按 key 做 LSD 基数排序(每次 8 位，所有 key 在某个字节上相同时跳过这一趟)
+    void sort();
+    void submit(const PerDrawCallback& perDraw = {});
+
+    size_t size() const { return m_entries.size(); }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint32_t bucket;
+        uint32_t index;
+    };
+
+    std::vector<CommandBucket> m_buckets;
+    size_t m_bucketCount = 0;
+    std::vector<Entry> m_entries;
+    std::vector<Entry> m_scratch;
+    Stats m_stats;
+};
+
+
+#endif //RENDERER_RENDERQUEUE_H
@@ -0,0 +1,204 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "StreamBuffer.h"
+#include <algorithm>
+#include <cassert>
+#include "GLStateCache.h"
+#include "Utils/Logger.h"
+
+namespace {
+    // 等 fence 时每次最多等 1 秒，超时后继续等，GL_WAIT_FAILED 时放弃
+    constexpr GLuint64 kFenceTimeoutNs = 1000000000ull;
+}
+
+StreamBuffer::StreamBuffer(GLsizeiptr frameSize, uint32_t frameCount, Mode mode)
+    : m_frameSize(frameSize), m_frameCount(frameCount > 0 ? frameCount : 1), m_mode(mode) {
+    // 区域起点 m_frame * m_frameSize 也要对齐，否则区域 1、2 里的分配绑定时 offset 不合法
+    const GLsizeiptr alignment = rangeAlignment();
+    m_frameSize = (m_frameSize + alignment - 1) / alignment * alignment;
+    if (m_mode == Mode::Auto) {
+        m_mode = persistentSupported() ? Mode::Persistent : Mode::Unsynchronized;
+    } else if (m_mode == Mode::Persistent && !persistentSupported()) {
+        LOG_WARN("StreamBuffer: glBufferStorage not supported, falling back to unsynchronized mapping");
+        m_mode = Mode::Unsynchronized;
+    }
+    // orphan 每帧换新存储，不需要多个区域
+    if (m_mode == Mode::Orphan) {
+        m_frameCount = 1;
+    }
+    m_fences.assign(m_frameCount, nullptr);
+    // 第一次 beginFrame 会切到区域 0
+    m_frame = m_frameCount - 1;
+
+    GLsizeiptr totalSize = m_frameSize * m_frameCount;
+    glGenBuffers(1, &m_buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+#if defined(GL_VERSION_4_4) || defined(GL_ARB_buffer_storage)
+    if (m_mode == Mode::Persistent) {
+        // coherent 映射：CPU 写入对之后提交的命令直接可见，不需要 flush
+        const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glBufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+        m_mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags));
+        if (!m_mapped) {
+            // 存储已经是不可变的，只能重新创建缓冲
+            LOG_WARN("StreamBuffer: persistent mapping failed, falling back to unsynchronized mapping");
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            GLStateCache::deleteBuffers(1, &m_buffer);
+            glGenBuffers(1, &m_buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+            m_mode = Mode::Unsynchronized;
+        }
+    }
+#endif
+    if (m_mode != Mode::Persistent) {
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    LOG_TRACE("StreamBuffer: {} x {} bytes, mode = {}", m_frameCount, m_frameSize, modeName(m_mode));
+}
+
+bool StreamBuffer::persistentSupported() {
+    static const bool s_supported = [] {
+        bool available = false;
+#ifdef GL_VERSION_4_4
+        available = available || GLAD_GL_VERSION_4_4;
+#endif
+#ifdef GL_ARB_buffer_storage
+        available = available || GLAD_GL_ARB_buffer_storage;
+#endif
+        return available;
+    }();
+    return s_supported;
+}
+
+GLsizeiptr StreamBuffer::rangeAlignment() {
+    static const GLsizeiptr s_alignment = [] {
+        GLint uniformAlignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+        GLint storageAlignment = 0;
+#if defined(GL_VERSION_4_3) || defined(GL_ARB_shader_storage_buffer_object)
+        glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+#endif
+        // 规范要求的最大值是 256，查询失败时按它处理
+        GLint alignment = std::max(uniformAlignment, storageAlignment);
+        return (GLsizeiptr)(alignment > 0 ? alignment : 256);
+    }();
+    return s_alignment;
+}
+
+const char* StreamBuffer::modeName(Mode mode) {
+    switch (mode) {
+        case Mode::Auto: return "auto";
+        case Mode::Persistent: return "persistent";
+        case Mode::Unsynchronized: return "unsynchronized";
+        case Mode::Orphan: return "orphan";
+    }
+    return "unknown";
+}
+
+void StreamBuffer::beginFrame() {
+    assert(!m_inFrame && "StreamBuffer::beginFrame called twice without endFrame");
+    m_frame = (m_frame + 1) % m_frameCount;
+    m_head = 0;
+    m_inFrame = true;
+
+    if (m_mode == Mode::Orphan) {
+        // 旧存储交给驱动，GPU 读完后再回收
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, m_frameSize, nullptr, GL_STREAM_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        return;
+    }
+
+    GLsync& fence = m_fences[m_frame];
+    if (!fence) {
+        return;
+    }
+    // 先不等待地查询一次，大多数帧 GPU 已经读完了
+    GLenum result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) {
+        m_stallCount++;
+        do {
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceTimeoutNs);
+        } while (result == GL_TIMEOUT_EXPIRED);
+    }
+    if (result == GL_WAIT_FAILED) {
+        LOG_ERROR("StreamBuffer: glClientWaitSync failed");
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+}
+
+StreamAllocation StreamBuffer::allocate(GLsizeiptr size, GLsizeiptr alignment) {
+    assert(m_inFrame && "StreamBuffer::allocate called outside beginFrame/endFrame");
+    assert(!m_pendingMap && "commit the previous allocation before allocating again");
+    StreamAllocation allocation;
+    if (size <= 0) {
+        return allocation;
+    }
+    alignment = alignment > 0 ? alignment : 1;
+    // 对齐的是整个缓冲内的 offset，绑定 UBO / SSBO 时检查的是它
+    const GLsizeiptr base = (GLsizeiptr)m_frame * m_frameSize;
+    GLsizeiptr start = (base + m_head + alignment - 1) / alignment * alignment - base;
+    if (start + size > m_frameSize) {
+        if (!m_overflowWarned) {
+            LOG_WARN("StreamBuffer: frame region of {} bytes is full ({} + {} requested)", m_frameSize, start, size);
+            m_overflowWarned = true;
+        }
+        return allocation;
+    }
+    m_head = start + size;
+    allocation.buffer = m_buffer;
+    allocation.offset = (GLintptr)m_frame * m_frameSize + start;
+    allocation.size = size;
+
+    if (m_mode == Mode::Persistent) {
+        allocation.data = m_mapped + allocation.offset;
+        return allocation;
+    }
+    // fence(或 orphan)已经保证这段没有在被 GPU 读，驱动不需要再同步
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    allocation.data = glMapBufferRange(GL_COPY_WRITE_BUFFER, allocation.offset, size,
+                                       GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_pendingMap = allocation.data != nullptr;
+    return allocation;
+}
+
+void StreamBuffer::commit(const StreamAllocation& allocation) {
+    if (m_mode == Mode::Persistent || !allocation.valid()) {
+        return;
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+    glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    m_pendingMap = false;
+}
+
+void StreamBuffer::endFrame() {
+    assert(m_inFrame && "StreamBuffer::endFrame called without beginFrame");
+    assert(!m_pendingMap && "commit the last allocation before endFrame");
+    m_inFrame = false;
+    if (m_mode != Mode::Orphan) {
+        m_fences[m_frame] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    }
+}
+
+void StreamBuffer::destroy() {
+    for (GLsync& fence : m_fences) {
+        if (fence) {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+    if (m_mapped) {
+        glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+        glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        m_mapped = nullptr;
+    }
+    GLStateCache::deleteBuffers(1, &m_buffer);
+    m_buffer = 0;
+}
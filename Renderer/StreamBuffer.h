@@ -0,0 +1,95 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_STREAMBUFFER_H
+#define RENDERER_STREAMBUFFER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+// StreamBuffer::allocate 的结果，data 只在 commit 之前可写
+struct StreamAllocation {
+    void* data = nullptr;
+    GLuint buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+
+    bool valid() const { return data != nullptr; }
+};
+
+// 每帧都会整块重写的动态数据(实例矩阵、indirect 命令、per-draw SSBO 等)用的环形缓冲。
+// 缓冲分成 frameCount 个区域，每帧在一个区域里顺序分配(bump allocator)，
+// endFrame 插入 fence，下次轮到这个区域时 beginFrame 等这个 fence，CPU 不会覆盖 GPU 还在读的数据。
+// 三种实现按可用性选择：
+//   Persistent:     GL 4.4 / ARB_buffer_storage，glBufferStorage + 持久 coherent 映射，只映射一次
+//   Unsynchronized: GL 3.3，每次分配 glMapBufferRange(UNSYNCHRONIZED)，同步仍然靠 fence
+//   Orphan:         只有一个区域，每帧 glBufferData(nullptr) 换一块新存储，由驱动负责同步
+// 用法：
+//   stream.beginFrame();
+//   StreamAllocation a = stream.allocate(size);
+//   memcpy(a.data, ...); stream.commit(a);
+//   ... 用 a.buffer / a.offset 绑定并绘制 ...
+//   stream.endFrame();
+class StreamBuffer {
+public:
+    enum class Mode {
+        Auto,
+        Persistent,
+        Unsynchronized,
+        Orphan,
+    };
+
+    static constexpr uint32_t kDefaultFrameCount = 3;
+
+    // frameSize 是每帧可分配的字节数(会向上取整到 rangeAlignment() 的倍数)，Auto 时能用 Persistent 就用。
+    // 内部只通过 GL_COPY_WRITE_BUFFER 操作缓冲，不会改动调用方的 GL_ARRAY_BUFFER / VAO 绑定
+    explicit StreamBuffer(GLsizeiptr frameSize, uint32_t frameCount = kDefaultFrameCount, Mode mode = Mode::Auto);
+    StreamBuffer(const StreamBuffer&) = delete;
+    StreamBuffer& operator=(const StreamBuffer&) = delete;
+
+    static bool persistentSupported();
+    // glBindBufferRange 绑定 UBO / SSBO 时 offset 要满足的对齐，取两者中较大的。
+    // 每帧区域的大小会向上取整到它的倍数，按它对齐的分配在任何区域里都能直接绑定
+    static GLsizeiptr rangeAlignment();
+
+    // 切到下一个区域，必要时等待 GPU 读完它上一次的数据
+    void beginFrame();
+    // 在当前区域中分配，返回的(整个缓冲内的) offset 按 alignment 对齐；空间不足时返回无效的 StreamAllocation。
+    // 非 Persistent 模式下分配是单独映射的，commit 之前不能再 allocate
+    StreamAllocation allocate(GLsizeiptr size, GLsizeiptr alignment = 16);
+    // 写完之后、绘制之前调用；Persistent 模式下什么也不做
+    void commit(const StreamAllocation& allocation);
+    // 当前帧所有读取这个缓冲的命令提交之后调用
+    void endFrame();
+
+    // 和其他 GL 资源一样，需要在 context 销毁之前手动释放
+    void destroy();
+
+    Mode mode() const { return m_mode; }
+    GLuint id() const { return m_buffer; }
+    GLsizeiptr frameSize() const { return m_frameSize; }
+    // beginFrame 时 fence 还没到、CPU 真正等待了的次数
+    uint64_t stallCount() const { return m_stallCount; }
+
+    static const char* modeName(Mode mode);
+
+private:
+    GLsizeiptr m_frameSize;
+    uint32_t m_frameCount;
+    Mode m_mode;
+    GLuint m_buffer = 0;
+    // Persistent 模式下整个缓冲的映射地址
+    uint8_t* m_mapped = nullptr;
+    std::vector<GLsync> m_fences;
+    uint32_t m_frame = 0;
+    GLsizeiptr m_head = 0;
+    bool m_inFrame = false;
+    bool m_pendingMap = false;
+    bool m_overflowWarned = false;
+    uint64_t m_stallCount = 0;
+};
+
+
+#endif //RENDERER_STREAMBUFFER_H
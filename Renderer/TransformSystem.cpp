@@ -0,0 +1,171 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "TransformSystem.h"
+#include <cassert>
+#include "Utils/Simd.h"
+
+void TransformSystem::reserve(size_t count) {
+    m_positionX.reserve(count);
+    m_positionY.reserve(count);
+    m_positionZ.reserve(count);
+    m_rotationX.reserve(count);
+    m_rotationY.reserve(count);
+    m_rotationZ.reserve(count);
+    m_rotationW.reserve(count);
+    m_scaleX.reserve(count);
+    m_scaleY.reserve(count);
+    m_scaleZ.reserve(count);
+    m_parent.reserve(count);
+    m_localDirty.reserve(count);
+    m_worldChanged.reserve(count);
+    m_local.reserve(count);
+    m_world.reserve(count);
+}
+
+TransformSystem::Node TransformSystem::create(Node parent, const glm::vec3& position,
+                                              const glm::quat& rotation, const glm::vec3& scale) {
+    // 父节点下标一定比子节点小，update 的线性扫描依赖这一点
+    assert(parent == kNoParent || parent < m_parent.size());
+    Node node = (Node)m_parent.size();
+    m_positionX.push_back(position.x);
+    m_positionY.push_back(position.y);
+    m_positionZ.push_back(position.z);
+    m_rotationX.push_back(rotation.x);
+    m_rotationY.push_back(rotation.y);
+    m_rotationZ.push_back(rotation.z);
+    m_rotationW.push_back(rotation.w);
+    m_scaleX.push_back(scale.x);
+    m_scaleY.push_back(scale.y);
+    m_scaleZ.push_back(scale.z);
+    m_parent.push_back(parent);
+    m_localDirty.push_back(1);
+    m_worldChanged.push_back(0);
+    m_local.emplace_back(1.0f);
+    m_world.emplace_back(1.0f);
+    m_anyDirty = true;
+    return node;
+}
+
+void TransformSystem::markDirty(Node node) {
+    m_localDirty[node] = 1;
+    m_anyDirty = true;
+}
+
+void TransformSystem::setPosition(Node node, const glm::vec3& position) {
+    m_positionX[node] = position.x;
+    m_positionY[node] = position.y;
+    m_positionZ[node] = position.z;
+    markDirty(node);
+}
+
+void TransformSystem::setRotation(Node node, const glm::quat& rotation) {
+    m_rotationX[node] = rotation.x;
+    m_rotationY[node] = rotation.y;
+    m_rotationZ[node] = rotation.z;
+    m_rotationW[node] = rotation.w;
+    markDirty(node);
+}
+
+void TransformSystem::setScale(Node node, const glm::vec3& scale) {
+    m_scaleX[node] = scale.x;
+    m_scaleY[node] = scale.y;
+    m_scaleZ[node] = scale.z;
+    markDirty(node);
+}
+
+// T * R * S，每次合成 4 个节点：每个 lane 一个节点，算出矩阵的 12 个非常量元素后再按列写回
+void TransformSystem::composeLocal(const uint32_t* nodes, size_t count) {
+    const Float4 one = Float4::set1(1.0f);
+    const Float4 two = Float4::set1(2.0f);
+    for (size_t base = 0; base < count; base += 4) {
+        uint32_t lane[4];
+        size_t lanes = count - base < 4 ? count - base : 4;
+        for (size_t i = 0; i < 4; i++) {
+            // 不足 4 个时重复最后一个节点，写回时跳过
+            lane[i] = nodes[base + (i < lanes ? i : lanes - 1)];
+        }
+#define GATHER(array) Float4::set(array[lane[0]], array[lane[1]], array[lane[2]], array[lane[3]])
+        Float4 qx = GATHER(m_rotationX), qy = GATHER(m_rotationY);
+        Float4 qz = GATHER(m_rotationZ), qw = GATHER(m_rotationW);
+        Float4 sx = GATHER(m_scaleX), sy = GATHER(m_scaleY), sz = GATHER(m_scaleZ);
+        Float4 tx = GATHER(m_positionX), ty = GATHER(m_positionY), tz = GATHER(m_positionZ);
+#undef GATHER
+
+        Float4 xx = qx * qx, yy = qy * qy, zz = qz * qz;
+        Float4 xy = qx * qy, xz = qx * qz, yz = qy * qz;
+        Float4 wx = qw * qx, wy = qw * qy, wz = qw * qz;
+
+        // elements[column * 3 + row]
+        float elements[12][4];
+        ((one - two * (yy + zz)) * sx).store(elements[0]);
+        (two * (xy + wz) * sx).store(elements[1]);
+        (two * (xz - wy) * sx).store(elements[2]);
+        (two * (xy - wz) * sy).store(elements[3]);
+        ((one - two * (xx + zz)) * sy).store(elements[4]);
+        (two * (yz + wx) * sy).store(elements[5]);
+        (two * (xz + wy) * sz).store(elements[6]);
+        (two * (yz - wx) * sz).store(elements[7]);
+        ((one - two * (xx + yy)) * sz).store(elements[8]);
+        tx.store(elements[9]);
+        ty.store(elements[10]);
+        tz.store(elements[11]);
+
+        for (size_t i = 0; i < lanes; i++) {
+            float* m = &m_local[lane[i]][0][0];
+            m[0] = elements[0][i];  m[1] = elements[1][i];  m[2] = elements[2][i];  m[3] = 0.0f;
+            m[4] = elements[3][i];  m[5] = elements[4][i];  m[6] = elements[5][i];  m[7] = 0.0f;
+            m[8] = elements[6][i];  m[9] = elements[7][i];  m[10] = elements[8][i]; m[11] = 0.0f;
+            m[12] = elements[9][i]; m[13] = elements[10][i]; m[14] = elements[11][i]; m[15] = 1.0f;
+        }
+    }
+}
+
+// out = a * b，列主序，每列是 a 的 4 列按 b 这一列的分量加权求和
+static inline void multiply(const float* a, const float* b, float* out) {
+    Float4 a0 = Float4::load(a), a1 = Float4::load(a + 4), a2 = Float4::load(a + 8), a3 = Float4::load(a + 12);
+    for (int column = 0; column < 4; column++) {
+        const float* c = b + column * 4;
+        (a0 * Float4::set1(c[0]) + a1 * Float4::set1(c[1]) +
+         a2 * Float4::set1(c[2]) + a3 * Float4::set1(c[3])).store(out + column * 4);
+    }
+}
+
+size_t TransformSystem::update() {
+    if (!m_anyDirty) {
+        return 0;
+    }
+    m_anyDirty = false;
+
+    // 第一遍：收集需要重算的节点。父节点在前，它的 worldChanged 已经是本帧的结果
+    m_composeList.clear();
+    m_updateList.clear();
+    const size_t count = m_parent.size();
+    for (size_t i = 0; i < count; i++) {
+        Node parent = m_parent[i];
+        bool changed = m_localDirty[i] || (parent != kNoParent && m_worldChanged[parent]);
+        m_worldChanged[i] = changed;
+        if (m_localDirty[i]) {
+            m_composeList.push_back((uint32_t)i);
+            m_localDirty[i] = 0;
+        }
+        if (changed) {
+            m_updateList.push_back((uint32_t)i);
+        }
+    }
+
+    // 第二遍：只有自己变过的节点才重新合成局部矩阵，仅祖先变过的复用缓存的局部矩阵
+    composeLocal(m_composeList.data(), m_composeList.size());
+
+    // 第三遍：按拓扑序乘上父节点的世界矩阵
+    for (uint32_t node : m_updateList) {
+        Node parent = m_parent[node];
+        if (parent == kNoParent) {
+            m_world[node] = m_local[node];
+        } else {
+            multiply(&m_world[parent][0][0], &m_local[node][0][0], &m_world[node][0][0]);
+        }
+    }
+    return m_updateList.size();
+}
@@ -0,0 +1,62 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_TRANSFORMSYSTEM_H
+#define RENDERER_TRANSFORMSYSTEM_H
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+// 层级变换，数据按 SoA 连续存放。
+// 父节点必须先于子节点创建，所以下标顺序本身就是拓扑序，update 只需要从前往后扫一遍；
+// set* 只标记 dirty，update 时只重算自己或祖先变过的节点，局部矩阵每 4 个节点一组用 SIMD 合成。
+// 节点创建后父子关系固定，不支持删除和重新挂接。
+class TransformSystem {
+public:
+    using Node = uint32_t;
+    static constexpr Node kNoParent = UINT32_MAX;
+
+    void reserve(size_t count);
+    Node create(Node parent = kNoParent,
+                const glm::vec3& position = glm::vec3(0.0f),
+                const glm::quat& rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                const glm::vec3& scale = glm::vec3(1.0f));
+
+    void setPosition(Node node, const glm::vec3& position);
+    void setRotation(Node node, const glm::quat& rotation);
+    void setScale(Node node, const glm::vec3& scale);
+
+    glm::vec3 position(Node node) const { return {m_positionX[node], m_positionY[node], m_positionZ[node]}; }
+    glm::quat rotation(Node node) const { return {m_rotationW[node], m_rotationX[node], m_rotationY[node], m_rotationZ[node]}; }
+    glm::vec3 scale(Node node) const { return {m_scaleX[node], m_scaleY[node], m_scaleZ[node]}; }
+    Node parent(Node node) const { return m_parent[node]; }
+    size_t size() const { return m_parent.size(); }
+
+    // 重新计算所有受影响节点的世界矩阵，返回重算的数量
+    size_t update();
+    const glm::mat4& world(Node node) const { return m_world[node]; }
+    const glm::mat4* worldMatrices() const { return m_world.data(); }
+
+private:
+    void markDirty(Node node);
+    void composeLocal(const uint32_t* nodes, size_t count);
+
+    std::vector<float> m_positionX, m_positionY, m_positionZ;
+    std::vector<float> m_rotationX, m_rotationY, m_rotationZ, m_rotationW;
+    std::vector<float> m_scaleX, m_scaleY, m_scaleZ;
+    std::vector<Node> m_parent;
+    std::vector<uint8_t> m_localDirty;
+    // update 过程中用来向子节点传播"世界矩阵变了"
+    std::vector<uint8_t> m_worldChanged;
+    std::vector<glm::mat4> m_local;
+    std::vector<glm::mat4> m_world;
+    std::vector<uint32_t> m_composeList;
+    std::vector<uint32_t> m_updateList;
+    bool m_anyDirty = false;
+};
+
+
+#endif //RENDERER_TRANSFORMSYSTEM_H
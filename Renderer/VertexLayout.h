@@ -0,0 +1,150 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_VERTEXLAYOUT_H
+#define RENDERER_VERTEXLAYOUT_H
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+
+// 一个顶点属性在交错顶点里的描述，对应一次 glVertexAttrib(I)Pointer
+struct VertexAttribute {
+    GLuint location;
+    GLint components;
+    GLenum type;
+    GLboolean normalized;
+    size_t offset;
+    bool integer = false;   // true 时用 glVertexAttribIPointer，shader 里是 int/uint
+};
+
+// 在当前绑定的 VAO / GL_ARRAY_BUFFER 上设置并启用这些属性
+inline void applyVertexAttributes(const std::vector<VertexAttribute>& attributes, GLsizei stride, GLuint divisor = 0,
+                                  GLintptr baseOffset = 0) {
+    for (const VertexAttribute& attribute : attributes) {
+        void* pointer = (void*)(baseOffset + (GLintptr)attribute.offset);
+        if (attribute.integer) {
+            glVertexAttribIPointer(attribute.location, attribute.components, attribute.type, stride, pointer);
+        } else {
+            glVertexAttribPointer(attribute.location, attribute.components, attribute.type,
+                                  attribute.normalized, stride, pointer);
+        }
+        glEnableVertexAttribArray(attribute.location);
+        if (divisor != 0) {
+            glVertexAttribDivisor(attribute.location, divisor);
+        }
+    }
+}
+
+// ---- 压缩的顶点分量，构造时从 float 转换，shader 里读到的仍然是 float ----
+
+// 两个 half float，常用于 UV，4 字节
+struct Half2 {
+    uint16_t x = 0, y = 0;
+    Half2() = default;
+    Half2(float u, float v) : x(glm::packHalf1x16(u)), y(glm::packHalf1x16(v)) {}
+};
+
+// [-1, 1] 映射到 int16，常用于位置；w 固定为 1，shader 里可以直接当 vec3/vec4 用，8 字节
+struct Snorm16x4 {
+    int16_t x = 0, y = 0, z = 0, w = 32767;
+    Snorm16x4() = default;
+    explicit Snorm16x4(const glm::vec3& v)
+        : x((int16_t)glm::packSnorm1x16(v.x)), y((int16_t)glm::packSnorm1x16(v.y)), z((int16_t)glm::packSnorm1x16(v.z)) {}
+
+    glm::vec3 unpack() const { return glm::vec3(x, y, z) * (1.0f / 32767.0f); }
+};
+
+// GL_INT_2_10_10_10_REV 打包的单位向量，常用于法线，4 字节
+struct PackedNormal {
+    uint32_t bits = 0;
+    PackedNormal() = default;
+    explicit PackedNormal(const glm::vec3& n) : bits(glm::packSnorm3x10_1x2(glm::vec4(n, 0.0f))) {}
+};
+
+// [0, 1] 映射到 uint8，常用于顶点颜色，4 字节
+struct Unorm8x4 {
+    uint8_t r = 0, g = 0, b = 0, a = 255;
+    Unorm8x4() = default;
+    Unorm8x4(float red, float green, float blue, float alpha = 1.0f)
+        : r(toUnorm8(red)), g(toUnorm8(green)), b(toUnorm8(blue)), a(toUnorm8(alpha)) {}
+
+private:
+    static uint8_t toUnorm8(float f) { return (uint8_t)(glm::clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f); }
+};
+
+// ---- C++ 类型到 GL 顶点格式的映射 ----
+
+template<typename T> struct VertexFormat;
+
+template<GLint Components, GLenum Type, GLboolean Normalized, bool Integer, int Columns = 1>
+struct VertexFormatTraits {
+    static constexpr int columns = Columns;     // 矩阵按列占用连续的几个 location
+    static constexpr GLint components = Components;
+    static constexpr GLenum type = Type;
+    static constexpr GLboolean normalized = Normalized;
+    static constexpr bool integer = Integer;
+};
+
+template<> struct VertexFormat<float> : VertexFormatTraits<1, GL_FLOAT, GL_FALSE, false> {};
+template<> struct VertexFormat<glm::vec2> : VertexFormatTraits<2, GL_FLOAT, GL_FALSE, false> {};
+template<> struct VertexFormat<glm::vec3> : VertexFormatTraits<3, GL_FLOAT, GL_FALSE, false> {};
+template<> struct VertexFormat<glm::vec4> : VertexFormatTraits<4, GL_FLOAT, GL_FALSE, false> {};
+template<> struct VertexFormat<glm::mat4> : VertexFormatTraits<4, GL_FLOAT, GL_FALSE, false, 4> {};
+template<> struct VertexFormat<Half2> : VertexFormatTraits<2, GL_HALF_FLOAT, GL_FALSE, false> {};
+template<> struct VertexFormat<Snorm16x4> : VertexFormatTraits<4, GL_SHORT, GL_TRUE, false> {};
+template<> struct VertexFormat<PackedNormal> : VertexFormatTraits<4, GL_INT_2_10_10_10_REV, GL_TRUE, false> {};
+template<> struct VertexFormat<Unorm8x4> : VertexFormatTraits<4, GL_UNSIGNED_BYTE, GL_TRUE, false> {};
+// 整数 ID，shader 里声明成 int / uint，不经过 float 转换
+template<> struct VertexFormat<int8_t> : VertexFormatTraits<1, GL_BYTE, GL_FALSE, true> {};
+template<> struct VertexFormat<uint8_t> : VertexFormatTraits<1, GL_UNSIGNED_BYTE, GL_FALSE, true> {};
+template<> struct VertexFormat<int16_t> : VertexFormatTraits<1, GL_SHORT, GL_FALSE, true> {};
+template<> struct VertexFormat<uint16_t> : VertexFormatTraits<1, GL_UNSIGNED_SHORT, GL_FALSE, true> {};
+template<> struct VertexFormat<int32_t> : VertexFormatTraits<1, GL_INT, GL_FALSE, true> {};
+template<> struct VertexFormat<uint32_t> : VertexFormatTraits<1, GL_UNSIGNED_INT, GL_FALSE, true> {};
+
+// 一个属性：shader location + 成员类型 + 成员偏移，一般通过 VERTEX_ATTRIB 宏生成
+template<GLuint Location, typename T, size_t Offset>
+struct VertexAttrib {
+    using Format = VertexFormat<T>;
+    static constexpr size_t offset = Offset;
+    static constexpr size_t size = sizeof(T);
+
+    static void describe(std::vector<VertexAttribute>& out) {
+        for (int column = 0; column < Format::columns; column++) {
+            out.push_back({Location + (GLuint)column, Format::components, Format::type, Format::normalized,
+                           Offset + column * (size / Format::columns), Format::integer});
+        }
+    }
+};
+
+#define VERTEX_ATTRIB(location, Vertex, member) \
+    VertexAttrib<location, decltype(Vertex::member), offsetof(Vertex, member)>
+
+// 从顶点结构体声明式地描述顶点格式，stride 和偏移都由编译器算出:
+//   using CubeLayout = VertexLayout<CubeVertex,
+//       VERTEX_ATTRIB(0, CubeVertex, position),
+//       VERTEX_ATTRIB(1, CubeVertex, uv)>;
+//   CubeLayout::apply();
+template<typename Vertex, typename... Attribs>
+struct VertexLayout {
+    static constexpr GLsizei stride = (GLsizei)sizeof(Vertex);
+    static_assert(((Attribs::offset + Attribs::size <= sizeof(Vertex)) && ...), "attribute outside of the vertex");
+    static_assert(((Attribs::offset % 4 == 0) && ...), "attributes should be 4-byte aligned");
+
+    static std::vector<VertexAttribute> attributes() {
+        std::vector<VertexAttribute> result;
+        (Attribs::describe(result), ...);
+        return result;
+    }
+    // divisor 非 0 时作为 per-instance 属性，baseOffset 是数据在当前 GL_ARRAY_BUFFER 中的起始位置
+    static void apply(GLuint divisor = 0, GLintptr baseOffset = 0) {
+        applyVertexAttributes(attributes(), stride, divisor, baseOffset);
+    }
+};
+
+
+#endif //RENDERER_VERTEXLAYOUT_H
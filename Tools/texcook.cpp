@@ -0,0 +1,161 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+/*
+ * Offline texture cooker, no GL context needed.
+ * usage: texcook [--format bc7|bc1] [--output out.ktx2] inputs...
+ * Decodes each input to RGBA8, builds the full mip chain, block-compresses every level
+ * on the thread pool and writes a KTX2 file next to the source (foo.png -> foo.ktx2),
+ * where ImageLoader::loadImage picks it up instead of decoding the png at runtime.
+ * BC7 keeps alpha at 8 bpp; BC1 is 4 bpp and drops alpha.
+ * Prints the VRAM of the RGBA8 mip chain it replaces and the PSNR of level 0.
+ ***/
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Utils/BlockCompression.h"
+#include "Utils/Hash.h"
+#include "Utils/ImageLoader.h"
+#include "Utils/Ktx2.h"
+#include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
+#include "Utils/MipChain.h"
+#include "Utils/ThreadPool.h"
+
+struct CookResult {
+    size_t rgbaBytes = 0;
+    size_t compressedBytes = 0;
+};
+
+static double psnr(const unsigned char* a, const unsigned char* b, size_t pixels, int channels) {
+    double error = 0.0;
+    for (size_t i = 0; i < pixels; i++) {
+        for (int c = 0; c < channels; c++) {
+            double d = (double)a[i * 4 + c] - (double)b[i * 4 + c];
+            error += d * d;
+        }
+    }
+    double mse = error / (double)(pixels * channels);
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+static bool cook(const std::string& input, const std::string& output, BlockCompression::Format format,
+                 CookResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile source;
+    if (!source.open(input)) {
+        printf("%s: failed to open\n", input.c_str());
+        return false;
+    }
+    char sourceHash[17];
+    snprintf(sourceHash, sizeof(sourceHash), "%016llx", (unsigned long long)fnv1aBytes(source.data(), source.size()));
+    DecodedImage decoded = ImageLoader::decode(source.data(), source.size(), 4);
+    if (!decoded.valid()) {
+        printf("%s: failed to decode\n", input.c_str());
+        return false;
+    }
+
+    std::vector<MipLevel> rgbaLevels = MipChain::layout(decoded.width, decoded.height, 4);
+    std::vector<unsigned char> rgba(MipChain::totalSize(rgbaLevels));
+    std::copy(decoded.pixels, decoded.pixels + rgbaLevels[0].size, rgba.begin());
+    MipChain::generate(rgba.data(), rgbaLevels, 4, true, &ThreadPool::shared());
+
+    // 压缩后的每级紧密排列，布局和 RGBA mip 链一一对应
+    Ktx2Texture texture;
+    texture.vkFormat = format == BlockCompression::Format::BC7 ? Ktx2::kFormatBC7Unorm : Ktx2::kFormatBC1RgbUnorm;
+    texture.width = decoded.width;
+    texture.height = decoded.height;
+    size_t offset = 0;
+    for (const MipLevel& rgbaLevel : rgbaLevels) {
+        MipLevel level;
+        level.width = rgbaLevel.width;
+        level.height = rgbaLevel.height;
+        level.offset = offset;
+        level.size = BlockCompression::compressedSize(format, level.width, level.height);
+        texture.levels.push_back(level);
+        offset += level.size;
+    }
+    auto blocks = std::make_shared<std::vector<unsigned char>>(offset);
+    for (size_t i = 0; i < rgbaLevels.size(); i++) {
+        BlockCompression::encode(format, rgba.data() + rgbaLevels[i].offset, rgbaLevels[i].width, rgbaLevels[i].height,
+                                 blocks->data() + texture.levels[i].offset, &ThreadPool::shared());
+    }
+    texture.data = blocks->data();
+    texture.storage = blocks;
+    texture.keyValues = {{"KTXwriter", "texcook"}, {"texcook.sourceHash", sourceHash}};
+    if (!Ktx2::write(output, texture)) {
+        return false;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<unsigned char> roundTrip(rgbaLevels[0].size);
+    BlockCompression::decode(format, blocks->data(), decoded.width, decoded.height, roundTrip.data());
+    int channels = format == BlockCompression::Format::BC7 ? 4 : 3;
+    double quality = psnr(rgba.data(), roundTrip.data(), (size_t)decoded.width * decoded.height, channels);
+
+    result.rgbaBytes = rgba.size();
+    result.compressedBytes = blocks->size();
+    printf("%s -> %s\n", input.c_str(), output.c_str());
+    printf("  %dx%d, %zu levels, %s: RGBA8 %.2f MB -> %.2f MB (%.1f:1, saves %.2f MB VRAM), PSNR %.1f dB, %.1f ms\n",
+           decoded.width, decoded.height, rgbaLevels.size(), BlockCompression::formatName(format),
+           rgba.size() / (1024.0 * 1024.0), blocks->size() / (1024.0 * 1024.0),
+           (double)rgba.size() / (double)blocks->size(), (rgba.size() - blocks->size()) / (1024.0 * 1024.0),
+           quality, ms);
+    return true;
+}
+
+int main(int argc, char *argv[]) {
+    Logger::init();
+    BlockCompression::Format format = BlockCompression::Format::BC7;
+    std::string output;
+    std::vector<std::string> inputs;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "bc7") {
+                format = BlockCompression::Format::BC7;
+            } else if (name == "bc1") {
+                format = BlockCompression::Format::BC1;
+            } else {
+                printf("unknown format %s, expected bc7 or bc1\n", name.c_str());
+                return -1;
+            }
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (!arg.empty() && arg[0] != '-') {
+            inputs.push_back(arg);
+        } else {
+            inputs.clear();
+            break;
+        }
+    }
+    if (inputs.empty() || (!output.empty() && inputs.size() > 1)) {
+        printf("usage: texcook [--format bc7|bc1] [--output out.ktx2] inputs...\n");
+        printf("  --output only works with a single input, default is the input path with a .ktx2 extension\n");
+        return -1;
+    }
+
+    CookResult total;
+    int failed = 0;
+    for (const std::string& input : inputs) {
+        CookResult result;
+        if (!cook(input, output.empty() ? ImageLoader::cookedPath(input) : output, format, result)) {
+            failed++;
+            continue;
+        }
+        total.rgbaBytes += result.rgbaBytes;
+        total.compressedBytes += result.compressedBytes;
+    }
+    if (inputs.size() > 1 && total.compressedBytes > 0) {
+        printf("total: RGBA8 %.2f MB -> %.2f MB, saves %.2f MB VRAM, %d failed\n",
+               total.rgbaBytes / (1024.0 * 1024.0), total.compressedBytes / (1024.0 * 1024.0),
+               (total.rgbaBytes - total.compressedBytes) / (1024.0 * 1024.0), failed);
+    }
+    Logger::shutdown();
+    return failed == 0 ? 0 : 1;
+}
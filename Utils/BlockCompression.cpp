@@ -0,0 +1,520 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "BlockCompression.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "Utils/Simd.h"
+#include "Utils/ThreadPool.h"
+
+namespace {
+    constexpr int kBlockPixels = 16;
+    // 每个并行任务大约编码的块数
+    constexpr int kBlocksPerTask = 1024;
+    // 最小二乘修正的轮数，第一轮用主成分分析的端点
+    constexpr int kRefineIterations = 3;
+
+    // BC1 索引 0..3 对应的插值权重(端点 1 的占比)，索引 2/3 是 1/3、2/3 处的插值色
+    constexpr float kBC1Weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    // BC7 4 位索引的插值权重，单位 1/64
+    constexpr int kBC7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    // 一个 4x4 块，每个像素 RGBA 各一个 float(0-255)
+    struct Block {
+        Float4 pixels[kBlockPixels];
+    };
+
+    float dot(Float4 a, Float4 b) {
+        float v[4];
+        (a * b).store(v);
+        return v[0] + v[1] + v[2] + v[3];
+    }
+
+    Float4 clamp255(Float4 v) {
+        return Float4::min(Float4::max(v, Float4::set1(0.0f)), Float4::set1(255.0f));
+    }
+
+    // 取出 (bx, by) 处的块，超出图片的像素重复边缘；BC1 不编码 alpha，把它置 0 不参与误差
+    void loadBlock(const unsigned char* rgba, int width, int height, int bx, int by, bool keepAlpha, Block& block) {
+        for (int y = 0; y < 4; y++) {
+            int sy = std::min(by * 4 + y, height - 1);
+            for (int x = 0; x < 4; x++) {
+                int sx = std::min(bx * 4 + x, width - 1);
+                const unsigned char* p = rgba + ((size_t)sy * width + sx) * 4;
+                block.pixels[y * 4 + x] = Float4::set(p[0], p[1], p[2], keepAlpha ? p[3] : 0.0f);
+            }
+        }
+    }
+
+    // 块内颜色分布的主轴：协方差矩阵按行累加，再从包围盒对角线开始幂迭代
+    void principalAxis(const Block& block, Float4& mean, Float4& axis) {
+        Float4 sum = Float4::set1(0.0f);
+        Float4 lo = block.pixels[0];
+        Float4 hi = block.pixels[0];
+        for (const Float4& p : block.pixels) {
+            sum = sum + p;
+            lo = Float4::min(lo, p);
+            hi = Float4::max(hi, p);
+        }
+        mean = sum * Float4::set1(1.0f / kBlockPixels);
+
+        Float4 covariance[4] = {Float4::set1(0.0f), Float4::set1(0.0f), Float4::set1(0.0f), Float4::set1(0.0f)};
+        for (const Float4& p : block.pixels) {
+            Float4 d = p - mean;
+            float dv[4];
+            d.store(dv);
+            for (int k = 0; k < 4; k++) {
+                covariance[k] = covariance[k] + d * Float4::set1(dv[k]);
+            }
+        }
+
+        axis = hi - lo;
+        for (int iteration = 0; iteration < 8; iteration++) {
+            float av[4];
+            axis.store(av);
+            Float4 next = covariance[0] * Float4::set1(av[0]) + covariance[1] * Float4::set1(av[1]) +
+                          covariance[2] * Float4::set1(av[2]) + covariance[3] * Float4::set1(av[3]);
+            float nv[4];
+            next.store(nv);
+            float scale = std::max(std::max(std::fabs(nv[0]), std::fabs(nv[1])),
+                                   std::max(std::fabs(nv[2]), std::fabs(nv[3])));
+            // 协方差为 0(纯色块)时保留包围盒对角线
+            if (scale < 1e-6f) {
+                break;
+            }
+            axis = next * Float4::set1(1.0f / scale);
+        }
+    }
+
+    // 所有像素投影到主轴上，两端作为初始端点
+    void initialEndpoints(const Block& block, Float4& e0, Float4& e1) {
+        Float4 mean, axis;
+        principalAxis(block, mean, axis);
+        float length2 = dot(axis, axis);
+        if (length2 < 1e-6f) {
+            e0 = mean;
+            e1 = mean;
+            return;
+        }
+        float tMin = 1e30f;
+        float tMax = -1e30f;
+        for (const Float4& p : block.pixels) {
+            float t = dot(p - mean, axis);
+            tMin = std::min(tMin, t);
+            tMax = std::max(tMax, t);
+        }
+        e0 = clamp255(mean + axis * Float4::set1(tMin / length2));
+        e1 = clamp255(mean + axis * Float4::set1(tMax / length2));
+    }
+
+    // 固定每个像素的插值权重 w(像素 ≈ (1 - w) * e0 + w * e1)，最小二乘解出端点
+    bool fitEndpoints(const Block& block, const float* weights, Float4& e0, Float4& e1) {
+        float a = 0.0f, b = 0.0f, c = 0.0f;
+        Float4 r0 = Float4::set1(0.0f);
+        Float4 r1 = Float4::set1(0.0f);
+        for (int i = 0; i < kBlockPixels; i++) {
+            float w = weights[i];
+            float v = 1.0f - w;
+            a += v * v;
+            b += v * w;
+            c += w * w;
+            r0 = r0 + block.pixels[i] * Float4::set1(v);
+            r1 = r1 + block.pixels[i] * Float4::set1(w);
+        }
+        float det = a * c - b * b;
+        // 所有像素都选了同一个索引，方程退化
+        if (std::fabs(det) < 1e-6f) {
+            return false;
+        }
+        float inverse = 1.0f / det;
+        e0 = clamp255((r0 * Float4::set1(c) - r1 * Float4::set1(b)) * Float4::set1(inverse));
+        e1 = clamp255((r1 * Float4::set1(a) - r0 * Float4::set1(b)) * Float4::set1(inverse));
+        return true;
+    }
+
+    // ---- BC1 ----
+
+    uint16_t packColor565(Float4 color) {
+        float v[4];
+        color.store(v);
+        int r = (int)std::lround(v[0] * 31.0f / 255.0f);
+        int g = (int)std::lround(v[1] * 63.0f / 255.0f);
+        int b = (int)std::lround(v[2] * 31.0f / 255.0f);
+        return (uint16_t)((r << 11) | (g << 5) | b);
+    }
+
+    void unpackColor565(uint16_t color, int rgb[3]) {
+        int r = (color >> 11) & 31;
+        int g = (color >> 5) & 63;
+        int b = color & 31;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    // 和解码端一致的调色板：c0 > c1 时是 4 色模式，否则 3 色 + 透明黑
+    void bc1Palette(uint16_t c0, uint16_t c1, int palette[4][4]) {
+        int a[3], b[3];
+        unpackColor565(c0, a);
+        unpackColor565(c1, b);
+        bool fourColors = c0 > c1;
+        for (int c = 0; c < 3; c++) {
+            palette[0][c] = a[c];
+            palette[1][c] = b[c];
+            palette[2][c] = fourColors ? (2 * a[c] + b[c]) / 3 : (a[c] + b[c]) / 2;
+            palette[3][c] = fourColors ? (a[c] + 2 * b[c]) / 3 : 0;
+        }
+        palette[0][3] = palette[1][3] = palette[2][3] = 255;
+        palette[3][3] = fourColors ? 255 : 0;
+    }
+
+    float bc1Indices(const Block& block, uint16_t c0, uint16_t c1, uint8_t indices[kBlockPixels]) {
+        int palette[4][4];
+        bc1Palette(c0, c1, palette);
+        // 只有 4 色模式会被选中，alpha 不参与误差
+        Float4 colors[4];
+        for (int i = 0; i < 4; i++) {
+            colors[i] = Float4::set((float)palette[i][0], (float)palette[i][1], (float)palette[i][2], 0.0f);
+        }
+        float total = 0.0f;
+        for (int i = 0; i < kBlockPixels; i++) {
+            float best = 1e30f;
+            for (uint8_t j = 0; j < 4; j++) {
+                Float4 d = block.pixels[i] - colors[j];
+                float error = dot(d, d);
+                if (error < best) {
+                    best = error;
+                    indices[i] = j;
+                }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    void encodeBlockBC1(const Block& block, unsigned char* out) {
+        Float4 e0, e1;
+        initialEndpoints(block, e0, e1);
+
+        uint16_t bestC0 = 0, bestC1 = 0;
+        uint8_t bestIndices[kBlockPixels] = {};
+        float bestError = 1e30f;
+        for (int iteration = 0; iteration < kRefineIterations; iteration++) {
+            uint16_t c0 = packColor565(e0);
+            uint16_t c1 = packColor565(e1);
+            // 4 色模式要求 c0 > c1，交换端点能表示的颜色不变
+            if (c0 < c1) {
+                std::swap(c0, c1);
+            }
+            uint8_t indices[kBlockPixels] = {};
+            float error;
+            if (c0 == c1) {
+                // 端点量化后重合，整块用索引 0(两种模式下都是 c0)
+                int rgb[3];
+                unpackColor565(c0, rgb);
+                Float4 color = Float4::set((float)rgb[0], (float)rgb[1], (float)rgb[2], 0.0f);
+                error = 0.0f;
+                for (const Float4& p : block.pixels) {
+                    error += dot(p - color, p - color);
+                }
+            } else {
+                error = bc1Indices(block, c0, c1, indices);
+            }
+            if (error < bestError) {
+                bestError = error;
+                bestC0 = c0;
+                bestC1 = c1;
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+            if (c0 == c1 || error == 0.0f) {
+                break;
+            }
+            // 交换后的端点顺序是 c0(索引 0) -> c1(索引 1)
+            float weights[kBlockPixels];
+            for (int i = 0; i < kBlockPixels; i++) {
+                weights[i] = kBC1Weights[indices[i]];
+            }
+            if (!fitEndpoints(block, weights, e0, e1)) {
+                break;
+            }
+        }
+
+        uint32_t indexBits = 0;
+        for (int i = 0; i < kBlockPixels; i++) {
+            indexBits |= (uint32_t)bestIndices[i] << (i * 2);
+        }
+        out[0] = (unsigned char)(bestC0 & 0xFF);
+        out[1] = (unsigned char)(bestC0 >> 8);
+        out[2] = (unsigned char)(bestC1 & 0xFF);
+        out[3] = (unsigned char)(bestC1 >> 8);
+        for (int i = 0; i < 4; i++) {
+            out[4 + i] = (unsigned char)(indexBits >> (i * 8));
+        }
+    }
+
+    void decodeBlockBC1(const unsigned char* in, unsigned char* pixels) {
+        uint16_t c0 = (uint16_t)(in[0] | (in[1] << 8));
+        uint16_t c1 = (uint16_t)(in[2] | (in[3] << 8));
+        uint32_t indexBits = (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+        int palette[4][4];
+        bc1Palette(c0, c1, palette);
+        for (int i = 0; i < kBlockPixels; i++) {
+            const int* color = palette[(indexBits >> (i * 2)) & 3];
+            for (int c = 0; c < 4; c++) {
+                pixels[i * 4 + c] = (unsigned char)color[c];
+            }
+        }
+    }
+
+    // ---- BC7 mode 6 ----
+
+    // 128 位块按 LSB 在前的顺序逐位写入/读出
+    class BitWriter {
+    public:
+        explicit BitWriter(unsigned char* out) : m_out(out) { std::memset(m_out, 0, 16); }
+        void write(uint32_t value, int bits) {
+            for (int i = 0; i < bits; i++, m_position++) {
+                if ((value >> i) & 1) {
+                    m_out[m_position >> 3] |= (unsigned char)(1 << (m_position & 7));
+                }
+            }
+        }
+    private:
+        unsigned char* m_out;
+        int m_position = 0;
+    };
+
+    class BitReader {
+    public:
+        explicit BitReader(const unsigned char* in) : m_in(in) {}
+        uint32_t read(int bits) {
+            uint32_t value = 0;
+            for (int i = 0; i < bits; i++, m_position++) {
+                value |= (uint32_t)((m_in[m_position >> 3] >> (m_position & 7)) & 1) << i;
+            }
+            return value;
+        }
+    private:
+        const unsigned char* m_in;
+        int m_position = 0;
+    };
+
+    struct BC7Endpoint {
+        int q[4];   // 7 位
+        int pbit;
+        int value(int channel) const { return (q[channel] << 1) | pbit; }
+    };
+
+    // 端点实际值是 (q << 1) | p，两个 p 都试，取误差小的
+    BC7Endpoint quantizeBC7(Float4 endpoint) {
+        float v[4];
+        endpoint.store(v);
+        BC7Endpoint best{};
+        float bestError = 1e30f;
+        for (int p = 0; p < 2; p++) {
+            BC7Endpoint candidate{};
+            candidate.pbit = p;
+            float error = 0.0f;
+            for (int c = 0; c < 4; c++) {
+                candidate.q[c] = std::clamp((int)std::lround((v[c] - (float)p) * 0.5f), 0, 127);
+                float diff = (float)candidate.value(c) - v[c];
+                error += diff * diff;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    void bc7Palette(const BC7Endpoint& e0, const BC7Endpoint& e1, int palette[16][4]) {
+        for (int i = 0; i < 16; i++) {
+            int w = kBC7Weights[i];
+            for (int c = 0; c < 4; c++) {
+                palette[i][c] = ((64 - w) * e0.value(c) + w * e1.value(c) + 32) >> 6;
+            }
+        }
+    }
+
+    // 先按投影位置估计索引，再和相邻的两个比较，不用遍历全部 16 个
+    float bc7Indices(const Block& block, const BC7Endpoint& e0, const BC7Endpoint& e1, uint8_t indices[kBlockPixels]) {
+        int palette[16][4];
+        bc7Palette(e0, e1, palette);
+        Float4 colors[16];
+        for (int i = 0; i < 16; i++) {
+            colors[i] = Float4::set((float)palette[i][0], (float)palette[i][1], (float)palette[i][2], (float)palette[i][3]);
+        }
+        Float4 direction = colors[15] - colors[0];
+        float length2 = dot(direction, direction);
+        float scale = length2 > 0.0f ? 15.0f / length2 : 0.0f;
+
+        float total = 0.0f;
+        for (int i = 0; i < kBlockPixels; i++) {
+            const Float4& p = block.pixels[i];
+            int guess = std::clamp((int)std::lround(dot(p - colors[0], direction) * scale), 0, 15);
+            float best = 1e30f;
+            for (int j = std::max(0, guess - 1); j <= std::min(15, guess + 1); j++) {
+                Float4 d = p - colors[j];
+                float error = dot(d, d);
+                if (error < best) {
+                    best = error;
+                    indices[i] = (uint8_t)j;
+                }
+            }
+            total += best;
+        }
+        return total;
+    }
+
+    void encodeBlockBC7(const Block& block, unsigned char* out) {
+        Float4 e0, e1;
+        initialEndpoints(block, e0, e1);
+
+        BC7Endpoint best0{}, best1{};
+        uint8_t bestIndices[kBlockPixels] = {};
+        float bestError = 1e30f;
+        for (int iteration = 0; iteration < kRefineIterations; iteration++) {
+            BC7Endpoint q0 = quantizeBC7(e0);
+            BC7Endpoint q1 = quantizeBC7(e1);
+            uint8_t indices[kBlockPixels] = {};
+            float error = bc7Indices(block, q0, q1, indices);
+            if (error < bestError) {
+                bestError = error;
+                best0 = q0;
+                best1 = q1;
+                std::memcpy(bestIndices, indices, sizeof(indices));
+            }
+            if (error == 0.0f) {
+                break;
+            }
+            float weights[kBlockPixels];
+            for (int i = 0; i < kBlockPixels; i++) {
+                weights[i] = (float)kBC7Weights[indices[i]] / 64.0f;
+            }
+            if (!fitEndpoints(block, weights, e0, e1)) {
+                break;
+            }
+        }
+
+        // 第 0 个像素(锚点)索引的最高位不存储，必须为 0：否则交换端点并翻转所有索引
+        if (bestIndices[0] & 8) {
+            std::swap(best0, best1);
+            for (uint8_t& index : bestIndices) {
+                index = (uint8_t)(15 - index);
+            }
+        }
+
+        // mode 6：6 个 0 后跟一个 1，然后 RGBA 各两个 7 位端点、两个 p-bit、63 位索引
+        BitWriter writer(out);
+        writer.write(1u << 6, 7);
+        for (int c = 0; c < 4; c++) {
+            writer.write((uint32_t)best0.q[c], 7);
+            writer.write((uint32_t)best1.q[c], 7);
+        }
+        writer.write((uint32_t)best0.pbit, 1);
+        writer.write((uint32_t)best1.pbit, 1);
+        writer.write(bestIndices[0], 3);
+        for (int i = 1; i < kBlockPixels; i++) {
+            writer.write(bestIndices[i], 4);
+        }
+    }
+
+    void decodeBlockBC7(const unsigned char* in, unsigned char* pixels) {
+        BitReader reader(in);
+        if (reader.read(7) != (1u << 6)) {
+            for (int i = 0; i < kBlockPixels; i++) {
+                pixels[i * 4 + 0] = 255;
+                pixels[i * 4 + 1] = 0;
+                pixels[i * 4 + 2] = 255;
+                pixels[i * 4 + 3] = 255;
+            }
+            return;
+        }
+        BC7Endpoint e0{}, e1{};
+        for (int c = 0; c < 4; c++) {
+            e0.q[c] = (int)reader.read(7);
+            e1.q[c] = (int)reader.read(7);
+        }
+        e0.pbit = (int)reader.read(1);
+        e1.pbit = (int)reader.read(1);
+        int palette[16][4];
+        bc7Palette(e0, e1, palette);
+        for (int i = 0; i < kBlockPixels; i++) {
+            uint32_t index = reader.read(i == 0 ? 3 : 4);
+            for (int c = 0; c < 4; c++) {
+                pixels[i * 4 + c] = (unsigned char)palette[index][c];
+            }
+        }
+    }
+}
+
+const char* BlockCompression::formatName(Format format) {
+    switch (format) {
+        case Format::BC1: return "BC1";
+        case Format::BC7: return "BC7";
+    }
+    return "unknown";
+}
+
+size_t BlockCompression::blockSize(Format format) {
+    return format == Format::BC1 ? 8 : 16;
+}
+
+size_t BlockCompression::compressedSize(Format format, int width, int height) {
+    return (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * blockSize(format);
+}
+
+void BlockCompression::encode(Format format, const unsigned char* rgba, int width, int height, unsigned char* out,
+                              ThreadPool* pool) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t bytesPerBlock = blockSize(format);
+    auto encodeRows = [&](size_t begin, size_t end) {
+        Block block;
+        for (size_t by = begin; by < end; by++) {
+            for (int bx = 0; bx < blocksX; bx++) {
+                unsigned char* dst = out + ((size_t)by * blocksX + bx) * bytesPerBlock;
+                if (format == Format::BC1) {
+                    loadBlock(rgba, width, height, bx, (int)by, false, block);
+                    encodeBlockBC1(block, dst);
+                } else {
+                    loadBlock(rgba, width, height, bx, (int)by, true, block);
+                    encodeBlockBC7(block, dst);
+                }
+            }
+        }
+    };
+    size_t rowsPerTask = (size_t)std::max(1, kBlocksPerTask / blocksX);
+    if (pool && (size_t)blocksY > rowsPerTask) {
+        pool->parallelFor((size_t)blocksY, rowsPerTask, encodeRows);
+    } else {
+        encodeRows(0, (size_t)blocksY);
+    }
+}
+
+void BlockCompression::decode(Format format, const unsigned char* blocks, int width, int height, unsigned char* rgba) {
+    const int blocksX = (width + 3) / 4;
+    const int blocksY = (height + 3) / 4;
+    const size_t bytesPerBlock = blockSize(format);
+    unsigned char pixels[kBlockPixels * 4];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++) {
+            const unsigned char* block = blocks + ((size_t)by * blocksX + bx) * bytesPerBlock;
+            if (format == Format::BC1) {
+                decodeBlockBC1(block, pixels);
+            } else {
+                decodeBlockBC7(block, pixels);
+            }
+            // 边缘块只写回图片范围内的像素
+            for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+                for (int x = 0; x < 4 && bx * 4 + x < width; x++) {
+                    std::memcpy(rgba + ((size_t)(by * 4 + y) * width + bx * 4 + x) * 4, pixels + (y * 4 + x) * 4, 4);
+                }
+            }
+        }
+    }
+}
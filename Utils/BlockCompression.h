@@ -0,0 +1,36 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_BLOCKCOMPRESSION_H
+#define RENDERER_BLOCKCOMPRESSION_H
+#include <cstddef>
+
+class ThreadPool;
+
+// BC1 / BC7 块压缩的 CPU 编码器，每个 4x4 像素块独立编码，输入都是紧密排列的 RGBA8。
+//   BC1: 8 字节/块(4 bpp)，两个 565 端点 + 2 位索引，只用不透明的 4 色模式，忽略 alpha
+//   BC7: 16 字节/块(8 bpp)，只用 mode 6：单子集，RGBA 7777 + p-bit 端点，4 位索引，带 alpha
+// 端点先用主成分分析取块内颜色分布的主轴，再按选出的索引做最小二乘修正；
+// 块内的累加和投影用 Utils/Simd.h 的 Float4，一个像素的 RGBA 正好一个向量。
+class BlockCompression {
+public:
+    enum class Format {
+        BC1,
+        BC7,
+    };
+
+    static const char* formatName(Format format);
+    static size_t blockSize(Format format);
+    // 宽高向上对齐到 4 之后的字节数，不足 4 像素的边缘块重复边缘像素
+    static size_t compressedSize(Format format, int width, int height);
+
+    // 编码 width x height 的图片到 out(compressedSize 字节)，pool 不为空时按块行拆到线程池并行
+    static void encode(Format format, const unsigned char* rgba, int width, int height, unsigned char* out,
+                       ThreadPool* pool = nullptr);
+    // 解码回 RGBA8，用来统计压缩误差；BC7 只支持 mode 6，其他 mode 的块解成品红色
+    static void decode(Format format, const unsigned char* blocks, int width, int height, unsigned char* rgba);
+};
+
+
+#endif //RENDERER_BLOCKCOMPRESSION_H
@@ -0,0 +1,175 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "GpuProfiler.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    double nowSeconds() {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+void GpuProfiler::init(double logIntervalSeconds) {
+    // GL_TIMESTAMP 查询从 3.3 开始是核心功能，这里只防御一下 query 位数为 0 的驱动
+    GLint timestampBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &timestampBits);
+    m_enabled = timestampBits > 0;
+    if (!m_enabled) {
+        LOG_WARN("GpuProfiler disabled: GL_TIMESTAMP has no counter bits");
+    }
+    m_logInterval = logIntervalSeconds;
+    m_lastReport = nowSeconds();
+}
+
+void GpuProfiler::destroy() {
+    for (FrameSlot& slot : m_frames) {
+        if (!slot.queries.empty()) {
+            glDeleteQueries((GLsizei)slot.queries.size(), slot.queries.data());
+        }
+        slot.queries.clear();
+        slot.usedQueries = 0;
+        slot.scopes.clear();
+        slot.pending = false;
+    }
+    m_enabled = false;
+}
+
+void GpuProfiler::beginFrame() {
+    if (!m_enabled) {
+        return;
+    }
+    // 复用的这个 slot 是 kFramesInFlight 帧之前提交的，先把它的结果取走
+    FrameSlot& slot = m_frames[m_frameIndex % kFramesInFlight];
+    if (slot.pending) {
+        collect(slot);
+    }
+    slot.usedQueries = 0;
+    slot.scopes.clear();
+    m_depth = 0;
+    m_inFrame = true;
+}
+
+void GpuProfiler::endFrame() {
+    if (!m_enabled || !m_inFrame) {
+        return;
+    }
+    FrameSlot& slot = m_frames[m_frameIndex % kFramesInFlight];
+    slot.pending = !slot.scopes.empty();
+    m_inFrame = false;
+    m_frameIndex++;
+
+    if (m_logInterval > 0.0) {
+        double now = nowSeconds();
+        if (now - m_lastReport >= m_logInterval) {
+            report();
+            m_lastReport = now;
+        }
+    }
+}
+
+int GpuProfiler::beginScope(const char* name) {
+    if (!m_enabled || !m_inFrame) {
+        return -1;
+    }
+    FrameSlot& slot = m_frames[m_frameIndex % kFramesInFlight];
+    ScopeRecord record{name, m_depth, acquireQuery(slot), 0};
+    glQueryCounter(record.beginQuery, GL_TIMESTAMP);
+    slot.scopes.push_back(record);
+    m_depth++;
+    return (int)slot.scopes.size() - 1;
+}
+
+void GpuProfiler::endScope(int scope) {
+    if (scope < 0 || !m_inFrame) {
+        return;
+    }
+    FrameSlot& slot = m_frames[m_frameIndex % kFramesInFlight];
+    ScopeRecord& record = slot.scopes[scope];
+    record.endQuery = acquireQuery(slot);
+    glQueryCounter(record.endQuery, GL_TIMESTAMP);
+    m_depth--;
+}
+
+GLuint GpuProfiler::acquireQuery(FrameSlot& slot) {
+    if (slot.usedQueries == slot.queries.size()) {
+        // 每个 slot 的 query 按需增长，之后每帧复用
+        GLuint query = 0;
+        glGenQueries(1, &query);
+        slot.queries.push_back(query);
+    }
+    return slot.queries[slot.usedQueries++];
+}
+
+void GpuProfiler::collect(FrameSlot& slot) {
+    slot.pending = false;
+    // 命令按顺序完成，最后一个 query 就绪说明整帧的 query 都就绪了
+    GLuint lastQuery = slot.queries[slot.usedQueries - 1];
+    GLint available = 0;
+    glGetQueryObjectiv(lastQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+    if (!available) {
+        m_droppedFrames++;
+        return;
+    }
+    for (const ScopeRecord& record : slot.scopes) {
+        if (record.endQuery == 0) {
+            continue;
+        }
+        GLuint64 begin = 0, end = 0;
+        glGetQueryObjectui64v(record.beginQuery, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(record.endQuery, GL_QUERY_RESULT, &end);
+        double ms = end > begin ? (double)(end - begin) / 1.0e6 : 0.0;
+
+        ScopeStats& stats = statsFor(record.name, record.depth);
+        if (stats.sampleCount == kAverageWindow) {
+            stats.sum -= stats.samples[stats.nextSample];
+        } else {
+            stats.sampleCount++;
+        }
+        stats.samples[stats.nextSample] = ms;
+        stats.nextSample = (stats.nextSample + 1) % kAverageWindow;
+        stats.sum += ms;
+        stats.intervalMax = std::max(stats.intervalMax, ms);
+    }
+}
+
+GpuProfiler::ScopeStats& GpuProfiler::statsFor(const char* name, int depth) {
+    // scope 数量很少，线性查找就够了
+    for (ScopeStats& stats : m_stats) {
+        if (stats.name == name) {
+            return stats;
+        }
+    }
+    ScopeStats& stats = m_stats.emplace_back();
+    stats.name = name;
+    stats.depth = depth;
+    return stats;
+}
+
+double GpuProfiler::averageMs(const char* name) const {
+    for (const ScopeStats& stats : m_stats) {
+        if (stats.name == name) {
+            return stats.sampleCount > 0 ? stats.sum / stats.sampleCount : 0.0;
+        }
+    }
+    return 0.0;
+}
+
+void GpuProfiler::report() {
+    if (m_stats.empty()) {
+        return;
+    }
+    FLOG_INFO("GPU timings (avg of last {} frames), dropped frames = {}", kAverageWindow, m_droppedFrames);
+    for (ScopeStats& stats : m_stats) {
+        if (stats.sampleCount == 0) {
+            continue;
+        }
+        FLOG_INFO("  {:>{}}{:<16} avg {:.3f} ms, max {:.3f} ms", "", stats.depth * 2, stats.name,
+                  stats.sum / stats.sampleCount, stats.intervalMax);
+        stats.intervalMax = 0.0;
+    }
+}
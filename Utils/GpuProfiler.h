@@ -0,0 +1,96 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_GPUPROFILER_H
+#define RENDERER_GPUPROFILER_H
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+
+// 基于 glQueryCounter(GL_TIMESTAMP) 的 GPU 分段计时。
+// 每帧的 query 放在一个 kFramesInFlight 帧的环里，beginFrame 时只回读 kFramesInFlight 帧之前的结果，
+// 那时 GPU 早已执行完，读取不会造成 pipeline stall；结果还没就绪就直接丢掉这一帧，绝不等待。
+// 用法:
+//   profiler.beginFrame();
+//   { GPU_PROFILE_SCOPE(profiler, "clear"); glClear(...); }
+//   profiler.endFrame();
+class GpuProfiler {
+public:
+    static constexpr int kFramesInFlight = 4;
+    // 滚动平均使用的样本数(帧)
+    static constexpr int kAverageWindow = 120;
+
+    // 需要 GL context，logIntervalSeconds 为 0 时不写日志
+    void init(double logIntervalSeconds = 5.0);
+    void destroy();
+
+    void beginFrame();
+    void endFrame();
+
+    // 返回的 index 交给 endScope，支持嵌套
+    int beginScope(const char* name);
+    void endScope(int scope);
+
+    // 最近 kAverageWindow 帧的平均耗时，没有数据时返回 0
+    double averageMs(const char* name) const;
+    bool enabled() const { return m_enabled; }
+
+    class Scope {
+    public:
+        Scope(GpuProfiler& profiler, const char* name) : m_profiler(profiler), m_scope(profiler.beginScope(name)) {}
+        ~Scope() { m_profiler.endScope(m_scope); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+        int m_scope;
+    };
+
+private:
+    struct ScopeRecord {
+        const char* name;
+        int depth;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+
+    struct FrameSlot {
+        std::vector<GLuint> queries;
+        size_t usedQueries = 0;
+        std::vector<ScopeRecord> scopes;
+        bool pending = false;
+    };
+
+    struct ScopeStats {
+        std::string name;
+        int depth = 0;
+        double samples[kAverageWindow] = {};
+        int sampleCount = 0;
+        int nextSample = 0;
+        double sum = 0.0;
+        double intervalMax = 0.0;
+    };
+
+    GLuint acquireQuery(FrameSlot& slot);
+    void collect(FrameSlot& slot);
+    ScopeStats& statsFor(const char* name, int depth);
+    void report();
+
+    FrameSlot m_frames[kFramesInFlight];
+    int m_frameIndex = 0;
+    int m_depth = 0;
+    bool m_enabled = false;
+    bool m_inFrame = false;
+    std::vector<ScopeStats> m_stats;
+    uint64_t m_droppedFrames = 0;
+    double m_logInterval = 0.0;
+    double m_lastReport = 0.0;
+};
+
+#define GPU_PROFILE_CONCAT_INNER(a, b) a##b
+#define GPU_PROFILE_CONCAT(a, b) GPU_PROFILE_CONCAT_INNER(a, b)
+#define GPU_PROFILE_SCOPE(profiler, name) GpuProfiler::Scope GPU_PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, name)
+
+#endif //RENDERER_GPUPROFILER_H
@@ -0,0 +1,33 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_HASH_H
+#define RENDERER_HASH_H
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// FNV-1a 64 位哈希，字符串版本是 constexpr 的，可以在编译期求值；
+// 二进制数据用 fnv1aBytes，分开命名避免 const char* + hash 误匹配到 (data, size) 重载
+constexpr uint64_t kFnvOffsetBasis = 14695981039346656037ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+constexpr uint64_t fnv1a(std::string_view text, uint64_t hash = kFnvOffsetBasis) {
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+inline uint64_t fnv1aBytes(const void* data, size_t size, uint64_t hash = kFnvOffsetBasis) {
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= kFnvPrime;
+    }
+    return hash;
+}
+
+#endif //RENDERER_HASH_H
@@ -0,0 +1,176 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "HeadlessContext.h"
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+#include "Renderer/GLStateCache.h"
+#include "Utils/Logger.h"
+
+namespace {
+    bool hasExtension(const char* extensions, const char* name) {
+        if (!extensions) {
+            return false;
+        }
+        size_t length = strlen(name);
+        for (const char* p = strstr(extensions, name); p; p = strstr(p + length, name)) {
+            if ((p == extensions || p[-1] == ' ') && (p[length] == ' ' || p[length] == '\0')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    EGLDisplay openDisplay(bool& surfaceless) {
+        surfaceless = false;
+        const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+        if (hasExtension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+            auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+            if (getPlatformDisplay) {
+                EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+                if (display != EGL_NO_DISPLAY) {
+                    surfaceless = true;
+                    return display;
+                }
+            }
+        }
+        return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    }
+}
+
+HeadlessContext::~HeadlessContext() {
+    destroy();
+}
+
+bool HeadlessContext::create(int width, int height, int majorVersion, int minorVersion) {
+    m_width = width;
+    m_height = height;
+
+    bool surfacelessPlatform = false;
+    EGLDisplay display = openDisplay(surfacelessPlatform);
+    EGLint major = 0, minor = 0;
+    if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+        LOG_ERROR("EGL init error: 0x{:x}", eglGetError());
+        return false;
+    }
+    m_display = display;
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        LOG_ERROR("EGL does not support desktop OpenGL");
+        destroy();
+        return false;
+    }
+
+    // 有 EGL_KHR_surfaceless_context 时不需要任何 surface，否则创建一个 pbuffer
+    bool surfacelessContext = hasExtension(eglQueryString(display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+    const EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, surfacelessContext ? EGL_DONT_CARE : EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint configCount = 0;
+    if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+        LOG_ERROR("EGL no matching config");
+        destroy();
+        return false;
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, majorVersion,
+        EGL_CONTEXT_MINOR_VERSION, minorVersion,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    m_context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (m_context == EGL_NO_CONTEXT) {
+        m_context = nullptr;
+        LOG_ERROR("EGL create {}.{} core context error: 0x{:x}", majorVersion, minorVersion, eglGetError());
+        destroy();
+        return false;
+    }
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (!surfacelessContext) {
+        const EGLint pbufferAttribs[] = {EGL_WIDTH, width, EGL_HEIGHT, height, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, pbufferAttribs);
+        if (surface == EGL_NO_SURFACE) {
+            LOG_ERROR("EGL create pbuffer error: 0x{:x}", eglGetError());
+            destroy();
+            return false;
+        }
+        m_surface = surface;
+    }
+    if (!eglMakeCurrent(display, surface, surface, (EGLContext)m_context)) {
+        LOG_ERROR("EGL make current error: 0x{:x}", eglGetError());
+        destroy();
+        return false;
+    }
+
+    if (!gladLoadGLLoader((GLADloadproc)eglGetProcAddress)) {
+        LOG_ERROR("GLAD Init Error");
+        destroy();
+        return false;
+    }
+    // 新的 context，之前记录的状态都不再有效
+    GLStateCache::invalidate();
+    LOG_INFO("Headless context ({}): {} | {}", surfacelessPlatform ? "surfaceless" : "pbuffer",
+             (const char*)glGetString(GL_RENDERER), (const char*)glGetString(GL_VERSION));
+    if (!createFramebuffer()) {
+        destroy();
+        return false;
+    }
+    return true;
+}
+
+bool HeadlessContext::createFramebuffer() {
+    glGenFramebuffers(1, &m_fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+
+    glGenRenderbuffers(1, &m_colorBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+
+    glGenRenderbuffers(1, &m_depthBuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, m_width, m_height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    if (status != GL_FRAMEBUFFER_COMPLETE) {
+        LOG_ERROR("Offscreen framebuffer incomplete: 0x{:x}", status);
+        return false;
+    }
+    bindFramebuffer();
+    return true;
+}
+
+void HeadlessContext::bindFramebuffer() const {
+    glBindFramebuffer(GL_FRAMEBUFFER, m_fbo);
+    GLStateCache::viewport(0, 0, m_width, m_height);
+}
+
+void HeadlessContext::destroy() {
+    if (m_context) {
+        if (m_fbo) {
+            glDeleteFramebuffers(1, &m_fbo);
+            glDeleteRenderbuffers(1, &m_colorBuffer);
+            glDeleteRenderbuffers(1, &m_depthBuffer);
+            m_fbo = m_colorBuffer = m_depthBuffer = 0;
+        }
+        eglMakeCurrent((EGLDisplay)m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+        eglDestroyContext((EGLDisplay)m_display, (EGLContext)m_context);
+        m_context = nullptr;
+    }
+    if (m_surface) {
+        eglDestroySurface((EGLDisplay)m_display, (EGLSurface)m_surface);
+        m_surface = nullptr;
+    }
+    if (m_display) {
+        eglTerminate((EGLDisplay)m_display);
+        m_display = nullptr;
+    }
+}
@@ -0,0 +1,42 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_HEADLESSCONTEXT_H
+#define RENDERER_HEADLESSCONTEXT_H
+#include <glad/glad.h>
+
+// 不需要窗口和显示器的 GL context(EGL surfaceless，不支持时退回 pbuffer)，
+// 渲染到离屏 FBO，在没有 GPU 的 Linux 机器上用 Mesa llvmpipe 也能跑。
+class HeadlessContext {
+public:
+    HeadlessContext() = default;
+    ~HeadlessContext();
+    HeadlessContext(const HeadlessContext&) = delete;
+    HeadlessContext& operator=(const HeadlessContext&) = delete;
+
+    bool create(int width, int height, int majorVersion = 3, int minorVersion = 3);
+    void destroy();
+
+    // 绑定离屏 FBO 并设置 viewport
+    void bindFramebuffer() const;
+
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+    GLuint framebuffer() const { return m_fbo; }
+
+private:
+    bool createFramebuffer();
+
+    void* m_display = nullptr;
+    void* m_context = nullptr;
+    void* m_surface = nullptr;
+    GLuint m_fbo = 0;
+    GLuint m_colorBuffer = 0;
+    GLuint m_depthBuffer = 0;
+    int m_width = 0;
+    int m_height = 0;
+};
+
+
+#endif //RENDERER_HEADLESSCONTEXT_H
@@ -5,27 +5,468 @@
 #include "ImageLoader.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include <third_party/stb_image.h>
+#include "Renderer/GLStateCache.h"
+#include "Utils/Hash.h"
+#include "Utils/Ktx2.h"
 #include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
+#include "Utils/Profiler.h"
+#include "Utils/TextureCache.h"
+#include "Utils/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <optional>
 
-GLuint ImageLoader::loadTexture(const char* path) {
-    int width, height, channels;
-    unsigned char* data = stbi_load(path, &width, &height, &channels, 0);
-    if (!data) {
-        LOG_ERROR("Error to load data path = %s", path);
-        return 0;
+// S3TC / BPTC 的内部格式，glad 没有生成对应扩展时自己定义
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_SRGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_SRGB_S3TC_DXT1_EXT 0x8C4C
+#define GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT 0x8C4D
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#define GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM 0x8E8D
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+    // texcook 把源文件的内容哈希写在这个 key 下，用来判断烘焙结果是否过期
+    constexpr const char* kSourceHashKey = "texcook.sourceHash";
+
+    // worker 线程解码完成后把上传任务放进这个队列，由 GL 线程取出执行
+    std::mutex s_uploadMutex;
+    std::deque<std::function<void()>> s_uploadQueue;
+    std::atomic<int> s_pendingLoads{0};
+
+    // 正在按 mip 流式上传的纹理，只在 GL 线程访问
+    struct MipStream {
+        GLenum target = GL_TEXTURE_2D;
+        GLuint texture = 0;
+        std::vector<size_t> levelBytes;
+        std::function<void(size_t level)> uploadLevel;
+        size_t nextLevel = 0;  // 下一个要上传的级别，从粗往细走
+        size_t finestLevel = 0;
+    };
+    std::vector<MipStream> s_streams;
+    // 1080p RGBA 一帧大约 8 MB，默认每帧传半张
+    constexpr size_t kDefaultUploadBudget = 4 * 1024 * 1024;
+    size_t s_uploadBudget = kDefaultUploadBudget;
+    GLuint s_placeholder = 0;
+    GLuint s_placeholderArray = 0;
+}
+
+DecodedImage::~DecodedImage() {
+    if (pixels) {
+        stbi_image_free(pixels);
+    }
+}
+
+DecodedImage::DecodedImage(DecodedImage&& other) noexcept
+    : width(other.width), height(other.height), channels(other.channels), pixels(other.pixels) {
+    other.pixels = nullptr;
+}
+
+DecodedImage& DecodedImage::operator=(DecodedImage&& other) noexcept {
+    if (this != &other) {
+        if (pixels) {
+            stbi_image_free(pixels);
+        }
+        width = other.width;
+        height = other.height;
+        channels = other.channels;
+        pixels = other.pixels;
+        other.pixels = nullptr;
+    }
+    return *this;
+}
+
+namespace {
+    bool isKtx2Path(const std::string& path) {
+        std::string extension = fs::path(path).extension().string();
+        return extension == ".ktx2" || extension == ".KTX2";
+    }
+
+    bool fromKtx2(const Ktx2Texture& texture, const std::string& path, TextureImage& image) {
+        GLenum format = ImageLoader::glFormatForVkFormat(texture.vkFormat);
+        if (!ImageLoader::compressedFormatSupported(format)) {
+            LOG_WARN("{} is not supported by this GL context: {}", Ktx2::formatName(texture.vkFormat), path);
+            return false;
+        }
+        bool opaqueBC1 = texture.vkFormat == Ktx2::kFormatBC1RgbUnorm || texture.vkFormat == Ktx2::kFormatBC1RgbSrgb;
+        image.width = texture.width;
+        image.height = texture.height;
+        image.channels = opaqueBC1 ? 3 : 4;
+        image.levels = texture.levels;
+        image.pixels = texture.data;
+        image.storage = texture.storage;
+        image.compressedFormat = format;
+        return true;
+    }
+
+    void uploadStreamLevel(MipStream& stream) {
+        GLStateCache::bindTexture(stream.target, stream.texture);
+        // mip 的宽度可能是任意值，RGB 行不一定 4 字节对齐
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        stream.uploadLevel(stream.nextLevel);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        // BASE_LEVEL 到 MAX_LEVEL 之间的级别都已定义，纹理保持完整
+        glTexParameteri(stream.target, GL_TEXTURE_BASE_LEVEL, (GLint)stream.nextLevel);
+    }
+
+    // 源文件旁边的 .ktx2：比源文件新就直接用，否则内容哈希和烘焙时一致才用
+    bool loadFreshCooked(const std::string& sourcePath, TextureImage& image) {
+        std::string cookedPath = ImageLoader::cookedPath(sourcePath);
+        std::error_code ec;
+        auto cookedTime = fs::last_write_time(cookedPath, ec);
+        if (ec) {
+            return false;
+        }
+        Ktx2Texture texture;
+        if (!Ktx2::load(cookedPath, texture)) {
+            return false;
+        }
+        auto sourceTime = fs::last_write_time(sourcePath, ec);
+        if (!ec && sourceTime > cookedTime) {
+            MappedFile source;
+            char hash[17];
+            if (source.open(sourcePath)) {
+                snprintf(hash, sizeof(hash), "%016llx", (unsigned long long)fnv1aBytes(source.data(), source.size()));
+            }
+            if (!source.isOpen() || texture.value(kSourceHashKey) != hash) {
+                LOG_WARN("Cooked texture is older than its source, run texcook again: {}", cookedPath);
+                return false;
+            }
+        }
+        return fromKtx2(texture, cookedPath, image);
+    }
+}
+
+GLuint TextureHandle::get() const {
+    if (m_state && m_state->ready) {
+        return m_state->texture;
+    }
+    return ImageLoader::placeholderTexture(m_state ? m_state->target : GL_TEXTURE_2D);
+}
+
+DecodedImage ImageLoader::decode(const unsigned char* bytes, size_t size, int desiredChannels) {
+    DecodedImage image;
+    image.pixels = stbi_load_from_memory(bytes, (int)size, &image.width, &image.height, &image.channels, desiredChannels);
+    if (!image.pixels) {
+        LOG_ERROR("Error to decode image data, reason = {}", stbi_failure_reason());
+        return image;
+    }
+    // stbi_load 返回的 channels 是文件里的通道数，而不是转换后的
+    if (desiredChannels != 0) {
+        image.channels = desiredChannels;
+    }
+    return image;
+}
+
+TextureImage ImageLoader::loadImage(const std::string& path, int desiredChannels, bool allowCooked) {
+    PROFILE_FUNCTION();
+    TextureImage image;
+    if (isKtx2Path(path)) {
+        loadCompressed(path, image);
+        return image;
+    }
+    // 压缩块没有单通道的格式，单通道请求仍然走解码
+    if (allowCooked && desiredChannels != 1 && loadFreshCooked(path, image)) {
+        return image;
     }
+    std::optional<uint64_t> contentHash;
+    if (TextureCache::load(path, desiredChannels, image, &contentHash)) {
+        return image;
+    }
+
+    // 未命中：映射源文件，计算内容哈希后解码
+    MappedFile source;
+    if (!source.open(path)) {
+        LOG_ERROR("Error to open image path = {}", path);
+        return image;
+    }
+    if (!contentHash) {
+        contentHash = fnv1aBytes(source.data(), source.size());
+    }
+    DecodedImage decoded = decode(source.data(), source.size(), desiredChannels);
+    if (!decoded.valid()) {
+        LOG_ERROR("Error to load data path = {}", path);
+        return image;
+    }
+
+    image.width = decoded.width;
+    image.height = decoded.height;
+    image.channels = decoded.channels;
+    image.levels = MipChain::layout(decoded.width, decoded.height, decoded.channels);
+    auto buffer = std::make_shared<std::vector<unsigned char>>(MipChain::totalSize(image.levels));
+    std::memcpy(buffer->data(), decoded.pixels, image.levels[0].size);
+    // 1/2 通道的图在这里一般是遮罩、高度之类的数据，按线性值平均；颜色图按 sRGB 解码后平均
+    MipChain::generate(buffer->data(), image.levels, image.channels, image.channels >= 3);
+    image.pixels = buffer->data();
+    image.storage = buffer;
+
+    TextureCache::store(path, desiredChannels, *contentHash, image);
+    return image;
+}
+
+GLenum ImageLoader::formatForChannels(int channels) {
+    if (channels == 4) return GL_RGBA;
+    if (channels == 1) return GL_RED;
+    return GL_RGB;
+}
 
+void ImageLoader::uploadTextureLevel(const TextureImage& image, size_t i) {
+    const MipLevel& level = image.levels[i];
+    if (image.compressed()) {
+        // 每级都是现成的压缩块，驱动直接拷贝，不需要转换
+        glCompressedTexImage2D(GL_TEXTURE_2D, (GLint)i, image.compressedFormat, level.width, level.height, 0,
+                               (GLsizei)level.size, image.level(i));
+        return;
+    }
+    GLenum format = formatForChannels(image.channels);
+    glTexImage2D(GL_TEXTURE_2D, (GLint)i, format, level.width, level.height, 0,
+                 format, GL_UNSIGNED_BYTE, image.level(i));
+}
+
+GLuint ImageLoader::uploadTexture(const TextureImage& image) {
+    PROFILE_FUNCTION();
     GLuint texture;
     glGenTextures(1, &texture);
-    glBindTexture(GL_TEXTURE_2D, texture);
+    GLStateCache::bindTexture(GL_TEXTURE_2D, texture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t i = 0; i < image.levels.size(); i++) {
+        uploadTextureLevel(image, i);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image.levels.size() - 1);
+    return texture;
+}
 
-    GLenum format = GL_RGB;
-    if (channels == 4) format = GL_RGBA;
-    else if (channels == 1) format = GL_RED;
+bool ImageLoader::loadCompressed(const std::string& path, TextureImage& image) {
+    Ktx2Texture texture;
+    if (!Ktx2::load(path, texture)) {
+        return false;
+    }
+    return fromKtx2(texture, path, image);
+}
 
-    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-    glGenerateMipmap(GL_TEXTURE_2D);
-    // data has copy to GPU AND generate Mipmap
-    stbi_image_free(data);
-    return texture;
-}
\ No newline at end of file
+std::string ImageLoader::cookedPath(const std::string& sourcePath) {
+    return fs::path(sourcePath).replace_extension(".ktx2").string();
+}
+
+bool ImageLoader::compressedFormatSupported(GLenum internalFormat) {
+    bool s3tc = false;
+    bool bptc = false;
+#ifdef GL_EXT_texture_compression_s3tc
+    // 桌面驱动提供 S3TC 时一般也提供 EXT_texture_sRGB，sRGB 变体不再单独判断
+    s3tc = GLAD_GL_EXT_texture_compression_s3tc;
+#endif
+#ifdef GL_VERSION_4_2
+    bptc = bptc || GLAD_GL_VERSION_4_2;
+#endif
+#ifdef GL_ARB_texture_compression_bptc
+    bptc = bptc || GLAD_GL_ARB_texture_compression_bptc;
+#endif
+    switch (internalFormat) {
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT:
+            return s3tc;
+        case GL_COMPRESSED_RGBA_BPTC_UNORM:
+        case GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM:
+            return bptc;
+        default:
+            return false;
+    }
+}
+
+GLenum ImageLoader::glFormatForVkFormat(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case Ktx2::kFormatBC1RgbUnorm: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+        case Ktx2::kFormatBC1RgbSrgb: return GL_COMPRESSED_SRGB_S3TC_DXT1_EXT;
+        case Ktx2::kFormatBC1RgbaUnorm: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+        case Ktx2::kFormatBC1RgbaSrgb: return GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT;
+        case Ktx2::kFormatBC7Unorm: return GL_COMPRESSED_RGBA_BPTC_UNORM;
+        case Ktx2::kFormatBC7Srgb: return GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM;
+        default: return 0;
+    }
+}
+
+GLuint ImageLoader::loadTexture(const char* path) {
+    PROFILE_FUNCTION();
+    TextureImage image = loadImage(path);
+    if (!image.valid()) {
+        return 0;
+    }
+    // 整条 mip 链直接拷贝到 GPU，image 析构时释放内存或解除映射
+    return uploadTexture(image);
+}
+
+TextureHandle ImageLoader::loadTextureAsync(const std::string& path) {
+    TextureHandle handle;
+    handle.m_state = std::make_shared<TextureHandle::State>();
+    handle.m_state->path = path;
+
+    submitAsync([state = handle.m_state]() -> std::function<void()> {
+        auto image = std::make_shared<TextureImage>(loadImage(state->path));
+        return [state, image] {
+            if (image->valid()) {
+                glGenTextures(1, &state->texture);
+                GLStateCache::bindTexture(GL_TEXTURE_2D, state->texture);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)image->levels.size() - 1);
+                std::vector<size_t> levelBytes;
+                for (const MipLevel& level : image->levels) {
+                    levelBytes.push_back(level.size);
+                }
+                streamLevels(GL_TEXTURE_2D, state->texture, std::move(levelBytes),
+                             [image](size_t level) { uploadTextureLevel(*image, level); });
+                state->ready = true;
+            } else {
+                state->failed = true;
+                LOG_ERROR("Async texture load failed, keep placeholder: {}", state->path);
+            }
+        };
+    });
+    return handle;
+}
+
+void ImageLoader::submitAsync(std::function<std::function<void()>()> decodeJob) {
+    s_pendingLoads++;
+    ThreadPool::shared().submit([decodeJob = std::move(decodeJob)] {
+        std::function<void()> upload = decodeJob();
+        if (!upload) {
+            s_pendingLoads--;
+            return;
+        }
+        std::lock_guard<std::mutex> lock(s_uploadMutex);
+        s_uploadQueue.push_back(std::move(upload));
+    });
+}
+
+int ImageLoader::processUploads(int maxUploads) {
+    int uploaded = 0;
+    while (maxUploads < 0 || uploaded < maxUploads) {
+        std::function<void()> upload;
+        {
+            std::lock_guard<std::mutex> lock(s_uploadMutex);
+            if (s_uploadQueue.empty()) {
+                break;
+            }
+            upload = std::move(s_uploadQueue.front());
+            s_uploadQueue.pop_front();
+        }
+        upload();
+        s_pendingLoads--;
+        uploaded++;
+    }
+
+    size_t budget = s_uploadBudget == 0 ? SIZE_MAX : s_uploadBudget;
+    size_t used = 0;
+    while (!s_streams.empty()) {
+        // 所有纹理先补最粗的一级，画面整体一起变清晰，而不是一张传完再传下一张
+        auto coarsest = std::max_element(s_streams.begin(), s_streams.end(),
+                                         [](const MipStream& a, const MipStream& b) { return a.nextLevel < b.nextLevel; });
+        size_t bytes = coarsest->levelBytes[coarsest->nextLevel];
+        if (used > 0 && used + bytes > budget) {
+            break;
+        }
+        uploadStreamLevel(*coarsest);
+        used += bytes;
+        uploaded++;
+        if (coarsest->nextLevel == coarsest->finestLevel) {
+            s_streams.erase(coarsest);
+        } else {
+            coarsest->nextLevel--;
+        }
+    }
+    return uploaded;
+}
+
+bool ImageLoader::hasPendingLoads() {
+    return s_pendingLoads.load() > 0 || !s_streams.empty();
+}
+
+void ImageLoader::setUploadBudget(size_t bytesPerFrame) {
+    s_uploadBudget = bytesPerFrame;
+}
+
+void ImageLoader::streamLevels(GLenum target, GLuint texture, std::vector<size_t> levelBytes,
+                               std::function<void(size_t level)> uploadLevel, size_t finestLevel,
+                               size_t coarsestLevel) {
+    if (levelBytes.empty()) {
+        return;
+    }
+    const size_t smallestLevel = levelBytes.size() - 1;
+    MipStream stream;
+    stream.target = target;
+    stream.texture = texture;
+    stream.levelBytes = std::move(levelBytes);
+    stream.uploadLevel = std::move(uploadLevel);
+    stream.nextLevel = std::min(coarsestLevel, smallestLevel);
+    stream.finestLevel = std::min(finestLevel, stream.nextLevel);
+    if (stream.nextLevel == smallestLevel) {
+        // 最小的一级只有几个字节，不计入预算，保证纹理在这一帧就能用
+        uploadStreamLevel(stream);
+        if (stream.nextLevel == stream.finestLevel) {
+            return;
+        }
+        stream.nextLevel--;
+    }
+    s_streams.push_back(std::move(stream));
+}
+
+bool ImageLoader::trimStream(GLuint texture, size_t finestLevel) {
+    auto it = std::find_if(s_streams.begin(), s_streams.end(),
+                           [texture](const MipStream& stream) { return stream.texture == texture; });
+    if (it == s_streams.end()) {
+        return false;
+    }
+    // nextLevel 还没传，比它粗的都已定义
+    if (finestLevel > it->nextLevel) {
+        s_streams.erase(it);
+        return false;
+    }
+    it->finestLevel = std::max(it->finestLevel, finestLevel);
+    return true;
+}
+
+void ImageLoader::cancelStream(GLuint texture) {
+    s_streams.erase(std::remove_if(s_streams.begin(), s_streams.end(),
+                                   [texture](const MipStream& stream) { return stream.texture == texture; }),
+                    s_streams.end());
+}
+
+GLuint ImageLoader::placeholderTexture(GLenum target) {
+    GLuint& placeholder = target == GL_TEXTURE_2D_ARRAY ? s_placeholderArray : s_placeholder;
+    if (placeholder != 0) {
+        return placeholder;
+    }
+    // 品红/黑色棋盘格，一眼就能看出资源还没加载完
+    const unsigned char pixels[] = {
+        255, 0, 255, 255,   0, 0, 0, 255,
+        0, 0, 0, 255,       255, 0, 255, 255,
+    };
+    glGenTextures(1, &placeholder);
+    GLStateCache::bindTexture(target, placeholder);
+    if (target == GL_TEXTURE_2D_ARRAY) {
+        // 只有一层，采样时超出范围的 layer 会被 clamp 到这一层
+        glTexImage3D(target, 0, GL_RGBA, 2, 2, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    } else {
+        glTexImage2D(target, 0, GL_RGBA, 2, 2, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+    }
+    // 没有 mipmap，默认的 GL_NEAREST_MIPMAP_LINEAR 会让纹理不完整
+    glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    return placeholder;
+}
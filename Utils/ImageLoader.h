@@ -5,11 +5,122 @@
 #ifndef RENDERER_IMAGELOADER_H
 #define RENDERER_IMAGELOADER_H
 #include <glad/glad.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Utils/MipChain.h"
+
+// stb_image 解码出来的像素，析构时自动释放
+struct DecodedImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    unsigned char* pixels = nullptr;
+
+    DecodedImage() = default;
+    ~DecodedImage();
+    DecodedImage(DecodedImage&& other) noexcept;
+    DecodedImage& operator=(DecodedImage&& other) noexcept;
+    DecodedImage(const DecodedImage&) = delete;
+    DecodedImage& operator=(const DecodedImage&) = delete;
+
+    bool valid() const { return pixels != nullptr; }
+};
+
+// 带完整 mip 链的图片，像素来自磁盘缓存的内存映射，或者刚解码并在 CPU 上生成的 mip。
+// compressedFormat 不为 0 时 levels 里是 texcook 烘焙好的压缩块(BC1/BC7)，用 glCompressedTexImage2D 上传
+struct TextureImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<MipLevel> levels;
+    const unsigned char* pixels = nullptr;
+    // 持有 pixels 指向的内存(MappedFile 或堆上的 buffer)
+    std::shared_ptr<void> storage;
+    GLenum compressedFormat = 0;
+
+    bool valid() const { return pixels != nullptr && !levels.empty(); }
+    bool compressed() const { return compressedFormat != 0; }
+    const unsigned char* level(size_t i) const { return pixels + levels[i].offset; }
+};
+
+// 异步加载的纹理句柄。只在 GL 线程上读取，上传完成前 get() 返回占位纹理。
+class TextureHandle {
+public:
+    TextureHandle() = default;
+
+    GLuint get() const;
+    bool isReady() const { return m_state && m_state->ready; }
+    bool isFailed() const { return m_state && m_state->failed; }
+
+private:
+    friend class ImageLoader;
+    friend class TextureArrayBuilder;
+    struct State {
+        std::string path;
+        GLenum target = GL_TEXTURE_2D;
+        GLuint texture = 0;
+        bool ready = false;
+        bool failed = false;
+    };
+    std::shared_ptr<State> m_state;
+};
 
 class ImageLoader {
 public:
     static GLuint loadTexture(const char* path);
+
+    // 在线程池中解码，GL 上传推迟到 processUploads()，mip 从小到大按预算逐帧上传
+    static TextureHandle loadTextureAsync(const std::string& path);
+    // 必须在 GL 线程调用，每帧处理已解码完成的纹理；maxUploads < 0 表示全部处理。
+    // 之后在上传预算内继续流式上传 mip，返回执行的上传任务数加上传的 mip 级数
+    static int processUploads(int maxUploads = -1);
+    // 还有没解码完的纹理或者没传完的 mip 时返回 true，只在 GL 线程调用
+    static bool hasPendingLoads();
+    // 每帧 processUploads() 流式上传 mip 的字节预算，0 表示不限制。至少会传一级，单级超过预算时这一帧只传它
+    static void setUploadBudget(size_t bytesPerFrame);
+    // 必须在 GL 线程调用。texture 的 [finestLevel, coarsestLevel] 各级从粗到细上传，coarsestLevel 默认是最小的一级。
+    // 从最小的一级开始时立即定义它并把 BASE_LEVEL 设到它，纹理马上完整可用；
+    // 更精细的级别在之后的 processUploads() 中按预算上传，每传一级 BASE_LEVEL 就下移一级。
+    // 多个纹理同时流式上传时先补所有纹理中最粗的那一级。uploadLevel(level) 负责定义这一级，调用时已绑定纹理
+    static void streamLevels(GLenum target, GLuint texture, std::vector<size_t> levelBytes,
+                             std::function<void(size_t level)> uploadLevel,
+                             size_t finestLevel = 0, size_t coarsestLevel = SIZE_MAX);
+    // 把 texture 正在进行的流式上传停在 finestLevel，不再上传更精细的级别。
+    // 返回流是否还在进行：finestLevel 及以下都已传完(或者根本没有这个流)时返回 false
+    static bool trimStream(GLuint texture, size_t finestLevel);
+    // 丢弃 texture 还没传完的级别，删除纹理之前必须调用
+    static void cancelStream(GLuint texture);
+    // 在线程池中执行 decodeJob，它返回的上传任务会在 processUploads() 时于 GL 线程执行。
+    // 返回空函数表示没有需要上传的内容。
+    static void submitAsync(std::function<std::function<void()>()> decodeJob);
+
+    // 资源未就绪时使用的 2x2 棋盘格纹理，target 支持 GL_TEXTURE_2D / GL_TEXTURE_2D_ARRAY
+    static GLuint placeholderTexture(GLenum target = GL_TEXTURE_2D);
+
+    // 先查磁盘缓存，未命中时解码并生成 mip 链后写回缓存。可以在 worker 线程调用。
+    // desiredChannels 为 0 时保持文件原有通道数。
+    // allowCooked 时优先使用 texcook 在源文件旁边生成的 .ktx2(内容没过期、GPU 支持它的格式、不是单通道请求)；
+    // 路径本身是 .ktx2 时直接读取
+    static TextureImage loadImage(const std::string& path, int desiredChannels = 0, bool allowCooked = true);
+    static DecodedImage decode(const unsigned char* bytes, size_t size, int desiredChannels = 0);
+    // 逐级上传 mip 链，不再调用 glGenerateMipmap；压缩图片走 glCompressedTexImage2D
+    static GLuint uploadTexture(const TextureImage& image);
+    // 定义当前绑定的 GL_TEXTURE_2D 的第 level 级，调用前 UNPACK_ALIGNMENT 要设为 1
+    static void uploadTextureLevel(const TextureImage& image, size_t level);
+    static GLenum formatForChannels(int channels);
+
+    // 读取 KTX2 文件(内存映射，不拷贝)，格式不受当前 GL 支持时返回 false
+    static bool loadCompressed(const std::string& path, TextureImage& image);
+    // texcook 默认的输出位置：把源文件扩展名换成 .ktx2
+    static std::string cookedPath(const std::string& sourcePath);
+    // 只读 glad 加载时记录的扩展标志，不调用 GL，可以在 worker 线程使用
+    static bool compressedFormatSupported(GLenum internalFormat);
+    // KTX2 的 VkFormat 编号对应的 GL 内部格式，不支持时返回 0
+    static GLenum glFormatForVkFormat(uint32_t vkFormat);
 };
 
 
-#endif //RENDERER_IMAGELOADER_H
\ No newline at end of file
+#endif //RENDERER_IMAGELOADER_H
@@ -0,0 +1,282 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "Json.h"
+#include <cstdint>
+#include <cstdlib>
+
+namespace {
+    const JsonValue s_null;
+}
+
+class JsonParser {
+public:
+    explicit JsonParser(std::string_view text) : m_text(text) {}
+
+    bool parseDocument(JsonValue& out, std::string* error) {
+        bool ok = parseValue(out, 0);
+        skipWhitespace();
+        if (ok && m_pos != m_text.size()) {
+            ok = fail("unexpected trailing characters");
+        }
+        if (!ok && error) {
+            *error = m_error + " at offset " + std::to_string(m_pos);
+        }
+        return ok;
+    }
+
+private:
+    static constexpr int kMaxDepth = 256;
+
+    bool fail(const char* message) {
+        if (m_error.empty()) {
+            m_error = message;
+        }
+        return false;
+    }
+
+    void skipWhitespace() {
+        while (m_pos < m_text.size() &&
+               (m_text[m_pos] == ' ' || m_text[m_pos] == '\t' || m_text[m_pos] == '\n' || m_text[m_pos] == '\r')) {
+            m_pos++;
+        }
+    }
+
+    bool consume(std::string_view literal) {
+        if (m_text.substr(m_pos, literal.size()) != literal) {
+            return false;
+        }
+        m_pos += literal.size();
+        return true;
+    }
+
+    bool parseValue(JsonValue& out, int depth) {
+        if (depth > kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        skipWhitespace();
+        if (m_pos >= m_text.size()) {
+            return fail("unexpected end of input");
+        }
+        char c = m_text[m_pos];
+        if (c == '{') {
+            return parseObject(out, depth);
+        }
+        if (c == '[') {
+            return parseArray(out, depth);
+        }
+        if (c == '"') {
+            out.m_type = JsonValue::Type::String;
+            return parseString(out.m_string);
+        }
+        if (consume("true")) {
+            out.m_type = JsonValue::Type::Bool;
+            out.m_bool = true;
+            return true;
+        }
+        if (consume("false")) {
+            out.m_type = JsonValue::Type::Bool;
+            out.m_bool = false;
+            return true;
+        }
+        if (consume("null")) {
+            out.m_type = JsonValue::Type::Null;
+            return true;
+        }
+        return parseNumber(out);
+    }
+
+    bool parseNumber(JsonValue& out) {
+        size_t start = m_pos;
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos];
+            if ((c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E') {
+                m_pos++;
+            } else {
+                break;
+            }
+        }
+        if (start == m_pos || m_pos - start > 64) {
+            return fail("invalid value");
+        }
+        // 数字很短，拷到栈上补 '\0' 再交给 strtod
+        char buffer[65];
+        m_text.copy(buffer, m_pos - start, start);
+        buffer[m_pos - start] = '\0';
+        char* end = nullptr;
+        out.m_number = strtod(buffer, &end);
+        if (end != buffer + (m_pos - start)) {
+            return fail("invalid number");
+        }
+        out.m_type = JsonValue::Type::Number;
+        return true;
+    }
+
+    static void appendUtf8(std::string& out, uint32_t codepoint) {
+        if (codepoint < 0x80) {
+            out += (char)codepoint;
+        } else if (codepoint < 0x800) {
+            out += (char)(0xC0 | (codepoint >> 6));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        } else if (codepoint < 0x10000) {
+            out += (char)(0xE0 | (codepoint >> 12));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        } else {
+            out += (char)(0xF0 | (codepoint >> 18));
+            out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+            out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+            out += (char)(0x80 | (codepoint & 0x3F));
+        }
+    }
+
+    bool parseHex4(uint32_t& value) {
+        if (m_pos + 4 > m_text.size()) {
+            return fail("truncated unicode escape");
+        }
+        value = 0;
+        for (int i = 0; i < 4; i++) {
+            char c = m_text[m_pos++];
+            value <<= 4;
+            if (c >= '0' && c <= '9') value |= c - '0';
+            else if (c >= 'a' && c <= 'f') value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F') value |= c - 'A' + 10;
+            else return fail("invalid unicode escape");
+        }
+        return true;
+    }
+
+    bool parseString(std::string& out) {
+        m_pos++; // "
+        while (m_pos < m_text.size()) {
+            char c = m_text[m_pos++];
+            if (c == '"') {
+                return true;
+            }
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (m_pos >= m_text.size()) {
+                break;
+            }
+            char escape = m_text[m_pos++];
+            switch (escape) {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    uint32_t codepoint;
+                    if (!parseHex4(codepoint)) {
+                        return false;
+                    }
+                    // UTF-16 代理对
+                    if (codepoint >= 0xD800 && codepoint < 0xDC00 && consume("\\u")) {
+                        uint32_t low;
+                        if (!parseHex4(low)) {
+                            return false;
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    appendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    return fail("invalid escape");
+            }
+        }
+        return fail("unterminated string");
+    }
+
+    bool parseArray(JsonValue& out, int depth) {
+        out.m_type = JsonValue::Type::Array;
+        m_pos++; // [
+        skipWhitespace();
+        if (consume("]")) {
+            return true;
+        }
+        while (true) {
+            out.m_array.emplace_back();
+            if (!parseValue(out.m_array.back(), depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (consume(",")) {
+                continue;
+            }
+            if (consume("]")) {
+                return true;
+            }
+            return fail("expected ',' or ']'");
+        }
+    }
+
+    bool parseObject(JsonValue& out, int depth) {
+        out.m_type = JsonValue::Type::Object;
+        m_pos++; // {
+        skipWhitespace();
+        if (consume("}")) {
+            return true;
+        }
+        while (true) {
+            skipWhitespace();
+            if (m_pos >= m_text.size() || m_text[m_pos] != '"') {
+                return fail("expected object key");
+            }
+            out.m_object.emplace_back();
+            if (!parseString(out.m_object.back().first)) {
+                return false;
+            }
+            skipWhitespace();
+            if (!consume(":")) {
+                return fail("expected ':'");
+            }
+            if (!parseValue(out.m_object.back().second, depth + 1)) {
+                return false;
+            }
+            skipWhitespace();
+            if (consume(",")) {
+                continue;
+            }
+            if (consume("}")) {
+                return true;
+            }
+            return fail("expected ',' or '}'");
+        }
+    }
+
+    std::string_view m_text;
+    size_t m_pos = 0;
+    std::string m_error;
+};
+
+bool JsonValue::parse(std::string_view text, JsonValue& out, std::string* error) {
+    out = JsonValue();
+    JsonParser parser(text);
+    return parser.parseDocument(out, error);
+}
+
+const JsonValue& JsonValue::operator[](size_t index) const {
+    if (m_type != Type::Array || index >= m_array.size()) {
+        return s_null;
+    }
+    return m_array[index];
+}
+
+const JsonValue& JsonValue::operator[](std::string_view key) const {
+    if (m_type != Type::Object) {
+        return s_null;
+    }
+    for (const auto& member : m_object) {
+        if (member.first == key) {
+            return member.second;
+        }
+    }
+    return s_null;
+}
@@ -0,0 +1,59 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_JSON_H
+#define RENDERER_JSON_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// 只读的最小 JSON DOM，用来解析 glTF 这类不大的描述文件。
+// 访问不存在的 key / 下标时返回一个 null 值，取值时传默认值(number(0) 等)，不需要层层判空。
+class JsonValue {
+public:
+    enum class Type {
+        Null,
+        Bool,
+        Number,
+        String,
+        Array,
+        Object,
+    };
+
+    // 解析失败返回 false，error 中给出出错位置
+    static bool parse(std::string_view text, JsonValue& out, std::string* error = nullptr);
+
+    Type type() const { return m_type; }
+    bool isNull() const { return m_type == Type::Null; }
+    bool isNumber() const { return m_type == Type::Number; }
+    bool isString() const { return m_type == Type::String; }
+    bool isArray() const { return m_type == Type::Array; }
+    bool isObject() const { return m_type == Type::Object; }
+
+    double number(double fallback = 0.0) const { return m_type == Type::Number ? m_number : fallback; }
+    bool boolean(bool fallback = false) const { return m_type == Type::Bool ? m_bool : fallback; }
+    const std::string& string() const { return m_string; }
+
+    // 数组或对象的元素个数
+    size_t size() const { return m_type == Type::Array ? m_array.size() : m_type == Type::Object ? m_object.size() : 0; }
+    const JsonValue& operator[](size_t index) const;
+    const JsonValue& operator[](std::string_view key) const;
+    bool has(std::string_view key) const { return !(*this)[key].isNull(); }
+    const std::vector<std::pair<std::string, JsonValue>>& members() const { return m_object; }
+
+private:
+    friend class JsonParser;
+
+    Type m_type = Type::Null;
+    bool m_bool = false;
+    double m_number = 0.0;
+    std::string m_string;
+    std::vector<JsonValue> m_array;
+    std::vector<std::pair<std::string, JsonValue>> m_object;
+};
+
+
+#endif //RENDERER_JSON_H
@@ -0,0 +1,297 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "Ktx2.h"
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr unsigned char kIdentifier[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    struct Ktx2Header {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+    static_assert(sizeof(Ktx2Header) == 80, "KTX2 header is 80 bytes");
+
+    struct Ktx2LevelIndex {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    // Khronos Data Format 描述里用到的常量
+    constexpr uint32_t kDfdModelBC1A = 128;
+    constexpr uint32_t kDfdModelBC7 = 134;
+    constexpr uint32_t kDfdPrimariesBT709 = 1;
+    constexpr uint32_t kDfdTransferLinear = 1;
+    constexpr uint32_t kDfdTransferSrgb = 2;
+    constexpr uint32_t kDfdChannelBC1AAlpha = 1;
+
+    // 块压缩格式的 DFD：一个 basic descriptor block，只有一个覆盖整个块的 sample
+    std::vector<uint32_t> dataFormatDescriptor(uint32_t vkFormat) {
+        bool bc7 = vkFormat == Ktx2::kFormatBC7Unorm || vkFormat == Ktx2::kFormatBC7Srgb;
+        bool bc1Alpha = vkFormat == Ktx2::kFormatBC1RgbaUnorm || vkFormat == Ktx2::kFormatBC1RgbaSrgb;
+        uint32_t blockBytes = Ktx2::blockSize(vkFormat);
+        const uint32_t sampleCount = 1;
+        const uint32_t blockLength = 24 + 16 * sampleCount;
+
+        std::vector<uint32_t> words;
+        words.push_back(4 + blockLength);                      // dfdTotalSize
+        words.push_back(0);                                    // vendorId = Khronos, descriptorType = basic
+        words.push_back(2 | (blockLength << 16));              // versionNumber = 2, descriptorBlockSize
+        words.push_back((bc7 ? kDfdModelBC7 : kDfdModelBC1A) |
+                        (kDfdPrimariesBT709 << 8) |
+                        ((Ktx2::isSrgb(vkFormat) ? kDfdTransferSrgb : kDfdTransferLinear) << 16));
+        words.push_back(3 | (3 << 8));                         // texelBlockDimension 4x4x1x1(存的是减 1 后的值)
+        words.push_back(blockBytes);                           // bytesPlane0
+        words.push_back(0);                                    // bytesPlane4-7
+        // sample: bitOffset 0, bitLength = 整个块，sampleLower/Upper 覆盖全部取值
+        uint32_t channel = bc1Alpha ? kDfdChannelBC1AAlpha : 0;
+        words.push_back((blockBytes * 8 - 1) << 16 | channel << 24);
+        words.push_back(0);
+        words.push_back(0);
+        words.push_back(0xFFFFFFFFu);
+        return words;
+    }
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    void appendU32(std::vector<unsigned char>& bytes, uint32_t value) {
+        unsigned char raw[4];
+        std::memcpy(raw, &value, sizeof(value));
+        bytes.insert(bytes.end(), raw, raw + 4);
+    }
+}
+
+std::string Ktx2Texture::value(const std::string& key) const {
+    for (const auto& keyValue : keyValues) {
+        if (keyValue.first == key) {
+            return keyValue.second;
+        }
+    }
+    return std::string();
+}
+
+uint32_t Ktx2::blockSize(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case kFormatBC1RgbUnorm:
+        case kFormatBC1RgbSrgb:
+        case kFormatBC1RgbaUnorm:
+        case kFormatBC1RgbaSrgb:
+            return 8;
+        case kFormatBC7Unorm:
+        case kFormatBC7Srgb:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+bool Ktx2::isSrgb(uint32_t vkFormat) {
+    return vkFormat == kFormatBC1RgbSrgb || vkFormat == kFormatBC1RgbaSrgb || vkFormat == kFormatBC7Srgb;
+}
+
+const char* Ktx2::formatName(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case kFormatBC1RgbUnorm: return "BC1_RGB_UNORM";
+        case kFormatBC1RgbSrgb: return "BC1_RGB_SRGB";
+        case kFormatBC1RgbaUnorm: return "BC1_RGBA_UNORM";
+        case kFormatBC1RgbaSrgb: return "BC1_RGBA_SRGB";
+        case kFormatBC7Unorm: return "BC7_UNORM";
+        case kFormatBC7Srgb: return "BC7_SRGB";
+        default: return "unknown";
+    }
+}
+
+bool Ktx2::load(const std::string& path, Ktx2Texture& texture) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(path)) {
+        LOG_ERROR("Ktx2: failed to open {}", path);
+        return false;
+    }
+    if (file->size() < sizeof(Ktx2Header)) {
+        LOG_ERROR("Ktx2: file too small: {}", path);
+        return false;
+    }
+    Ktx2Header header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.identifier, kIdentifier, sizeof(kIdentifier)) != 0) {
+        LOG_ERROR("Ktx2: not a KTX2 file: {}", path);
+        return false;
+    }
+    uint32_t blockBytes = blockSize(header.vkFormat);
+    if (blockBytes == 0) {
+        LOG_ERROR("Ktx2: unsupported vkFormat {}: {}", header.vkFormat, path);
+        return false;
+    }
+    if (header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount > 1 ||
+        header.faceCount != 1 || header.pixelWidth == 0 || header.pixelHeight == 0) {
+        LOG_ERROR("Ktx2: only uncompressed single 2D textures are supported: {}", path);
+        return false;
+    }
+
+    // levelCount 为 0 表示让加载方生成 mip，文件里只有一级
+    uint32_t levelCount = std::max(1u, header.levelCount);
+    size_t indexEnd = sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex);
+    if (indexEnd > file->size()) {
+        LOG_ERROR("Ktx2: truncated level index: {}", path);
+        return false;
+    }
+    std::vector<MipLevel> levels(levelCount);
+    for (uint32_t i = 0; i < levelCount; i++) {
+        Ktx2LevelIndex entry;
+        std::memcpy(&entry, file->data() + sizeof(Ktx2Header) + i * sizeof(Ktx2LevelIndex), sizeof(entry));
+        int width = std::max(1, (int)(header.pixelWidth >> i));
+        int height = std::max(1, (int)(header.pixelHeight >> i));
+        size_t expected = (size_t)((width + 3) / 4) * (size_t)((height + 3) / 4) * blockBytes;
+        if (entry.byteLength != expected || entry.byteOffset + entry.byteLength > file->size()) {
+            LOG_ERROR("Ktx2: level {} is corrupted: {}", i, path);
+            return false;
+        }
+        levels[i] = {width, height, (size_t)entry.byteOffset, (size_t)entry.byteLength};
+    }
+
+    // key/value 数据：每项是 u32 长度 + "key\0value"，按 4 字节对齐
+    texture.keyValues.clear();
+    if (header.kvdByteLength > 0 && (size_t)header.kvdByteOffset + header.kvdByteLength <= file->size()) {
+        const unsigned char* kvd = file->data() + header.kvdByteOffset;
+        size_t position = 0;
+        while (position + 4 <= header.kvdByteLength) {
+            uint32_t length;
+            std::memcpy(&length, kvd + position, sizeof(length));
+            position += 4;
+            if (length == 0 || position + length > header.kvdByteLength) {
+                break;
+            }
+            const char* entry = reinterpret_cast<const char*>(kvd + position);
+            size_t keyLength = strnlen(entry, length);
+            if (keyLength < length) {
+                std::string value(entry + keyLength + 1, length - keyLength - 1);
+                if (!value.empty() && value.back() == '\0') {
+                    value.pop_back();
+                }
+                texture.keyValues.emplace_back(std::string(entry, keyLength), value);
+            }
+            position = alignUp(position + length, 4);
+        }
+    }
+
+    texture.vkFormat = header.vkFormat;
+    texture.width = (int)header.pixelWidth;
+    texture.height = (int)header.pixelHeight;
+    texture.levels = std::move(levels);
+    texture.data = file->data();
+    texture.storage = file;
+    return true;
+}
+
+bool Ktx2::write(const std::string& path, const Ktx2Texture& texture) {
+    uint32_t blockBytes = blockSize(texture.vkFormat);
+    if (!texture.valid() || blockBytes == 0) {
+        LOG_ERROR("Ktx2: nothing to write or unsupported vkFormat {}: {}", texture.vkFormat, path);
+        return false;
+    }
+    const uint32_t levelCount = (uint32_t)texture.levels.size();
+
+    Ktx2Header header{};
+    std::memcpy(header.identifier, kIdentifier, sizeof(kIdentifier));
+    header.vkFormat = texture.vkFormat;
+    header.typeSize = 1;
+    header.pixelWidth = (uint32_t)texture.width;
+    header.pixelHeight = (uint32_t)texture.height;
+    header.faceCount = 1;
+    header.levelCount = levelCount;
+
+    size_t offset = sizeof(Ktx2Header) + levelCount * sizeof(Ktx2LevelIndex);
+    std::vector<uint32_t> dfd = dataFormatDescriptor(texture.vkFormat);
+    header.dfdByteOffset = (uint32_t)offset;
+    header.dfdByteLength = (uint32_t)(dfd.size() * sizeof(uint32_t));
+    offset += header.dfdByteLength;
+
+    // 规范要求 key 按字节序排列
+    auto keyValues = texture.keyValues;
+    std::sort(keyValues.begin(), keyValues.end());
+    std::vector<unsigned char> kvd;
+    for (const auto& [key, value] : keyValues) {
+        appendU32(kvd, (uint32_t)(key.size() + 1 + value.size() + 1));
+        kvd.insert(kvd.end(), key.begin(), key.end());
+        kvd.push_back(0);
+        kvd.insert(kvd.end(), value.begin(), value.end());
+        kvd.push_back(0);
+        kvd.resize(alignUp(kvd.size(), 4), 0);
+    }
+    if (!kvd.empty()) {
+        header.kvdByteOffset = (uint32_t)offset;
+        header.kvdByteLength = (uint32_t)kvd.size();
+        offset += kvd.size();
+    }
+
+    // 最小的 mip 放在最前面，每级按块大小对齐
+    std::vector<Ktx2LevelIndex> index(levelCount);
+    for (uint32_t i = levelCount; i-- > 0;) {
+        offset = alignUp(offset, blockBytes);
+        index[i] = {offset, texture.levels[i].size, texture.levels[i].size};
+        offset += texture.levels[i].size;
+    }
+
+    fs::path tempPath = path;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    std::error_code ec;
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_ERROR("Ktx2: failed to write {}", tempPath.string());
+            return false;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.data()), (std::streamsize)(index.size() * sizeof(Ktx2LevelIndex)));
+        out.write(reinterpret_cast<const char*>(dfd.data()), (std::streamsize)(dfd.size() * sizeof(uint32_t)));
+        out.write(reinterpret_cast<const char*>(kvd.data()), (std::streamsize)kvd.size());
+        size_t written = sizeof(header) + index.size() * sizeof(Ktx2LevelIndex) + dfd.size() * sizeof(uint32_t) + kvd.size();
+        const char padding[16] = {};
+        for (uint32_t i = levelCount; i-- > 0;) {
+            out.write(padding, (std::streamsize)(index[i].byteOffset - written));
+            const MipLevel& level = texture.levels[i];
+            out.write(reinterpret_cast<const char*>(texture.data + level.offset), (std::streamsize)level.size);
+            written = index[i].byteOffset + level.size;
+        }
+        if (!out) {
+            LOG_ERROR("Ktx2: failed to write {}", tempPath.string());
+            out.close();
+            fs::remove(tempPath, ec);
+            return false;
+        }
+    }
+    fs::rename(tempPath, path, ec);
+    if (ec) {
+        LOG_ERROR("Ktx2: failed to write {}, {}", path, ec.message());
+        fs::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,54 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_KTX2_H
+#define RENDERER_KTX2_H
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+#include "Utils/MipChain.h"
+
+// 一张带 mip 链的 2D 块压缩纹理，levels[0] 是最大的一级，offset 相对于 data
+struct Ktx2Texture {
+    uint32_t vkFormat = 0;
+    int width = 0;
+    int height = 0;
+    std::vector<MipLevel> levels;
+    const unsigned char* data = nullptr;
+    // 持有 data 指向的内存(读取时是文件的内存映射)
+    std::shared_ptr<void> storage;
+    // key/value 元数据，例如 KTXwriter
+    std::vector<std::pair<std::string, std::string>> keyValues;
+
+    bool valid() const { return data != nullptr && !levels.empty(); }
+    // 没有这个 key 时返回空字符串
+    std::string value(const std::string& key) const;
+};
+
+// KTX 2.0 容器的最小实现：只处理单层、单面的 2D 纹理，不支持 supercompression。
+// 格式用 VkFormat 编号记录，目前支持 BC1 / BC7 的 UNORM 和 sRGB 变体。
+// 读取时直接映射文件，各级 mip 原地交给 glCompressedTexImage2D，不做拷贝。
+class Ktx2 {
+public:
+    static constexpr uint32_t kFormatBC1RgbUnorm = 131;
+    static constexpr uint32_t kFormatBC1RgbSrgb = 132;
+    static constexpr uint32_t kFormatBC1RgbaUnorm = 133;
+    static constexpr uint32_t kFormatBC1RgbaSrgb = 134;
+    static constexpr uint32_t kFormatBC7Unorm = 145;
+    static constexpr uint32_t kFormatBC7Srgb = 146;
+
+    static bool load(const std::string& path, Ktx2Texture& texture);
+    // 先写临时文件再 rename；文件里按规范从最小的 mip 开始存放
+    static bool write(const std::string& path, const Ktx2Texture& texture);
+
+    // 每个 4x4 块的字节数，不支持的格式返回 0
+    static uint32_t blockSize(uint32_t vkFormat);
+    static bool isSrgb(uint32_t vkFormat);
+    static const char* formatName(uint32_t vkFormat);
+};
+
+
+#endif //RENDERER_KTX2_H
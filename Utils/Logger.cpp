@@ -2,18 +2,32 @@
 // Created by liqiang on 2025/9/2.
 //
 
-#include "Logger.h"
 #include "Logger.h"
 #include "spdlog/sinks/rotating_file_sink.h"
 #include <iostream>
 #include <filesystem>
 
+// 线程池要比 logger 先构造，静态析构时 logger 先释放，线程池最后把队列写完
+std::shared_ptr<spdlog::details::thread_pool> Logger::s_threadPool;
 std::shared_ptr<spdlog::logger> Logger::s_consoleLogger;
 std::shared_ptr<spdlog::logger> Logger::s_fileLogger;
+std::atomic<spdlog::logger*> Logger::s_activeConsole{nullptr};
+std::atomic<spdlog::logger*> Logger::s_activeFile{nullptr};
+
+spdlog::logger* Logger::fallbackLogger() {
+    // 故意不释放：静态析构期间其他线程仍可能通过它写日志
+    static spdlog::logger* s_fallback = [] {
+        auto logger = new spdlog::logger("fallback", std::make_shared<spdlog::sinks::stderr_color_sink_mt>());
+        logger->set_level(spdlog::level::trace);
+        logger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%^%l%$] %v");
+        return logger;
+    }();
+    return s_fallback;
+}
 
-void Logger::init() {
+void Logger::init(const LoggerOptions& options) {
     // 避免重复初始化
-    if (s_consoleLogger) {
+    if (s_activeConsole.load()) {
         return;
     }
 
@@ -29,8 +43,24 @@ void Logger::init() {
             "logs/file.log", 1024*1024*5, 3);
 
         // 手动创建logger (避免自动注册冲突)
-        s_consoleLogger = std::make_shared<spdlog::logger>("console", console_sink);
-        s_fileLogger = std::make_shared<spdlog::logger>("file", file_sink);
+        if (options.async) {
+            // 格式化和写 sink 都放到后台线程，调用线程只把消息放进有界队列
+            s_threadPool = std::make_shared<spdlog::details::thread_pool>(options.queueSize, 1);
+#if SPDLOG_VERSION >= 11500
+            auto policy = options.overflowPolicy == LogOverflowPolicy::Block
+                ? spdlog::async_overflow_policy::block
+                : spdlog::async_overflow_policy::discard_new;
+#else
+            auto policy = options.overflowPolicy == LogOverflowPolicy::Block
+                ? spdlog::async_overflow_policy::block
+                : spdlog::async_overflow_policy::overrun_oldest;
+#endif
+            s_consoleLogger = std::make_shared<spdlog::async_logger>("console", console_sink, s_threadPool, policy);
+            s_fileLogger = std::make_shared<spdlog::async_logger>("file", file_sink, s_threadPool, policy);
+        } else {
+            s_consoleLogger = std::make_shared<spdlog::logger>("console", console_sink);
+            s_fileLogger = std::make_shared<spdlog::logger>("file", file_sink);
+        }
 
         // 配置
         s_consoleLogger->set_level(spdlog::level::trace);
@@ -38,14 +68,47 @@ void Logger::init() {
 
         s_fileLogger->set_level(spdlog::level::info);
         s_fileLogger->set_pattern("[%Y-%m-%d %H:%M:%S.%e] [%l] [%t] %v");
+        s_fileLogger->flush_on(spdlog::level::err);
 
         // 注册到spdlog
         spdlog::register_logger(s_consoleLogger);
         spdlog::register_logger(s_fileLogger);
 
         spdlog::set_default_logger(s_consoleLogger);
+        s_activeConsole.store(s_consoleLogger.get(), std::memory_order_release);
+        s_activeFile.store(s_fileLogger.get(), std::memory_order_release);
 
     } catch (const spdlog::spdlog_ex& ex) {
         std::cerr << "Logger initialization failed: " << ex.what() << std::endl;
     }
-}
\ No newline at end of file
+}
+
+void Logger::shutdown() {
+    if (!s_activeConsole.load()) {
+        return;
+    }
+    // 先切到兜底 logger，之后的日志不再进异步队列
+    s_activeConsole.store(nullptr, std::memory_order_release);
+    s_activeFile.store(nullptr, std::memory_order_release);
+    s_consoleLogger->flush();
+    s_fileLogger->flush();
+    uint64_t dropped = droppedMessages();
+    if (dropped > 0) {
+        std::cerr << "Logger dropped " << dropped << " messages because the queue was full" << std::endl;
+    }
+    spdlog::drop_all();
+    // 最后一个引用释放时线程池会处理完队列里的消息再 join。
+    // logger 本身留到静态析构，切换前刚取到它的线程还能安全调用(线程池已停止时 spdlog 只会报错，不会崩溃)
+    s_threadPool.reset();
+}
+
+uint64_t Logger::droppedMessages() {
+    if (!s_threadPool) {
+        return 0;
+    }
+#if SPDLOG_VERSION >= 11500
+    return s_threadPool->overrun_counter() + s_threadPool->discard_counter();
+#else
+    return s_threadPool->overrun_counter();
+#endif
+}
@@ -5,29 +5,98 @@
 #ifndef RENDERER_LOGGER_H
 #define RENDERER_LOGGER_H
 #pragma once
+// 编译期日志等级，低于这个等级的 LOG_* 直接被预处理掉，参数也不会求值。
+// 一般由 CMake 按构建类型定义，这里只是兜底
+#ifndef SPDLOG_ACTIVE_LEVEL
+#define SPDLOG_ACTIVE_LEVEL SPDLOG_LEVEL_TRACE
+#endif
 #include "spdlog/spdlog.h"
+#include "spdlog/async.h"
 #include "spdlog/sinks/stdout_color_sinks.h"
 #include "spdlog/sinks/basic_file_sink.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 
+// 异步模式下队列满了之后的处理方式
+enum class LogOverflowPolicy {
+    Block,  // 调用线程等待后台线程腾出位置，不丢日志
+    Drop,   // 直接丢弃并计数，调用线程不会被阻塞
+};
+
+struct LoggerOptions {
+    bool async = true;
+    size_t queueSize = 8192;
+    LogOverflowPolicy overflowPolicy = LogOverflowPolicy::Block;
+};
+
 class Logger {
 public:
-    static void init();
-    static std::shared_ptr<spdlog::logger>& getConsoleLogger() { return s_consoleLogger; }
-    static std::shared_ptr<spdlog::logger>& getFileLogger() { return s_fileLogger; }
+    static void init(const LoggerOptions& options = LoggerOptions());
+    // 把队列中剩下的日志写完并停止后台线程。之后的 LOG_* (例如静态析构时线程池里还没跑完的任务)
+    // 改为同步写到 stderr，不会访问空指针
+    static void shutdown();
+    // 因队列已满被丢弃的日志条数
+    static uint64_t droppedMessages();
+    // 不会返回空指针：init 之前和 shutdown 之后返回同步写 stderr 的兜底 logger
+    static spdlog::logger* getConsoleLogger() {
+        spdlog::logger* logger = s_activeConsole.load(std::memory_order_acquire);
+        return logger ? logger : fallbackLogger();
+    }
+    static spdlog::logger* getFileLogger() {
+        spdlog::logger* logger = s_activeFile.load(std::memory_order_acquire);
+        return logger ? logger : fallbackLogger();
+    }
 
 private:
+    static spdlog::logger* fallbackLogger();
+
+    static std::shared_ptr<spdlog::details::thread_pool> s_threadPool;
+    // shutdown 之后仍然持有，其他线程可能刚取到指针还在使用，静态析构时才释放
     static std::shared_ptr<spdlog::logger> s_consoleLogger;
     static std::shared_ptr<spdlog::logger> s_fileLogger;
+    // LOG_* 实际使用的 logger，init 之前和 shutdown 之后为空
+    static std::atomic<spdlog::logger*> s_activeConsole;
+    static std::atomic<spdlog::logger*> s_activeFile;
 };
 
-#define LOG_TRACE(...)    Logger::getConsoleLogger()->trace(__VA_ARGS__)
-#define LOG_INFO(...)     Logger::getConsoleLogger()->info(__VA_ARGS__)
-#define LOG_WARN(...)     Logger::getConsoleLogger()->warn(__VA_ARGS__)
-#define LOG_ERROR(...)    Logger::getConsoleLogger()->error(__VA_ARGS__)
-#define LOG_CRITICAL(...) Logger::getConsoleLogger()->critical(__VA_ARGS__)
+// 运行期等级不够时也不会对参数求值；格式串在编译期由 fmt 检查
+#define RENDERER_LOG_CALL(logger, level, ...) \
+    do { \
+        if ((logger)->should_log(level)) { \
+            SPDLOG_LOGGER_CALL(logger, level, __VA_ARGS__); \
+        } \
+    } while (0)
 
-#define FLOG_INFO(...)    Logger::getFileLogger()->info(__VA_ARGS__)
-#define FLOG_ERROR(...)   Logger::getFileLogger()->error(__VA_ARGS__)
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_TRACE
+#define LOG_TRACE(...)    RENDERER_LOG_CALL(Logger::getConsoleLogger(), spdlog::level::trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(...)    (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_INFO
+#define LOG_INFO(...)     RENDERER_LOG_CALL(Logger::getConsoleLogger(), spdlog::level::info, __VA_ARGS__)
+#define FLOG_INFO(...)    RENDERER_LOG_CALL(Logger::getFileLogger(), spdlog::level::info, __VA_ARGS__)
+#else
+#define LOG_INFO(...)     (void)0
+#define FLOG_INFO(...)    (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_WARN
+#define LOG_WARN(...)     RENDERER_LOG_CALL(Logger::getConsoleLogger(), spdlog::level::warn, __VA_ARGS__)
+#else
+#define LOG_WARN(...)     (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_ERROR
+#define LOG_ERROR(...)    RENDERER_LOG_CALL(Logger::getConsoleLogger(), spdlog::level::err, __VA_ARGS__)
+#define FLOG_ERROR(...)   RENDERER_LOG_CALL(Logger::getFileLogger(), spdlog::level::err, __VA_ARGS__)
+#else
+#define LOG_ERROR(...)    (void)0
+#define FLOG_ERROR(...)   (void)0
+#endif
+#if SPDLOG_ACTIVE_LEVEL <= SPDLOG_LEVEL_CRITICAL
+#define LOG_CRITICAL(...) RENDERER_LOG_CALL(Logger::getConsoleLogger(), spdlog::level::critical, __VA_ARGS__)
+#else
+#define LOG_CRITICAL(...) (void)0
+#endif
 
-#endif //RENDERER_LOGGER_H
\ No newline at end of file
+#endif //RENDERER_LOGGER_H
@@ -0,0 +1,37 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_MAPPEDFILE_H
+#define RENDERER_MAPPEDFILE_H
+#include <cstddef>
+#include <string>
+
+// 只读内存映射文件，析构时自动解除映射
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return m_open; }
+    const unsigned char* data() const { return static_cast<const unsigned char*>(m_data); }
+    size_t size() const { return m_size; }
+
+private:
+    void* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_open = false;
+#ifdef _WIN32
+    void* m_mapping = nullptr;
+#endif
+};
+
+
+#endif //RENDERER_MAPPEDFILE_H
@@ -0,0 +1,131 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "MipChain.h"
+#include <algorithm>
+#include <cmath>
+#include "Utils/Simd.h"
+#include "Utils/ThreadPool.h"
+
+namespace {
+    // 线性值量化成 sRGB 字节的查找表精度；16384 级时最暗一级 sRGB(≈0.0003) 也能区分
+    constexpr int kLinearSteps = 16384;
+    constexpr size_t kParallelPixels = 256 * 256;
+    constexpr size_t kRowsPerTask = 32;
+
+    struct Tables {
+        float srgbToLinear[256];
+        unsigned char linearToSrgb[kLinearSteps];
+    };
+
+    const Tables& conversionTables() {
+        static const Tables tables = [] {
+            Tables t;
+            for (int i = 0; i < 256; i++) {
+                float c = i / 255.0f;
+                t.srgbToLinear[i] = c <= 0.04045f ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+            }
+            for (int i = 0; i < kLinearSteps; i++) {
+                float l = (float)i / (kLinearSteps - 1);
+                float c = l <= 0.0031308f ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+                t.linearToSrgb[i] = (unsigned char)std::clamp((int)(c * 255.0f + 0.5f), 0, 255);
+            }
+            return t;
+        }();
+        return tables;
+    }
+}
+
+std::vector<MipLevel> MipChain::layout(int width, int height, int channels) {
+    std::vector<MipLevel> levels;
+    size_t offset = 0;
+    while (true) {
+        MipLevel level;
+        level.width = width;
+        level.height = height;
+        level.offset = offset;
+        level.size = (size_t)width * height * channels;
+        levels.push_back(level);
+        offset += level.size;
+        if (width == 1 && height == 1) {
+            break;
+        }
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+    return levels;
+}
+
+size_t MipChain::totalSize(const std::vector<MipLevel>& levels) {
+    return levels.empty() ? 0 : levels.back().offset + levels.back().size;
+}
+
+void MipChain::generate(unsigned char* data, const std::vector<MipLevel>& levels, int channels, bool srgb,
+                        ThreadPool* pool) {
+    if (levels.size() < 2 || channels < 1 || channels > 4) {
+        return;
+    }
+    const Tables& tables = conversionTables();
+    // 每个通道用哪张表解码/编码：只有颜色通道走 sRGB，2 通道的第二个和 4 通道的第四个是 alpha
+    bool srgbChannel[4] = {};
+    for (int c = 0; c < channels; c++) {
+        bool alpha = (channels == 2 && c == 1) || (channels == 4 && c == 3);
+        srgbChannel[c] = srgb && !alpha;
+    }
+
+    // level 0 解码到 float，之后每级由上一级的 float 结果下采样，两块缓冲交替使用
+    std::vector<float> source((size_t)levels[0].width * levels[0].height * 4);
+    std::vector<float> target((size_t)levels[1].width * levels[1].height * 4);
+    {
+        const unsigned char* src = data + levels[0].offset;
+        const size_t pixelCount = (size_t)levels[0].width * levels[0].height;
+        for (size_t i = 0; i < pixelCount; i++) {
+            for (int c = 0; c < channels; c++) {
+                unsigned char value = src[i * channels + c];
+                source[i * 4 + c] = srgbChannel[c] ? tables.srgbToLinear[value] : value * (1.0f / 255.0f);
+            }
+        }
+    }
+
+    for (size_t i = 1; i < levels.size(); i++) {
+        const MipLevel& srcLevel = levels[i - 1];
+        const MipLevel& dstLevel = levels[i];
+        unsigned char* dst = data + dstLevel.offset;
+        const float* src = source.data();
+        float* out = target.data();
+
+        auto downsampleRows = [&](size_t begin, size_t end) {
+            const Float4 quarter = Float4::set1(0.25f);
+            for (int y = (int)begin; y < (int)end; y++) {
+                // 奇数尺寸时最后一行/列没有配对的像素，重复使用边缘像素
+                const int y0 = std::min(y * 2, srcLevel.height - 1);
+                const int y1 = std::min(y * 2 + 1, srcLevel.height - 1);
+                const float* row0 = src + (size_t)y0 * srcLevel.width * 4;
+                const float* row1 = src + (size_t)y1 * srcLevel.width * 4;
+                float* outRow = out + (size_t)y * dstLevel.width * 4;
+                unsigned char* dstRow = dst + (size_t)y * dstLevel.width * channels;
+                for (int x = 0; x < dstLevel.width; x++) {
+                    const int x0 = std::min(x * 2, srcLevel.width - 1) * 4;
+                    const int x1 = std::min(x * 2 + 1, srcLevel.width - 1) * 4;
+                    Float4 sum = Float4::load(row0 + x0) + Float4::load(row0 + x1) +
+                                 Float4::load(row1 + x0) + Float4::load(row1 + x1);
+                    (sum * quarter).store(outRow + x * 4);
+                    for (int c = 0; c < channels; c++) {
+                        float value = std::clamp(outRow[x * 4 + c], 0.0f, 1.0f);
+                        dstRow[x * channels + c] = srgbChannel[c]
+                            ? tables.linearToSrgb[(int)(value * (kLinearSteps - 1) + 0.5f)]
+                            : (unsigned char)(value * 255.0f + 0.5f);
+                    }
+                }
+            }
+        };
+        // 小的级别拆分反而更慢，只并行较大的几级
+        if (pool && (size_t)dstLevel.width * dstLevel.height >= kParallelPixels) {
+            pool->parallelFor((size_t)dstLevel.height, kRowsPerTask, downsampleRows);
+        } else {
+            downsampleRows(0, (size_t)dstLevel.height);
+        }
+        std::swap(source, target);
+    }
+}
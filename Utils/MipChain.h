@@ -0,0 +1,34 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_MIPCHAIN_H
+#define RENDERER_MIPCHAIN_H
+#include <cstddef>
+#include <vector>
+
+struct MipLevel {
+    int width = 0;
+    int height = 0;
+    size_t offset = 0;  // 相对于整条 mip 链起始地址的偏移
+    size_t size = 0;
+};
+
+class ThreadPool;
+
+// 在 CPU 上生成完整的 mip 链，结果可以直接缓存到磁盘并逐级上传，省掉 glGenerateMipmap
+class MipChain {
+public:
+    // 计算从 level 0 到 1x1 的所有级别在一块连续内存中的布局
+    static std::vector<MipLevel> layout(int width, int height, int channels);
+    static size_t totalSize(const std::vector<MipLevel>& levels);
+    // data 中 level 0 已经填好，按 levels 依次 2x2 盒式下采样出后续各级。
+    // 下采样在线性空间的 float 上进行(每个像素一个 Float4)，各级都从上一级的 float 结果算出，只在写回时量化一次；
+    // srgb 时颜色通道先按 sRGB 解码、平均后再编码回去，避免暗部被平均得偏暗，alpha 始终按线性处理。
+    // pool 不为空时每级按行拆到线程池，不要在池内的任务里传入
+    static void generate(unsigned char* data, const std::vector<MipLevel>& levels, int channels, bool srgb = true,
+                         ThreadPool* pool = nullptr);
+};
+
+
+#endif //RENDERER_MIPCHAIN_H
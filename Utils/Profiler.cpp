@@ -0,0 +1,105 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "Profiler.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+thread_local Profiler::ThreadBuffer* Profiler::s_threadBuffer = nullptr;
+
+namespace {
+    struct CollectedEvent {
+        Profiler::Event event;
+        uint32_t threadId;
+    };
+
+    // 线程退出后缓冲区仍然保留，保证 collect 时指针有效
+    std::mutex s_registryMutex;
+    std::vector<std::unique_ptr<Profiler::ThreadBuffer>> s_buffers;
+    std::vector<CollectedEvent> s_collected;
+
+    void writeEscaped(FILE* file, const std::string& text) {
+        for (char c : text) {
+            if (c == '"' || c == '\\') {
+                fputc('\\', file);
+            }
+            fputc(c, file);
+        }
+    }
+}
+
+Profiler::ThreadBuffer* Profiler::registerThread() {
+    // 每个线程只在第一次记录时进来一次
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    auto buffer = std::make_unique<ThreadBuffer>();
+    buffer->threadId = (uint32_t)s_buffers.size() + 1;
+    buffer->threadName = "thread " + std::to_string(buffer->threadId);
+    s_threadBuffer = buffer.get();
+    s_buffers.push_back(std::move(buffer));
+    return s_threadBuffer;
+}
+
+void Profiler::setThreadName(const std::string& name) {
+    ThreadBuffer* buffer = s_threadBuffer ? s_threadBuffer : registerThread();
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    buffer->threadName = name;
+}
+
+void Profiler::collect() {
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    for (auto& buffer : s_buffers) {
+        uint32_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint32_t head = buffer->head.load(std::memory_order_acquire);
+        for (; tail != head; tail++) {
+            s_collected.push_back({buffer->events[tail & (kBufferCapacity - 1)], buffer->threadId});
+        }
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+}
+
+bool Profiler::writeTrace(const std::string& path) {
+    collect();
+    std::lock_guard<std::mutex> lock(s_registryMutex);
+    FILE* file = fopen(path.c_str(), "w");
+    if (!file) {
+        LOG_ERROR("Profiler: failed to open trace file {}", path);
+        return false;
+    }
+
+    uint64_t origin = UINT64_MAX;
+    for (const CollectedEvent& collected : s_collected) {
+        origin = std::min(origin, collected.event.beginNs);
+    }
+
+    fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", file);
+    bool first = true;
+    uint64_t dropped = 0;
+    for (auto& buffer : s_buffers) {
+        dropped += buffer->dropped.load(std::memory_order_relaxed);
+        fprintf(file, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"",
+                first ? "" : ",\n", buffer->threadId);
+        writeEscaped(file, buffer->threadName);
+        fputs("\"}}", file);
+        first = false;
+    }
+    // ts/dur 的单位是微秒
+    for (const CollectedEvent& collected : s_collected) {
+        const Event& event = collected.event;
+        fprintf(file, "%s{\"name\":\"", first ? "" : ",\n");
+        writeEscaped(file, event.name);
+        fprintf(file, "\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f}",
+                collected.threadId, (double)(event.beginNs - origin) / 1000.0,
+                (double)(event.endNs - event.beginNs) / 1000.0);
+        first = false;
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+
+    LOG_INFO("Profiler: wrote {} events to {}, dropped = {}", s_collected.size(), path, dropped);
+    return true;
+}
@@ -0,0 +1,99 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_PROFILER_H
+#define RENDERER_PROFILER_H
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+// CPU 分段计时，导出 Chrome/Perfetto 的 trace_event JSON (chrome://tracing 或 ui.perfetto.dev 打开)。
+// 每个线程有自己的单生产者环形缓冲区，记录一个 zone 只是两次取时间 + 一次写入，不加锁；
+// 缓冲区满了就丢弃并计数，collect/writeTrace 在任意线程把所有缓冲区取空。
+// 一直运行的程序要在主循环里定期 PROFILE_COLLECT()，否则缓冲区几秒就满，trace 里只剩开头一段。
+// CMake 选项 RENDERER_PROFILER 关闭时(默认) PROFILE_* 宏展开为空，没有任何开销。
+class Profiler {
+public:
+    struct Event {
+        const char* name;     // 必须是字面量或静态字符串，只保存指针
+        uint64_t beginNs;
+        uint64_t endNs;
+    };
+
+    // 每个线程缓冲区能容纳的事件数，必须是 2 的幂
+    static constexpr uint32_t kBufferCapacity = 1u << 14;
+
+    struct ThreadBuffer {
+        Event events[kBufferCapacity];
+        std::atomic<uint32_t> head{0};   // 只有所属线程写
+        std::atomic<uint32_t> tail{0};   // 只有 collect 写
+        std::atomic<uint64_t> dropped{0};
+        uint32_t threadId = 0;
+        std::string threadName;
+    };
+
+    static uint64_t nowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    static void record(const char* name, uint64_t beginNs, uint64_t endNs)
+    {
+        ThreadBuffer* buffer = s_threadBuffer ? s_threadBuffer : registerThread();
+        uint32_t head = buffer->head.load(std::memory_order_relaxed);
+        uint32_t tail = buffer->tail.load(std::memory_order_acquire);
+        if (head - tail >= kBufferCapacity) {
+            buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        buffer->events[head & (kBufferCapacity - 1)] = {name, beginNs, endNs};
+        buffer->head.store(head + 1, std::memory_order_release);
+    }
+
+    // 在 trace 里显示的线程名，在线程里调用
+    static void setThreadName(const std::string& name);
+    // 把所有线程缓冲区里的事件搬到内存中，长时间运行时定期调用可以避免丢事件
+    static void collect();
+    // collect 后把目前为止的全部事件写成 JSON 文件
+    static bool writeTrace(const std::string& path);
+
+private:
+    static ThreadBuffer* registerThread();
+
+    static thread_local ThreadBuffer* s_threadBuffer;
+};
+
+// 作用域结束时记录一个 zone
+class ProfileZone {
+public:
+    explicit ProfileZone(const char* name) : m_name(name), m_begin(Profiler::nowNs()) {}
+    ~ProfileZone() { Profiler::record(m_name, m_begin, Profiler::nowNs()); }
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_name;
+    uint64_t m_begin;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#if RENDERER_PROFILE
+#define PROFILE_SCOPE(name)       ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION()        PROFILE_SCOPE(__func__)
+#define PROFILE_THREAD(name)      Profiler::setThreadName(name)
+#define PROFILE_WRITE_TRACE(path) Profiler::writeTrace(path)
+#define PROFILE_COLLECT()         Profiler::collect()
+#else
+#define PROFILE_SCOPE(name)       ((void)0)
+#define PROFILE_FUNCTION()        ((void)0)
+#define PROFILE_THREAD(name)      ((void)0)
+#define PROFILE_WRITE_TRACE(path) ((void)0)
+#define PROFILE_COLLECT()         ((void)0)
+#endif
+
+#endif //RENDERER_PROFILER_H
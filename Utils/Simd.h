@@ -0,0 +1,59 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_SIMD_H
+#define RENDERER_SIMD_H
+
+// 4 个 float 的最小封装：x86 上是 SSE，arm64 上是 NEON，其余平台退回标量。
+// 只提供批量数学需要的几个运算，算法写一遍就能在各个平台向量化。
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define RENDERER_SIMD_SSE 1
+#include <immintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define RENDERER_SIMD_NEON 1
+#include <arm_neon.h>
+#endif
+
+struct Float4 {
+#if defined(RENDERER_SIMD_SSE)
+    __m128 v;
+    static Float4 load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static Float4 set1(float f) { return {_mm_set1_ps(f)}; }
+    static Float4 set(float a, float b, float c, float d) { return {_mm_setr_ps(a, b, c, d)}; }
+    void store(float* p) const { _mm_storeu_ps(p, v); }
+    friend Float4 operator+(Float4 a, Float4 b) { return {_mm_add_ps(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+    static Float4 min(Float4 a, Float4 b) { return {_mm_min_ps(a.v, b.v)}; }
+    static Float4 max(Float4 a, Float4 b) { return {_mm_max_ps(a.v, b.v)}; }
+#elif defined(RENDERER_SIMD_NEON)
+    float32x4_t v;
+    static Float4 load(const float* p) { return {vld1q_f32(p)}; }
+    static Float4 set1(float f) { return {vdupq_n_f32(f)}; }
+    static Float4 set(float a, float b, float c, float d)
+    {
+        const float values[4] = {a, b, c, d};
+        return {vld1q_f32(values)};
+    }
+    void store(float* p) const { vst1q_f32(p, v); }
+    friend Float4 operator+(Float4 a, Float4 b) { return {vaddq_f32(a.v, b.v)}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {vsubq_f32(a.v, b.v)}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {vmulq_f32(a.v, b.v)}; }
+    static Float4 min(Float4 a, Float4 b) { return {vminq_f32(a.v, b.v)}; }
+    static Float4 max(Float4 a, Float4 b) { return {vmaxq_f32(a.v, b.v)}; }
+#else
+    float v[4];
+    static Float4 load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+    static Float4 set1(float f) { return {{f, f, f, f}}; }
+    static Float4 set(float a, float b, float c, float d) { return {{a, b, c, d}}; }
+    void store(float* p) const { for (int i = 0; i < 4; i++) p[i] = v[i]; }
+    friend Float4 operator+(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+    friend Float4 operator-(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+    friend Float4 operator*(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+    static Float4 min(Float4 a, Float4 b) { return {{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1], a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}}; }
+    static Float4 max(Float4 a, Float4 b) { return {{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1], a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}}; }
+#endif
+};
+
+#endif //RENDERER_SIMD_H
@@ -0,0 +1,183 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "TextureArrayBuilder.h"
+#include "Renderer/GLStateCache.h"
+#include "Utils/Logger.h"
+#include "Utils/ThreadPool.h"
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+
+namespace {
+    // 所有层统一解码成 RGBA，避免不同图片通道数不一致；烘焙过的层直接用压缩块
+    constexpr int kArrayChannels = 4;
+
+    struct ArrayDecodeState {
+        std::vector<std::string> paths;
+        std::vector<TextureImage> layers;
+        std::atomic<size_t> remaining{0};
+    };
+
+    // 一个纹理数组只能有一种内部格式：各层的烘焙格式不一致(或有的层没烘焙)时，压缩层改为重新解码成 RGBA。
+    // 直接指定 .ktx2 的层没有源图可解码，仍然是压缩的，upload() 会报错
+    void unifyLayerFormats(std::vector<TextureImage>& layers, const std::vector<std::string>& paths) {
+        bool mixed = false;
+        for (const TextureImage& layer : layers) {
+            mixed = mixed || layer.compressedFormat != layers[0].compressedFormat;
+        }
+        if (!mixed) {
+            return;
+        }
+        for (size_t i = 0; i < layers.size(); i++) {
+            if (layers[i].compressed()) {
+                LOG_WARN("TextureArrayBuilder: layer formats differ, decoding layer {} uncompressed: {}", i, paths[i]);
+                layers[i] = ImageLoader::loadImage(paths[i], kArrayChannels, false);
+            }
+        }
+    }
+}
+
+TextureArrayBuilder& TextureArrayBuilder::addLayer(const std::string& path) {
+    m_paths.push_back(path);
+    return *this;
+}
+
+GLuint TextureArrayBuilder::build() const {
+    std::vector<TextureImage> layers(m_paths.size());
+    std::mutex mutex;
+    std::condition_variable done;
+    size_t remaining = m_paths.size();
+
+    for (size_t i = 0; i < m_paths.size(); i++) {
+        ThreadPool::shared().submit([&, i] {
+            TextureImage image = ImageLoader::loadImage(m_paths[i], kArrayChannels);
+            std::lock_guard<std::mutex> lock(mutex);
+            layers[i] = std::move(image);
+            if (--remaining == 0) {
+                done.notify_one();
+            }
+        });
+    }
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [&] { return remaining == 0; });
+    unifyLayerFormats(layers, m_paths);
+    return upload(layers, m_paths);
+}
+
+TextureHandle TextureArrayBuilder::buildAsync() const {
+    TextureHandle handle;
+    handle.m_state = std::make_shared<TextureHandle::State>();
+    handle.m_state->path = m_paths.empty() ? std::string() : m_paths.front();
+    handle.m_state->target = GL_TEXTURE_2D_ARRAY;
+
+    auto decodeState = std::make_shared<ArrayDecodeState>();
+    decodeState->paths = m_paths;
+    decodeState->layers.resize(m_paths.size());
+    decodeState->remaining = m_paths.size();
+
+    // 每层一个解码任务并行执行，最后完成的那个负责提交上传
+    for (size_t i = 0; i < m_paths.size(); i++) {
+        ImageLoader::submitAsync([state = handle.m_state, decodeState, i]() -> std::function<void()> {
+            decodeState->layers[i] = ImageLoader::loadImage(decodeState->paths[i], kArrayChannels);
+            if (--decodeState->remaining != 0) {
+                return {};
+            }
+            unifyLayerFormats(decodeState->layers, decodeState->paths);
+            return [state, decodeState] {
+                state->texture = createTexture(decodeState->layers, decodeState->paths);
+                state->ready = state->texture != 0;
+                state->failed = !state->ready;
+                if (!state->ready) {
+                    decodeState->layers.clear();
+                    return;
+                }
+                // 从最小的 mip 开始逐帧上传，最后一级上传完后 lambda 被释放，像素内存随之释放
+                std::vector<size_t> levelBytes;
+                for (const MipLevel& level : decodeState->layers[0].levels) {
+                    levelBytes.push_back(level.size * decodeState->layers.size());
+                }
+                ImageLoader::streamLevels(GL_TEXTURE_2D_ARRAY, state->texture, std::move(levelBytes),
+                                          [decodeState](size_t level) { uploadLevel(decodeState->layers, level); });
+            };
+        });
+    }
+    return handle;
+}
+
+GLuint TextureArrayBuilder::createTexture(const std::vector<TextureImage>& layers, const std::vector<std::string>& paths) {
+    if (layers.empty()) {
+        LOG_ERROR("TextureArrayBuilder: no layers to build");
+        return 0;
+    }
+    GLint maxLayers = 0;
+    glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+    if ((GLint)layers.size() > maxLayers) {
+        LOG_ERROR("TextureArrayBuilder: {} layers exceeds GL_MAX_ARRAY_TEXTURE_LAYERS = {}", layers.size(), maxLayers);
+        return 0;
+    }
+
+    const int width = layers[0].width;
+    const int height = layers[0].height;
+    for (size_t i = 0; i < layers.size(); i++) {
+        if (!layers[i].valid()) {
+            LOG_ERROR("TextureArrayBuilder: failed to decode layer {}: {}", i, paths[i]);
+            return 0;
+        }
+        if (layers[i].compressedFormat != layers[0].compressedFormat) {
+            LOG_ERROR("TextureArrayBuilder: layer {} format 0x{:x} differs from layer 0 format 0x{:x}: {}",
+                      i, layers[i].compressedFormat, layers[0].compressedFormat, paths[i]);
+            return 0;
+        }
+        if (layers[i].width != width || layers[i].height != height) {
+            LOG_ERROR("TextureArrayBuilder: layer {} is {}x{}, expected {}x{}: {}",
+                      i, layers[i].width, layers[i].height, width, height, paths[i]);
+            return 0;
+        }
+    }
+
+    // 尺寸一致时各层的 mip 链布局也一致
+    GLuint texture;
+    glGenTextures(1, &texture);
+    GLStateCache::bindTexture(GL_TEXTURE_2D_ARRAY, texture);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, (GLint)layers[0].levels.size() - 1);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return texture;
+}
+
+void TextureArrayBuilder::uploadLevel(const std::vector<TextureImage>& layers, size_t level) {
+    const MipLevel& mip = layers[0].levels[level];
+    const GLenum compressedFormat = layers[0].compressedFormat;
+    if (compressedFormat != 0) {
+        GLsizei levelSize = (GLsizei)mip.size;
+        glCompressedTexImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, compressedFormat, mip.width, mip.height,
+                               (GLsizei)layers.size(), 0, levelSize * (GLsizei)layers.size(), nullptr);
+        for (size_t i = 0; i < layers.size(); i++) {
+            glCompressedTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, 0, 0, (GLint)i, mip.width, mip.height, 1,
+                                      compressedFormat, levelSize, layers[i].level(level));
+        }
+        return;
+    }
+    glTexImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, GL_RGBA, mip.width, mip.height, (GLsizei)layers.size(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    for (size_t i = 0; i < layers.size(); i++) {
+        glTexSubImage3D(GL_TEXTURE_2D_ARRAY, (GLint)level, 0, 0, (GLint)i, mip.width, mip.height, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, layers[i].level(level));
+    }
+}
+
+GLuint TextureArrayBuilder::upload(const std::vector<TextureImage>& layers, const std::vector<std::string>& paths) {
+    GLuint texture = createTexture(layers, paths);
+    if (texture == 0) {
+        return 0;
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    for (size_t level = 0; level < layers[0].levels.size(); level++) {
+        uploadLevel(layers, level);
+    }
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    return texture;
+}
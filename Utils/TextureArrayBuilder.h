@@ -0,0 +1,36 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_TEXTUREARRAYBUILDER_H
+#define RENDERER_TEXTUREARRAYBUILDER_H
+#include <glad/glad.h>
+#include <string>
+#include <vector>
+#include "Utils/ImageLoader.h"
+
+// 把多张同尺寸的图片打包进一个 GL_TEXTURE_2D_ARRAY，每层带各自的 mip 链。
+// shader 里用 sampler2DArray + layer 采样，一个材质只需要绑定一次纹理，
+// 也不再受 16 个纹理单元的限制。
+class TextureArrayBuilder {
+public:
+    TextureArrayBuilder& addLayer(const std::string& path);
+    size_t layerCount() const { return m_paths.size(); }
+
+    // 并行解码所有层后在当前(GL)线程上传，失败返回 0
+    GLuint build() const;
+    // 解码在线程池中进行，上传由 ImageLoader::processUploads() 完成：先上传最小的 mip，精细的级别按每帧预算逐步补上
+    TextureHandle buildAsync() const;
+
+private:
+    // 检查各层尺寸和格式一致后创建纹理对象，还没有定义任何一级
+    static GLuint createTexture(const std::vector<TextureImage>& layers, const std::vector<std::string>& paths);
+    // 定义第 level 级并上传所有层
+    static void uploadLevel(const std::vector<TextureImage>& layers, size_t level);
+    static GLuint upload(const std::vector<TextureImage>& layers, const std::vector<std::string>& paths);
+
+    std::vector<std::string> m_paths;
+};
+
+
+#endif //RENDERER_TEXTUREARRAYBUILDER_H
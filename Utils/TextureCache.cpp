@@ -0,0 +1,222 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "TextureCache.h"
+#include "Utils/Hash.h"
+#include "Utils/Logger.h"
+#include "Utils/MappedFile.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr char kMagic[4] = {'R', 'T', 'X', 'C'};
+    // 2: mip 改为在线性空间生成，旧缓存里的 mip 需要重新生成
+    constexpr uint32_t kVersion = 2;
+    // 宽高上限，保证 width * height * channels 不会溢出；GL 的最大纹理尺寸远小于它
+    constexpr uint32_t kMaxDimension = 1u << 16;
+
+    // 文件布局: CacheHeader | CacheLevel[levelCount] | 像素数据(从 dataOffset 开始，各级连续存放)
+    struct CacheHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t width;
+        uint32_t height;
+        uint32_t channels;
+        uint32_t levelCount;
+        uint64_t contentHash;
+        uint64_t dataOffset;
+    };
+
+    struct CacheLevel {
+        uint32_t width;
+        uint32_t height;
+        uint64_t offset;  // 相对于 dataOffset
+        uint64_t size;
+    };
+
+    std::mutex s_directoryMutex;
+    std::string s_directory = "cache/textures";
+    std::atomic<uint64_t> s_hits{0};
+    std::atomic<uint64_t> s_misses{0};
+
+    std::string cacheDirectory() {
+        std::lock_guard<std::mutex> lock(s_directoryMutex);
+        return s_directory;
+    }
+
+    fs::path cacheFilePath(const std::string& directory, const std::string& sourcePath, int desiredChannels) {
+        std::error_code ec;
+        std::string key = fs::absolute(sourcePath, ec).string() + "#" + std::to_string(desiredChannels);
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.texc", (unsigned long long)fnv1a(key));
+        return fs::path(directory) / name;
+    }
+
+    // 校验缓存文件结构，返回 header，不合法时返回 nullptr
+    const CacheHeader* validate(const MappedFile& file, int desiredChannels) {
+        if (file.size() < sizeof(CacheHeader)) {
+            return nullptr;
+        }
+        const auto* header = reinterpret_cast<const CacheHeader*>(file.data());
+        if (std::memcmp(header->magic, kMagic, sizeof(kMagic)) != 0 || header->version != kVersion) {
+            return nullptr;
+        }
+        if (header->levelCount == 0 || (desiredChannels != 0 && header->channels != (uint32_t)desiredChannels)) {
+            return nullptr;
+        }
+        size_t tableEnd = sizeof(CacheHeader) + header->levelCount * sizeof(CacheLevel);
+        if (tableEnd > file.size() || header->dataOffset < tableEnd) {
+            return nullptr;
+        }
+        if (header->channels < 1 || header->channels > 4 || header->width == 0 || header->height == 0 ||
+            header->width > kMaxDimension || header->height > kMaxDimension || header->dataOffset > file.size()) {
+            return nullptr;
+        }
+        // 每一级都要落在映射范围内，大小也要和宽高一致，否则 glTexImage2D 会读出映射之外
+        const uint64_t dataSize = file.size() - header->dataOffset;
+        const auto* levels = reinterpret_cast<const CacheLevel*>(file.data() + sizeof(CacheHeader));
+        for (uint32_t i = 0; i < header->levelCount; i++) {
+            const CacheLevel& level = levels[i];
+            if (level.width == 0 || level.height == 0 || level.width > header->width || level.height > header->height ||
+                level.size != (uint64_t)level.width * level.height * header->channels ||
+                level.offset > dataSize || level.size > dataSize - level.offset) {
+                return nullptr;
+            }
+        }
+        return header;
+    }
+}
+
+void TextureCache::setDirectory(const std::string& directory) {
+    std::lock_guard<std::mutex> lock(s_directoryMutex);
+    s_directory = directory;
+}
+
+bool TextureCache::load(const std::string& sourcePath, int desiredChannels, TextureImage& image,
+                        std::optional<uint64_t>* sourceHash) {
+    std::string directory = cacheDirectory();
+    if (directory.empty()) {
+        return false;
+    }
+    fs::path cachePath = cacheFilePath(directory, sourcePath, desiredChannels);
+    std::error_code ec;
+    auto cacheTime = fs::last_write_time(cachePath, ec);
+    if (ec) {
+        s_misses++;
+        return false;
+    }
+
+    auto file = std::make_shared<MappedFile>();
+    const CacheHeader* header = file->open(cachePath.string()) ? validate(*file, desiredChannels) : nullptr;
+    if (!header) {
+        LOG_WARN("Texture cache entry is corrupted, rebuild: {}", sourcePath);
+        s_misses++;
+        return false;
+    }
+
+    // 源文件比缓存新：内容哈希一致就只更新缓存时间，否则重建
+    auto sourceTime = fs::last_write_time(sourcePath, ec);
+    if (!ec && sourceTime > cacheTime) {
+        MappedFile source;
+        if (!source.open(sourcePath)) {
+            s_misses++;
+            return false;
+        }
+        uint64_t contentHash = fnv1aBytes(source.data(), source.size());
+        if (sourceHash) {
+            *sourceHash = contentHash;
+        }
+        if (contentHash != header->contentHash) {
+            s_misses++;
+            return false;
+        }
+        fs::last_write_time(cachePath, fs::file_time_type::clock::now(), ec);
+    }
+
+    const auto* levels = reinterpret_cast<const CacheLevel*>(file->data() + sizeof(CacheHeader));
+    image.width = (int)header->width;
+    image.height = (int)header->height;
+    image.channels = (int)header->channels;
+    image.levels.resize(header->levelCount);
+    for (uint32_t i = 0; i < header->levelCount; i++) {
+        image.levels[i].width = (int)levels[i].width;
+        image.levels[i].height = (int)levels[i].height;
+        image.levels[i].offset = levels[i].offset;
+        image.levels[i].size = levels[i].size;
+    }
+    image.pixels = file->data() + header->dataOffset;
+    image.storage = file;
+    s_hits++;
+    return true;
+}
+
+void TextureCache::store(const std::string& sourcePath, int desiredChannels, uint64_t contentHash,
+                         const TextureImage& image) {
+    std::string directory = cacheDirectory();
+    if (directory.empty() || !image.valid()) {
+        return;
+    }
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+    fs::path cachePath = cacheFilePath(directory, sourcePath, desiredChannels);
+
+    CacheHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.width = (uint32_t)image.width;
+    header.height = (uint32_t)image.height;
+    header.channels = (uint32_t)image.channels;
+    header.levelCount = (uint32_t)image.levels.size();
+    header.contentHash = contentHash;
+    // 像素数据按 16 字节对齐
+    header.dataOffset = (sizeof(CacheHeader) + image.levels.size() * sizeof(CacheLevel) + 15) & ~(uint64_t)15;
+
+    std::vector<CacheLevel> levels(image.levels.size());
+    for (size_t i = 0; i < image.levels.size(); i++) {
+        levels[i] = {(uint32_t)image.levels[i].width, (uint32_t)image.levels[i].height,
+                     image.levels[i].offset, image.levels[i].size};
+    }
+
+    // 先写临时文件再 rename，避免其他进程读到写了一半的缓存
+    fs::path tempPath = cachePath;
+    tempPath += ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            LOG_WARN("Failed to write texture cache: {}", tempPath.string());
+            return;
+        }
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(levels.data()), (std::streamsize)(levels.size() * sizeof(CacheLevel)));
+        const char padding[16] = {};
+        size_t written = sizeof(header) + levels.size() * sizeof(CacheLevel);
+        out.write(padding, (std::streamsize)(header.dataOffset - written));
+        out.write(reinterpret_cast<const char*>(image.pixels), (std::streamsize)MipChain::totalSize(image.levels));
+        if (!out) {
+            LOG_WARN("Failed to write texture cache: {}", tempPath.string());
+            out.close();
+            fs::remove(tempPath, ec);
+            return;
+        }
+    }
+    fs::rename(tempPath, cachePath, ec);
+    if (ec) {
+        LOG_WARN("Failed to write texture cache: {}, {}", cachePath.string(), ec.message());
+        fs::remove(tempPath, ec);
+    }
+}
+
+TextureCache::Stats TextureCache::stats() {
+    Stats stats;
+    stats.hits = s_hits.load();
+    stats.misses = s_misses.load();
+    return stats;
+}
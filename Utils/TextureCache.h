@@ -0,0 +1,34 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_TEXTURECACHE_H
+#define RENDERER_TEXTURECACHE_H
+#include <cstdint>
+#include <optional>
+#include <string>
+#include "Utils/ImageLoader.h"
+
+// 解码后像素 + 完整 mip 链的磁盘缓存。
+// 每个源文件对应一个缓存文件，命中时直接 mmap，上传时不需要解码也不需要 glGenerateMipmap。
+// 源文件比缓存新时会重新计算内容哈希，内容没变就沿用旧缓存，否则重建。
+class TextureCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    // 默认是 cache/textures，传空字符串关闭缓存
+    static void setDirectory(const std::string& directory);
+    // 命中时 image 指向缓存文件的内存映射，返回 true。
+    // 缓存过期时会计算源文件的内容哈希，sourceHash 不为空时带回给调用方，重建缓存时不用再算一遍
+    static bool load(const std::string& sourcePath, int desiredChannels, TextureImage& image,
+                     std::optional<uint64_t>* sourceHash = nullptr);
+    static void store(const std::string& sourcePath, int desiredChannels, uint64_t contentHash,
+                      const TextureImage& image);
+    static Stats stats();
+};
+
+
+#endif //RENDERER_TEXTURECACHE_H
@@ -0,0 +1,301 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "TextureManager.h"
+#include <algorithm>
+#include "Renderer/GLStateCache.h"
+#include "Utils/ImageLoader.h"
+#include "Utils/Logger.h"
+
+namespace {
+    // 这么多帧没有采样过的纹理才会被整张释放，正在使用的纹理只会被降级
+    constexpr uint64_t kIdleFrames = 30;
+
+    // 驱动一般把 RGB8 按 RGBA8 存放，压缩格式按块大小原样存放
+    std::vector<size_t> gpuLevelBytes(const TextureImage& image) {
+        std::vector<size_t> bytes;
+        for (const MipLevel& level : image.levels) {
+            if (image.compressed()) {
+                bytes.push_back(level.size);
+            } else {
+                int texelBytes = image.channels == 3 ? 4 : image.channels;
+                bytes.push_back((size_t)level.width * level.height * texelBytes);
+            }
+        }
+        return bytes;
+    }
+}
+
+TextureManager::TextureManager(size_t budgetBytes) : m_budget(budgetBytes) {
+}
+
+TextureId TextureManager::load(const std::string& path) {
+    auto it = m_indexByPath.find(path);
+    if (it != m_indexByPath.end()) {
+        return {it->second};
+    }
+    auto entry = std::make_shared<Entry>();
+    entry->path = path;
+    entry->lastUsedFrame = m_frame;
+    TextureId id{(uint32_t)m_entries.size()};
+    m_entries.push_back(entry);
+    m_indexByPath.emplace(path, id.index);
+    request(entry);
+    return id;
+}
+
+GLuint TextureManager::use(TextureId id) {
+    if (!id.valid() || id.index >= m_entries.size()) {
+        return ImageLoader::placeholderTexture();
+    }
+    Entry& entry = *m_entries[id.index];
+    entry.lastUsedFrame = m_frame;
+    return entry.texture != 0 ? entry.texture : ImageLoader::placeholderTexture();
+}
+
+bool TextureManager::isFailed(TextureId id) const {
+    return id.valid() && id.index < m_entries.size() && m_entries[id.index]->failed;
+}
+
+size_t TextureManager::residentBytes(TextureId id) const {
+    return id.valid() && id.index < m_entries.size() ? m_entries[id.index]->residentBytes : 0;
+}
+
+size_t TextureManager::committedBytes(const Entry& entry) {
+    size_t bytes = 0;
+    for (size_t level = entry.targetLevel; level < entry.levelBytes.size(); level++) {
+        bytes += entry.levelBytes[level];
+    }
+    return bytes;
+}
+
+size_t TextureManager::chargedBytes(const Entry& entry) {
+    return std::max(committedBytes(entry), entry.residentBytes);
+}
+
+void TextureManager::request(const std::shared_ptr<Entry>& entry) {
+    if (!entry->levelBytes.empty()) {
+        m_stats.reloads++;
+    }
+    entry->loading = true;
+    uint32_t generation = ++entry->generation;
+    // 驱逐或降级后再加载一般命中 TextureCache / .ktx2 的内存映射，不会重新解码
+    ImageLoader::submitAsync([entry, generation]() -> std::function<void()> {
+        auto image = std::make_shared<TextureImage>(ImageLoader::loadImage(entry->path));
+        return [entry, generation, image] {
+            if (entry->generation != generation) {
+                return;
+            }
+            entry->loading = false;
+            if (!image->valid()) {
+                entry->failed = true;
+                LOG_ERROR("TextureManager: failed to load {}", entry->path);
+                return;
+            }
+            const size_t levelCount = image->levels.size();
+            entry->levelBytes = gpuLevelBytes(*image);
+            entry->targetLevel = std::min(entry->targetLevel, levelCount - 1);
+            const size_t target = entry->targetLevel;
+
+            if (entry->texture == 0) {
+                glGenTextures(1, &entry->texture);
+                GLStateCache::bindTexture(GL_TEXTURE_2D, entry->texture);
+                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levelCount - 1);
+                entry->residentLevel = levelCount;
+                entry->residentBytes = 0;
+                stream(entry, image, target, levelCount - 1);
+                return;
+            }
+            if (target < entry->residentLevel) {
+                // 补回更精细的 mip：在原纹理上接着往下传
+                stream(entry, image, target, entry->residentLevel - 1);
+                return;
+            }
+            if (target == entry->residentLevel) {
+                return;
+            }
+
+            // 丢掉最精细的几级：GL 没法单独释放某一级，新建一张只定义 target 及以下各级的纹理替换旧的。
+            // 降级后只剩不到原来 1/4 的数据，一次传完
+            GLuint texture;
+            glGenTextures(1, &texture);
+            GLStateCache::bindTexture(GL_TEXTURE_2D, texture);
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+            size_t bytes = 0;
+            for (size_t level = levelCount; level-- > target;) {
+                ImageLoader::uploadTextureLevel(*image, level);
+                bytes += entry->levelBytes[level];
+            }
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, (GLint)target);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, (GLint)levelCount - 1);
+            ImageLoader::cancelStream(entry->texture);
+            GLStateCache::deleteTextures(1, &entry->texture);
+            entry->texture = texture;
+            entry->residentLevel = target;
+            entry->residentBytes = bytes;
+            entry->streaming = false;
+        };
+    });
+}
+
+void TextureManager::stream(const std::shared_ptr<Entry>& entry, const std::shared_ptr<TextureImage>& image,
+                            size_t finestLevel, size_t coarsestLevel) {
+    std::vector<size_t> uploadBytes;
+    for (const MipLevel& level : image->levels) {
+        uploadBytes.push_back(level.size);
+    }
+    entry->streaming = true;
+    entry->streamFinestLevel = finestLevel;
+    ImageLoader::streamLevels(GL_TEXTURE_2D, entry->texture, std::move(uploadBytes),
+                              [entry, image](size_t level) {
+                                  ImageLoader::uploadTextureLevel(*image, level);
+                                  entry->residentLevel = level;
+                                  entry->residentBytes += entry->levelBytes[level];
+                                  // 中途可能被 trimStream 提前停下，按 streamFinestLevel 判断是否传完
+                                  entry->streaming = level != entry->streamFinestLevel;
+                              },
+                              finestLevel, coarsestLevel);
+}
+
+void TextureManager::evict(Entry& entry) {
+    if (entry.texture != 0) {
+        ImageLoader::cancelStream(entry.texture);
+        GLStateCache::deleteTextures(1, &entry.texture);
+        entry.texture = 0;
+        m_stats.evictions++;
+    }
+    // generation 加一后还在路上的加载结果会被丢弃
+    entry.generation++;
+    entry.residentLevel = entry.levelBytes.size();
+    entry.residentBytes = 0;
+    entry.targetLevel = entry.levelBytes.size();
+    entry.loading = false;
+    entry.streaming = false;
+}
+
+void TextureManager::shrink(size_t committed) {
+    const size_t lowWater = m_budget / 10 * 9;
+    std::vector<Entry*> lru;
+    for (const auto& entry : m_entries) {
+        if (committedBytes(*entry) > 0) {
+            lru.push_back(entry.get());
+        }
+    }
+    std::sort(lru.begin(), lru.end(), [](const Entry* a, const Entry* b) { return a->lastUsedFrame < b->lastUsedFrame; });
+
+    // 先整张释放空闲的纹理，从最久没用的开始
+    for (Entry* entry : lru) {
+        if (committed <= lowWater || entry->lastUsedFrame + kIdleFrames > m_frame) {
+            break;
+        }
+        committed -= committedBytes(*entry);
+        evict(*entry);
+    }
+    // 剩下的都在使用，按 LRU 顺序每张轮流丢一级，最小的一级始终保留
+    bool dropped = true;
+    while (committed > lowWater && dropped) {
+        dropped = false;
+        for (Entry* entry : lru) {
+            if (committed <= lowWater) {
+                break;
+            }
+            if (entry->targetLevel + 1 >= entry->levelBytes.size()) {
+                continue;
+            }
+            committed -= entry->levelBytes[entry->targetLevel];
+            entry->targetLevel++;
+            m_stats.mipDrops++;
+            dropped = true;
+        }
+    }
+}
+
+size_t TextureManager::grow(size_t committed) {
+    const size_t lowWater = m_budget == 0 ? SIZE_MAX : m_budget / 10 * 9;
+    std::vector<Entry*> recent;
+    std::vector<Entry*> idle;
+    for (const auto& entry : m_entries) {
+        if (entry->lastUsedFrame + kIdleFrames <= m_frame) {
+            if (committedBytes(*entry) > 0) {
+                idle.push_back(entry.get());
+            }
+        } else if (!entry->failed && !entry->levelBytes.empty() && entry->targetLevel > 0) {
+            recent.push_back(entry.get());
+        }
+    }
+    // 最近采样的先恢复，需要空间时从最久没用的空闲纹理里腾出来
+    std::sort(recent.begin(), recent.end(), [](const Entry* a, const Entry* b) { return a->lastUsedFrame > b->lastUsedFrame; });
+    std::sort(idle.begin(), idle.end(), [](const Entry* a, const Entry* b) { return a->lastUsedFrame < b->lastUsedFrame; });
+    size_t nextIdle = 0;
+    for (Entry* entry : recent) {
+        const size_t current = chargedBytes(*entry);
+        size_t level = entry->targetLevel;
+        size_t bytes = committedBytes(*entry);
+        // 被驱逐后又用到的纹理至少要回来最小的一级，只有几个字节，不受预算限制
+        if (level == entry->levelBytes.size()) {
+            level--;
+            bytes += entry->levelBytes[level];
+        }
+        while (level > 0) {
+            if (committed - current + std::max(bytes + entry->levelBytes[level - 1], entry->residentBytes) <= lowWater) {
+                level--;
+                bytes += entry->levelBytes[level];
+            } else if (nextIdle < idle.size()) {
+                committed -= chargedBytes(*idle[nextIdle]);
+                evict(*idle[nextIdle++]);
+            } else {
+                break;
+            }
+        }
+        committed = committed - current + std::max(bytes, entry->residentBytes);
+        entry->targetLevel = level;
+    }
+    return committed;
+}
+
+void TextureManager::update() {
+    m_frame++;
+    size_t committed = 0;
+    for (const auto& entry : m_entries) {
+        committed += committedBytes(*entry);
+    }
+    if (m_budget > 0 && committed > m_budget) {
+        shrink(committed);
+    }
+    // 降级要等新纹理建好才真正释放显存，恢复时按实际占用算，不会提前占用还没腾出来的空间
+    size_t charged = 0;
+    for (const auto& entry : m_entries) {
+        charged += chargedBytes(*entry);
+    }
+    grow(charged);
+
+    // 驻留的级别和目标不一致时重新加载：驱逐后又用到、降级、恢复 mip
+    m_stats.textures = m_entries.size();
+    m_stats.residentTextures = 0;
+    m_stats.residentBytes = 0;
+    m_stats.budgetBytes = m_budget;
+    for (const auto& entry : m_entries) {
+        if (entry->streaming && entry->targetLevel > entry->streamFinestLevel) {
+            // 流式上传途中目标变粗：停在新的目标，不再上传之后又要丢掉的精细级别
+            entry->streamFinestLevel = entry->targetLevel;
+            entry->streaming = ImageLoader::trimStream(entry->texture, entry->targetLevel);
+        }
+        if (!entry->failed && !entry->loading && !entry->streaming &&
+            entry->targetLevel < entry->levelBytes.size() &&
+            (entry->texture == 0 || entry->targetLevel != entry->residentLevel)) {
+            request(entry);
+        }
+        m_stats.residentTextures += entry->texture != 0 ? 1 : 0;
+        m_stats.residentBytes += entry->residentBytes;
+    }
+}
+
+void TextureManager::destroy() {
+    for (const auto& entry : m_entries) {
+        evict(*entry);
+    }
+    m_entries.clear();
+    m_indexByPath.clear();
+}
@@ -0,0 +1,104 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_TEXTUREMANAGER_H
+#define RENDERER_TEXTUREMANAGER_H
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct TextureImage;
+
+// TextureManager 里一张纹理的编号，纹理被驱逐后编号仍然有效，再次使用时重新加载
+struct TextureId {
+    uint32_t index = UINT32_MAX;
+
+    bool valid() const { return index != UINT32_MAX; }
+};
+
+struct TextureManagerStats {
+    size_t textures = 0;
+    size_t residentTextures = 0;
+    size_t residentBytes = 0;
+    size_t budgetBytes = 0;
+    uint64_t evictions = 0;   // 整张纹理被释放的次数
+    uint64_t mipDrops = 0;    // 丢掉最精细一级 mip 的次数
+    uint64_t reloads = 0;     // 被驱逐或降级后又重新加载的次数
+};
+
+// 持有所有通过它加载的 GL_TEXTURE_2D，按字节统计显存(包含整条 mip 链)并维持在预算以内。
+// 纹理在线程池中加载，由 ImageLoader::processUploads() 从最小的 mip 开始流式上传。
+// 超出预算时先整张释放最久没有采样过的纹理，还不够再按 LRU 顺序逐级丢掉正在使用的纹理最精细的 mip；
+// 用量回落后，最近采样过的纹理按需重新加载、补回 mip。
+// 收缩到预算的 90% 才停止，恢复也不会超过这条线，用量在预算附近时不会反复释放又加载同一张纹理。
+// 除构造外都必须在 GL 线程调用
+class TextureManager {
+public:
+    // budgetBytes 为 0 表示不限制
+    explicit TextureManager(size_t budgetBytes = 0);
+    TextureManager(const TextureManager&) = delete;
+    TextureManager& operator=(const TextureManager&) = delete;
+
+    // 同一路径只加载一次
+    TextureId load(const std::string& path);
+    // 本帧要采样这张纹理：记录使用时间，返回当前驻留的纹理，还没加载完或已被驱逐时返回占位纹理
+    GLuint use(TextureId id);
+    bool isFailed(TextureId id) const;
+    // 这张纹理当前占用的显存字节数
+    size_t residentBytes(TextureId id) const;
+
+    // 每帧在 ImageLoader::processUploads() 之后调用一次：执行驱逐/降级，并为最近使用的纹理恢复 mip
+    void update();
+    void setBudget(size_t budgetBytes) { m_budget = budgetBytes; }
+    const TextureManagerStats& stats() const { return m_stats; }
+
+    // 和其他 GL 资源一样，需要在 context 销毁之前手动释放
+    void destroy();
+
+private:
+    struct Entry {
+        std::string path;
+        GLuint texture = 0;
+        // 整条 mip 链每级的显存字节数，第一次加载完成后才知道
+        std::vector<size_t> levelBytes;
+        // 已上传的最精细一级，没有纹理时等于 levelBytes.size()
+        size_t residentLevel = 0;
+        size_t residentBytes = 0;
+        // 希望驻留的最精细一级，等于 levelBytes.size() 表示不需要驻留
+        size_t targetLevel = 0;
+        // 正在进行的流式上传最终会传到的级别
+        size_t streamFinestLevel = 0;
+        uint64_t lastUsedFrame = 0;
+        // 每次发起加载或驱逐时加一，过期的加载结果直接丢弃
+        uint32_t generation = 0;
+        bool loading = false;
+        bool streaming = false;
+        bool failed = false;
+    };
+
+    // 按 targetLevel 计算的字节数：已经决定驻留(或正在加载)的部分都算进去
+    static size_t committedBytes(const Entry& entry);
+    // 实际占用和计划占用取大：降级后旧纹理替换掉之前，它的显存还没有释放
+    static size_t chargedBytes(const Entry& entry);
+    void request(const std::shared_ptr<Entry>& entry);
+    // 在 entry 当前的纹理上从 coarsestLevel 往 finestLevel 流式上传
+    static void stream(const std::shared_ptr<Entry>& entry, const std::shared_ptr<TextureImage>& image,
+                       size_t finestLevel, size_t coarsestLevel);
+    void evict(Entry& entry);
+    void shrink(size_t committed);
+    size_t grow(size_t committed);
+
+    std::vector<std::shared_ptr<Entry>> m_entries;
+    std::unordered_map<std::string, uint32_t> m_indexByPath;
+    size_t m_budget;
+    uint64_t m_frame = 0;
+    TextureManagerStats m_stats;
+};
+
+
+#endif //RENDERER_TEXTUREMANAGER_H
@@ -0,0 +1,45 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_THREADPOOL_H
+#define RENDERER_THREADPOOL_H
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// 简单的固定大小线程池，用于把 CPU 重活(图片解码等)从 GL 线程挪走。
+// 注意：任务中不能调用任何 GL 函数，GL context 只属于渲染线程。
+class ThreadPool {
+public:
+    // threadCount 为 0 时使用 hardware_concurrency - 1 (至少 1 个)
+    explicit ThreadPool(size_t threadCount = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+    // 把 [0, count) 按 chunkSize 切块并行执行 body(begin, end)，调用线程也会处理一块，全部完成后返回。
+    // 不要在池内的任务里调用，否则所有 worker 都可能在等待彼此
+    void parallelFor(size_t count, size_t chunkSize, const std::function<void(size_t begin, size_t end)>& body);
+    size_t threadCount() const { return m_workers.size(); }
+
+    // 进程共享的线程池，第一次使用时创建
+    static ThreadPool& shared();
+
+private:
+    void workerLoop();
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
+
+
+#endif //RENDERER_THREADPOOL_H
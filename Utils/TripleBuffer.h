@@ -0,0 +1,58 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_TRIPLEBUFFER_H
+#define RENDERER_TRIPLEBUFFER_H
+#include <atomic>
+#include <cstdint>
+
+// 单生产者 / 单消费者的三缓冲，用于把模拟线程生成的帧快照交给渲染线程。
+// 生产者写 writeBuffer()，publish() 把它和中间槽交换；消费者 acquire() 把中间槽换到读端。
+// 两端各自独占一个槽，中间槽只通过一次原子交换转手，没有锁也不会互相等待；
+// 消费者来不及取走的旧快照会被新的直接覆盖，渲染线程拿到的总是最新的一份。
+// 消费者没有事可做时可以 waitForPublish() 阻塞到下一次 publish()，不用空转。
+template<typename T>
+class TripleBuffer {
+public:
+    // 生产者一侧
+    T& writeBuffer() { return m_buffers[m_write]; }
+    void publish() {
+        uint8_t previous = m_middle.exchange((uint8_t)(m_write | kFresh), std::memory_order_acq_rel);
+        m_write = previous & kIndexMask;
+        m_middle.notify_one();
+    }
+    // 上一次 publish 的快照还没被消费者取走
+    bool pending() const { return (m_middle.load(std::memory_order_acquire) & kFresh) != 0; }
+
+    // 消费者一侧：有新快照时换到读端并返回 true，否则读端保持上一份
+    bool acquire() {
+        if ((m_middle.load(std::memory_order_relaxed) & kFresh) == 0) {
+            return false;
+        }
+        uint8_t previous = m_middle.exchange(m_read, std::memory_order_acq_rel);
+        m_read = previous & kIndexMask;
+        return true;
+    }
+    // 没有新快照时阻塞到生产者下一次 publish()。只有消费者会清掉 kFresh，
+    // 所以这里看到的值在 publish 之前不会变，atomic::wait 不会错过唤醒
+    void waitForPublish() const {
+        uint8_t middle = m_middle.load(std::memory_order_acquire);
+        if ((middle & kFresh) == 0) {
+            m_middle.wait(middle, std::memory_order_acquire);
+        }
+    }
+    const T& readBuffer() const { return m_buffers[m_read]; }
+
+private:
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+
+    T m_buffers[3];
+    uint8_t m_write = 0;
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_read = 2;
+};
+
+
+#endif //RENDERER_TRIPLEBUFFER_H
@@ -1,6 +1,3 @@
-# This file is managed by Conan, contents will be overwritten.
-# To keep your changes, remove these comment lines, but the plugin won't be able to modify your requirements
-
 from conan import ConanFile
 from conan.tools.cmake import cmake_layout, CMakeToolchain
 
@@ -8,6 +5,18 @@ class ConanApplication(ConanFile):
     package_type = "application"
     settings = "os", "compiler", "build_type", "arch"
     generators = "CMakeDeps"
+    # glad 默认只生成 3.3 的函数，multi draw indirect / SSBO 等 4.x 入口需要生成到 4.6；
+    # 实际创建的 context 版本仍由程序决定，运行时通过 GLAD_GL_VERSION_* 判断。
+    # extensions 为空时 glad 一个扩展都不生成，代码里 #ifdef GL_XXX 包住的扩展路径会被整个编译掉，
+    # 用到的扩展要列在这里(逗号分隔)，运行时再通过 GLAD_GL_XXX 判断驱动是否支持
+    default_options = {
+        "glad/*:gl_profile": "core",
+        "glad/*:gl_version": "4.6",
+        "glad/*:extensions": "GL_KHR_parallel_shader_compile,"
+                             "GL_ARB_shader_draw_parameters,GL_ARB_multi_draw_indirect,GL_ARB_draw_indirect,"
+                             "GL_ARB_shader_storage_buffer_object,GL_ARB_buffer_storage,GL_ARB_get_program_binary,"
+                             "GL_EXT_texture_compression_s3tc,GL_ARB_texture_compression_bptc",
+    }
 
     def layout(self):
         cmake_layout(self)
@@ -0,0 +1,174 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_PROGRAMCACHE_H
+#define RENDERER_PROGRAMCACHE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Utils/Hash.h"
+#include "Utils/Logger.h"
+
+// glad 只生成 3.3 的入口时没有 glGetProgramBinary/glProgramBinary，缓存整体编译成空操作
+#if defined(GL_VERSION_4_1) || defined(GL_ARB_get_program_binary)
+#define RENDERER_PROGRAM_BINARY 1
+#endif
+
+// glGetProgramBinary/glProgramBinary 的磁盘缓存。
+// key 由 vertex/fragment 源码和 GL_RENDERER/GL_VERSION 共同决定，换驱动或改 shader 都会自动失效；
+// 驱动拒绝缓存的二进制时调用方回退到源码编译。
+class ProgramCache {
+public:
+    static inline std::string directory = "cache/programs";
+
+    static bool supported()
+    {
+        static const bool s_supported = [] {
+            bool available = false;
+#ifdef GL_VERSION_4_1
+            available = available || GLAD_GL_VERSION_4_1;
+#endif
+#ifdef GL_ARB_get_program_binary
+            available = available || GLAD_GL_ARB_get_program_binary;
+#endif
+            // macOS 等平台虽然有这个函数，但一个可用的 binary format 都没有
+            GLint formatCount = 0;
+#ifdef RENDERER_PROGRAM_BINARY
+            if (available)
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+#endif
+            return available && formatCount > 0;
+        }();
+        return s_supported && !directory.empty();
+    }
+
+    static uint64_t key(const std::string& vertexCode, const std::string& fragmentCode)
+    {
+        uint64_t hash = fnv1a(vertexCode);
+        hash = fnv1a(fragmentCode, hash);
+        hash = fnv1a(std::string_view(reinterpret_cast<const char*>(glGetString(GL_RENDERER))), hash);
+        hash = fnv1a(std::string_view(reinterpret_cast<const char*>(glGetString(GL_VERSION))), hash);
+        return hash;
+    }
+
+    // 命中且驱动接受时 program 已经处于 link 成功的状态；
+    // compileMs 返回当初从源码编译花费的时间，用来估算节省了多少启动时间
+    static bool load(uint64_t key, GLuint program, double& compileMs)
+    {
+#ifdef RENDERER_PROGRAM_BINARY
+        if (!supported())
+            return false;
+        std::string path = filePath(key);
+        std::error_code ec;
+        uintmax_t fileSize = std::filesystem::file_size(path, ec);
+        if (ec)
+            return false;
+        std::ifstream in(path, std::ios::binary);
+        if (!in)
+            return false;
+        Header header{};
+        in.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!in || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+            return false;
+        // 先用文件大小约束 length，损坏的文件不会触发巨大的分配
+        if (header.length == 0 || header.length != fileSize - sizeof(header)) {
+            LOG_WARN("SHADER::PROGRAM_CACHE corrupted cache file {}, recompiling", path);
+            return false;
+        }
+        std::vector<char> binary(header.length);
+        in.read(binary.data(), (std::streamsize)binary.size());
+        if (!in)
+            return false;
+
+        glProgramBinary(program, header.format, binary.data(), (GLsizei)binary.size());
+        GLint success = 0;
+        glGetProgramiv(program, GL_LINK_STATUS, &success);
+        if (!success) {
+            LOG_WARN("SHADER::PROGRAM_CACHE driver rejected cached binary {:016x}, recompiling", key);
+            return false;
+        }
+        compileMs = header.compileMs;
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    static void store(uint64_t key, GLuint program, double compileMs)
+    {
+#ifdef RENDERER_PROGRAM_BINARY
+        if (!supported())
+            return;
+        GLint length = 0;
+        glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+        if (length <= 0)
+            return;
+        std::vector<char> binary(length);
+        Header header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        glGetProgramBinary(program, length, nullptr, &header.format, binary.data());
+        header.length = (uint32_t)length;
+        header.compileMs = compileMs;
+
+        // 先写临时文件再 rename，其他进程不会读到写了一半的缓存
+        std::error_code ec;
+        std::filesystem::create_directories(directory, ec);
+        std::string path = filePath(key);
+        std::string tempPath = path + ".tmp" + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        {
+            std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(binary.data(), (std::streamsize)binary.size());
+            if (!out) {
+                LOG_WARN("SHADER::PROGRAM_CACHE failed to write {}", tempPath);
+                out.close();
+                std::filesystem::remove(tempPath, ec);
+                return;
+            }
+        }
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec) {
+            LOG_WARN("SHADER::PROGRAM_CACHE failed to write {}, {}", path, ec.message());
+            std::filesystem::remove(tempPath, ec);
+        }
+#endif
+    }
+
+    // 链接前调用，告诉驱动之后会取回 binary
+    static void prepare(GLuint program)
+    {
+#ifdef RENDERER_PROGRAM_BINARY
+        if (supported())
+            glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+#endif
+    }
+
+private:
+    static constexpr char kMagic[4] = {'R', 'P', 'B', 'C'};
+    static constexpr uint32_t kVersion = 1;
+
+    struct Header {
+        char magic[4];
+        uint32_t version;
+        GLenum format;
+        uint32_t length;
+        double compileMs;
+    };
+
+    static std::string filePath(uint64_t key)
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)key);
+        return (std::filesystem::path(directory) / name).string();
+    }
+};
+
+#endif //RENDERER_PROGRAMCACHE_H
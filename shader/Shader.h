@@ -6,107 +6,295 @@
 #define RENDERER_SHADER_H
 
 #include <glad/glad.h>
+#include <chrono>
 #include <string>
 #include <fstream>
 #include <sstream>
+#include <unordered_set>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 #include <glm/gtc/quaternion.hpp>
 #include "Utils/Logger.h"
+#include "Utils/Profiler.h"
+#include "Renderer/GLStateCache.h"
+#include "shader/ProgramCache.h"
+#include "shader/UniformBuffer.h"
+#include "shader/UniformTable.h"
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
 
 class Shader
 {
 public:
-    unsigned int ID;
-    // constructor generates the shader on the fly
+    unsigned int ID = 0;
+    // constructor generates the shader on the fly, blocking until the program is linked
     // ------------------------------------------------------------------------
     Shader(const char* vertexPath, const char* fragmentPath)
     {
+        PROFILE_SCOPE("Shader::Shader");
         // 1. retrieve the vertex/fragment source code from filePath
         std::string vertexCode;
         std::string fragmentCode;
-        std::ifstream vShaderFile;
-        std::ifstream fShaderFile;
+        readSource(vertexPath, vertexCode);
+        readSource(fragmentPath, fragmentCode);
+        // 2. compile, link and wait for the result
+        beginBuild(vertexCode, fragmentCode, vertexPath);
+        finishBuild();
+    }
+    // empty shader, built later through beginBuild/finishBuild (see ShaderLibrary)
+    Shader() = default;
+
+    static bool readSource(const char* path, std::string& code)
+    {
+        std::ifstream shaderFile;
         // ensure ifstream objects can throw exceptions:
-        vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-        fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
+        shaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
         try
         {
-            // open files
-            vShaderFile.open(vertexPath);
-            fShaderFile.open(fragmentPath);
-            std::stringstream vShaderStream, fShaderStream;
+            shaderFile.open(path);
+            std::stringstream shaderStream;
             // read file's buffer contents into streams
-            vShaderStream << vShaderFile.rdbuf();
-            fShaderStream << fShaderFile.rdbuf();
-            // close file handlers
-            vShaderFile.close();
-            fShaderFile.close();
-            // convert stream into string
-            vertexCode   = vShaderStream.str();
-            fragmentCode = fShaderStream.str();
+            shaderStream << shaderFile.rdbuf();
+            shaderFile.close();
+            code = shaderStream.str();
+            return true;
         }
         catch (std::ifstream::failure& e)
         {
-            LOG_ERROR("SHADER::FILE_NOT_SUCCESSFULLY_READ: {}", e.what());
+            LOG_ERROR("SHADER::FILE_NOT_SUCCESSFULLY_READ: {} {}", path, e.what());
+            return false;
+        }
+    }
+
+    // submit compile + link to the driver without querying any status,
+    // so the driver is free to compile in the background
+    // ------------------------------------------------------------------------
+    void beginBuild(const std::string& vertexCode, const std::string& fragmentCode, const std::string& label)
+    {
+        m_label = label;
+        m_buildStart = std::chrono::steady_clock::now();
+        // try the program binary cache first, it skips compile and link entirely
+        ID = glCreateProgram();
+        m_cacheKey = ProgramCache::key(vertexCode, fragmentCode);
+        double compileMs = 0.0;
+        if (ProgramCache::load(m_cacheKey, ID, compileMs))
+        {
+            double loadMs = elapsedMs(m_buildStart);
+            LOG_INFO("SHADER::PROGRAM_CACHE hit {}, load {:.2f} ms, saved {:.2f} ms", m_label, loadMs, compileMs - loadMs);
+            m_fromCache = true;
+            return;
         }
+        // a rejected binary may leave the program in a failed state, start over with a fresh one
+        glDeleteProgram(ID);
+
         const char* vShaderCode = vertexCode.c_str();
         const char * fShaderCode = fragmentCode.c_str();
-        // 2. compile shaders
-        unsigned int vertex, fragment;
         // vertex shader
-        vertex = glCreateShader(GL_VERTEX_SHADER);
-        glShaderSource(vertex, 1, &vShaderCode, NULL);
-        glCompileShader(vertex);
-        checkCompileErrors(vertex, "VERTEX");
+        m_vertex = glCreateShader(GL_VERTEX_SHADER);
+        glShaderSource(m_vertex, 1, &vShaderCode, NULL);
+        glCompileShader(m_vertex);
         // fragment Shader
-        fragment = glCreateShader(GL_FRAGMENT_SHADER);
-        glShaderSource(fragment, 1, &fShaderCode, NULL);
-        glCompileShader(fragment);
-        checkCompileErrors(fragment, "FRAGMENT");
+        m_fragment = glCreateShader(GL_FRAGMENT_SHADER);
+        glShaderSource(m_fragment, 1, &fShaderCode, NULL);
+        glCompileShader(m_fragment);
         // shader Program
         ID = glCreateProgram();
-        glAttachShader(ID, vertex);
-        glAttachShader(ID, fragment);
+        ProgramCache::prepare(ID);
+        glAttachShader(ID, m_vertex);
+        glAttachShader(ID, m_fragment);
         glLinkProgram(ID);
-        checkCompileErrors(ID, "PROGRAM");
-        // delete the shaders as they're linked into our program now and no longer necessary
-        glDeleteShader(vertex);
-        glDeleteShader(fragment);
+        // time spent submitting; the rest is added once the driver is done (see isBuildComplete/finishBuild)
+        m_compileMs = elapsedMs(m_buildStart);
     }
-    // activate the shader
+    // non-blocking check, only meaningful with KHR_parallel_shader_compile;
+    // without it the driver is considered done and finishBuild() may block
+    // ------------------------------------------------------------------------
+    bool isBuildComplete() const
+    {
+        if (m_fromCache || !parallelCompileSupported())
+            return true;
+        GLint complete = GL_FALSE;
+        glGetProgramiv(ID, GL_COMPLETION_STATUS_KHR, &complete);
+        if (complete == GL_TRUE && !m_completionSeen)
+        {
+            // compiled in the background: the first poll that sees it done ends the measurement,
+            // finishBuild() may only run frames later
+            m_compileMs = elapsedMs(m_buildStart);
+            m_completionSeen = true;
+        }
+        return complete == GL_TRUE;
+    }
+    // check errors, store the binary and reflect uniforms; returns link success
+    // ------------------------------------------------------------------------
+    bool finishBuild()
+    {
+        bool linked = true;
+        if (!m_fromCache)
+        {
+            // without parallel compile the status queries below block until the driver is done,
+            // so only the submit time plus this wait is what a cache hit saves
+            auto waitStart = std::chrono::steady_clock::now();
+            checkCompileErrors(m_vertex, "VERTEX");
+            checkCompileErrors(m_fragment, "FRAGMENT");
+            linked = checkCompileErrors(ID, "PROGRAM");
+            if (!m_completionSeen)
+                m_compileMs += elapsedMs(waitStart);
+            if (linked)
+                ProgramCache::store(m_cacheKey, ID, m_compileMs);
+            // delete the shaders as they're linked into our program now and no longer necessary
+            glDeleteShader(m_vertex);
+            glDeleteShader(m_fragment);
+            m_vertex = m_fragment = 0;
+        }
+        // reflect all active uniforms once, setters only do a table lookup afterwards
+        m_uniforms.reflect(ID);
+        // attach known uniform blocks (FrameConstants, ...) to their fixed binding points
+        bindUniformBlocks();
+        m_ready = linked;
+        m_failed = !linked;
+        return linked;
+    }
+    bool isReady() const { return m_ready; }
+    // the build failed (unreadable source, compile or link error), the shader never becomes ready
+    bool isFailed() const { return m_failed; }
+    // for builders that give up before beginBuild, e.g. ShaderLibrary when a source file cannot be read
+    void markFailed() { m_failed = true; }
+
+    static bool parallelCompileSupported()
+    {
+#ifdef GL_KHR_parallel_shader_compile
+        return GLAD_GL_KHR_parallel_shader_compile != 0;
+#else
+        return false;
+#endif
+    }
+    // activate the shader, skipped when it is already the current program
     // ------------------------------------------------------------------------
     void use()
     {
-        glUseProgram(ID);
+        GLStateCache::useProgram(ID);
     }
     // utility uniform functions
     // ------------------------------------------------------------------------
-    void setBool(const std::string &name, bool value) const
+    void setBool(UniformName name, bool value) const
+    {
+        if (const UniformTable::Entry* uniform = lookup<bool>(name))
+            glUniform1i(uniform->location, (int)value);
+    }
+    // ------------------------------------------------------------------------
+    void setInt(UniformName name, int value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+        if (const UniformTable::Entry* uniform = lookup<int>(name))
+            glUniform1i(uniform->location, value);
     }
     // ------------------------------------------------------------------------
-    void setInt(const std::string &name, int value) const
+    void setFloat(UniformName name, float value) const
     {
-        glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+        if (const UniformTable::Entry* uniform = lookup<float>(name))
+            glUniform1f(uniform->location, value);
     }
     // ------------------------------------------------------------------------
-    void setFloat(const std::string &name, float value) const
+    void setMat4(UniformName name, const glm::mat4 &mat) const
     {
-        glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+        if (const UniformTable::Entry* uniform = lookup<glm::mat4>(name))
+            glUniformMatrix4fv(uniform->location, 1, GL_FALSE, &mat[0][0]);
     }
+    // typed handles: resolve once, then set without any lookup
     // ------------------------------------------------------------------------
-    void setMat4(const std::string &name, const glm::mat4 &mat) const
+    template<typename T>
+    UniformHandle<T> uniform(UniformName name) const
+    {
+        UniformHandle<T> handle;
+        if (const UniformTable::Entry* entry = lookup<T>(name))
+            handle.location = entry->location;
+        return handle;
+    }
+    void set(UniformHandle<bool> handle, bool value) const
+    {
+        if (handle.valid()) glUniform1i(handle.location, (int)value);
+    }
+    void set(UniformHandle<int> handle, int value) const
+    {
+        if (handle.valid()) glUniform1i(handle.location, value);
+    }
+    void set(UniformHandle<float> handle, float value) const
     {
-        glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+        if (handle.valid()) glUniform1f(handle.location, value);
+    }
+    void set(UniformHandle<glm::vec3> handle, const glm::vec3 &value) const
+    {
+        if (handle.valid()) glUniform3fv(handle.location, 1, &value[0]);
+    }
+    void set(UniformHandle<glm::vec4> handle, const glm::vec4 &value) const
+    {
+        if (handle.valid()) glUniform4fv(handle.location, 1, &value[0]);
+    }
+    void set(UniformHandle<glm::mat4> handle, const glm::mat4 &mat) const
+    {
+        if (handle.valid()) glUniformMatrix4fv(handle.location, 1, GL_FALSE, &mat[0][0]);
     }
 
 private:
+    std::string m_label;
+    std::chrono::steady_clock::time_point m_buildStart;
+    // compile + link time stored in the program cache, excludes frames between polls
+    mutable double m_compileMs = 0.0;
+    mutable bool m_completionSeen = false;
+    uint64_t m_cacheKey = 0;
+    unsigned int m_vertex = 0;
+    unsigned int m_fragment = 0;
+    bool m_fromCache = false;
+    bool m_ready = false;
+    bool m_failed = false;
+
+    UniformTable m_uniforms;
+    // each bad name/type is only reported once, otherwise the render loop floods the log
+    mutable std::unordered_set<uint64_t> m_reportedUniforms;
+
+    template<typename T>
+    const UniformTable::Entry* lookup(const UniformName& name) const
+    {
+        const UniformTable::Entry* entry = m_uniforms.find(name);
+        if (!entry) {
+            if (m_reportedUniforms.insert(name.hash).second)
+                LOG_WARN("SHADER::UNIFORM '{}' not found in program {} (not declared or optimized out)", name.name, ID);
+            return nullptr;
+        }
+        if (!uniformTypeMatches<T>(entry->type)) {
+            if (m_reportedUniforms.insert(name.hash).second)
+                LOG_WARN("SHADER::UNIFORM '{}' type mismatch in program {}, GLSL type = 0x{:04X}", name.name, ID, entry->type);
+            return nullptr;
+        }
+        return entry;
+    }
+
+    void bindUniformBlocks()
+    {
+        GLint blockCount = 0;
+        glGetProgramiv(ID, GL_ACTIVE_UNIFORM_BLOCKS, &blockCount);
+        for (GLint i = 0; i < blockCount; i++) {
+            char blockName[256];
+            GLsizei length = 0;
+            glGetActiveUniformBlockName(ID, (GLuint)i, sizeof(blockName), &length, blockName);
+            int binding = findUniformBlockBinding(std::string_view(blockName, length));
+            if (binding >= 0)
+                glUniformBlockBinding(ID, (GLuint)i, (GLuint)binding);
+            else
+                LOG_WARN("SHADER::UNIFORM_BLOCK '{}' has no fixed binding point", std::string_view(blockName, length));
+        }
+    }
+
     // utility function for checking shader compilation/linking errors.
     // ------------------------------------------------------------------------
-    void checkCompileErrors(unsigned int shader, std::string type)
+    static double elapsedMs(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    bool checkCompileErrors(unsigned int shader, std::string type)
     {
         int success;
         char infoLog[1024];
@@ -128,6 +316,7 @@ private:
                 LOG_ERROR("PROGRAM_LINKING_ERROR of type: {} \n{}", type, infoLog);
             }
         }
+        return success != 0;
     }
 };
 #endif //RENDERER_SHADER_H
\ No newline at end of file
@@ -0,0 +1,92 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#include "ShaderLibrary.h"
+#include "Utils/ThreadPool.h"
+#include <thread>
+
+std::shared_ptr<Shader> ShaderLibrary::load(const std::string& name, const std::string& vertexPath,
+                                            const std::string& fragmentPath) {
+    auto shader = std::make_shared<Shader>();
+    auto pending = std::make_shared<PendingProgram>();
+    pending->name = name;
+    pending->vertexPath = vertexPath;
+    pending->shader = shader;
+    m_shaders[name] = shader;
+    {
+        std::lock_guard<std::mutex> lock(m_inbox->mutex);
+        m_inbox->reading++;
+    }
+
+    ThreadPool::shared().submit([inbox = m_inbox, pending, fragmentPath] {
+        pending->sourcesOk = Shader::readSource(pending->vertexPath.c_str(), pending->vertexCode) &&
+                             Shader::readSource(fragmentPath.c_str(), pending->fragmentCode);
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        inbox->reading--;
+        inbox->sourcesReady.push_back(pending);
+    });
+    return shader;
+}
+
+std::shared_ptr<Shader> ShaderLibrary::get(const std::string& name) const {
+    auto it = m_shaders.find(name);
+    return it == m_shaders.end() ? nullptr : it->second;
+}
+
+void ShaderLibrary::update() {
+#ifdef GL_KHR_parallel_shader_compile
+    if (!m_threadsConfigured && Shader::parallelCompileSupported()) {
+        // 0xFFFFFFFF 表示由驱动自己决定编译线程数
+        glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+    }
+#endif
+    m_threadsConfigured = true;
+
+    // 1. 先把所有源码已就绪的 program 都提交出去，再统一检查，
+    //    这样驱动可以同时编译多个 program
+    std::vector<std::shared_ptr<PendingProgram>> ready;
+    {
+        std::lock_guard<std::mutex> lock(m_inbox->mutex);
+        ready.swap(m_inbox->sourcesReady);
+    }
+    for (auto& pending : ready) {
+        if (!pending->sourcesOk) {
+            LOG_ERROR("SHADER_LIBRARY failed to read sources of '{}'", pending->name);
+            pending->shader->markFailed();
+            continue;
+        }
+        pending->shader->beginBuild(pending->vertexCode, pending->fragmentCode, pending->vertexPath);
+        // 源码已经交给驱动了
+        pending->vertexCode.clear();
+        pending->fragmentCode.clear();
+        m_compiling.push_back(pending);
+    }
+
+    // 2. 轮询完成状态；不支持 KHR_parallel_shader_compile 时 isBuildComplete 恒为 true
+    for (size_t i = 0; i < m_compiling.size();) {
+        if (!m_compiling[i]->shader->isBuildComplete()) {
+            i++;
+            continue;
+        }
+        if (!m_compiling[i]->shader->finishBuild()) {
+            LOG_ERROR("SHADER_LIBRARY failed to build '{}'", m_compiling[i]->name);
+        }
+        m_compiling[i] = m_compiling.back();
+        m_compiling.pop_back();
+    }
+}
+
+void ShaderLibrary::waitAll() {
+    while (pendingCount() > 0) {
+        update();
+        if (pendingCount() > 0) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+size_t ShaderLibrary::pendingCount() const {
+    std::lock_guard<std::mutex> lock(m_inbox->mutex);
+    return m_inbox->reading + m_inbox->sourcesReady.size() + m_compiling.size();
+}
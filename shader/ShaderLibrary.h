@@ -0,0 +1,59 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_SHADERLIBRARY_H
+#define RENDERER_SHADERLIBRARY_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "shader/Shader.h"
+
+// 统一管理所有 program 的非阻塞构建：
+// 1. load() 立即返回 Shader 句柄，源码文件在线程池中读取(不需要 GL context，可以在创建窗口之前调用)
+// 2. GL 线程每帧调用 update()，把源码已就绪的 program 一次性提交给驱动编译，
+//    支持 KHR_parallel_shader_compile 时通过 GL_COMPLETION_STATUS_KHR 轮询，不会阻塞在某一个 program 上
+// 3. shader->isReady() 之后才能使用；源码读取失败或编译/链接失败时 shader->isFailed() 为 true，不会再就绪
+class ShaderLibrary {
+public:
+    // load/get 在同一个线程(通常是主线程)调用
+    std::shared_ptr<Shader> load(const std::string& name, const std::string& vertexPath, const std::string& fragmentPath);
+    std::shared_ptr<Shader> get(const std::string& name) const;
+
+    // 必须在 GL 线程调用
+    void update();
+    // 阻塞直到所有已提交的 program 构建完成
+    void waitAll();
+    // 还没有就绪的 program 数量，GL 线程调用
+    size_t pendingCount() const;
+
+private:
+    struct PendingProgram {
+        std::string name;
+        std::string vertexPath;
+        std::string vertexCode;
+        std::string fragmentCode;
+        bool sourcesOk = false;
+        std::shared_ptr<Shader> shader;
+    };
+
+    // worker 线程读完源码后放到这里，等待 GL 线程提交。
+    // 用 shared_ptr 持有，library 先于读取任务析构也不会访问悬空内存
+    struct Inbox {
+        std::mutex mutex;
+        std::vector<std::shared_ptr<PendingProgram>> sourcesReady;
+        size_t reading = 0;
+    };
+
+    std::unordered_map<std::string, std::shared_ptr<Shader>> m_shaders;
+    std::shared_ptr<Inbox> m_inbox = std::make_shared<Inbox>();
+    // 已经提交给驱动、等待完成的 program，只在 GL 线程访问
+    std::vector<std::shared_ptr<PendingProgram>> m_compiling;
+    bool m_threadsConfigured = false;
+};
+
+
+#endif //RENDERER_SHADERLIBRARY_H
@@ -0,0 +1,88 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_UNIFORMBUFFER_H
+#define RENDERER_UNIFORMBUFFER_H
+
+#include <glad/glad.h>
+#include <cstring>
+#include <string_view>
+#include <glm/glm.hpp>
+#include "Renderer/GLStateCache.h"
+
+// 全局固定的 uniform block binding point。
+// Shader link 之后会按名字查这张表，自动把声明了对应 block 的 program 绑到这里。
+struct UniformBlockBinding {
+    const char* name;
+    GLuint binding;
+};
+
+constexpr GLuint FRAME_CONSTANTS_BINDING = 0;
+
+inline constexpr UniformBlockBinding kUniformBlockBindings[] = {
+    {"FrameConstants", FRAME_CONSTANTS_BINDING},
+};
+
+inline int findUniformBlockBinding(std::string_view blockName)
+{
+    for (const UniformBlockBinding& entry : kUniformBlockBindings) {
+        if (blockName == entry.name) {
+            return (int)entry.binding;
+        }
+    }
+    return -1;
+}
+
+// 每帧所有 draw 都相同的数据，按 std140 布局，必须和 GLSL 中的声明保持一致:
+// layout (std140) uniform FrameConstants {
+//     mat4 view;
+//     mat4 projection;
+//     vec4 viewport;   // x, y, width, height
+//     vec4 time;       // x = 秒, y = 帧间隔
+// };
+struct FrameConstants {
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::vec4 viewport;
+    glm::vec4 time;
+};
+static_assert(sizeof(FrameConstants) == 160, "FrameConstants must match the std140 layout");
+
+// 固定 binding point 的 UBO，T 必须是按 std140 布局好的 POD
+template<typename T>
+class UniformBuffer {
+public:
+    explicit UniformBuffer(GLuint binding) : m_binding(binding)
+    {
+        glGenBuffers(1, &m_buffer);
+        GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+        glBufferData(GL_UNIFORM_BUFFER, sizeof(T), nullptr, GL_DYNAMIC_DRAW);
+    }
+    UniformBuffer(const UniformBuffer&) = delete;
+    UniformBuffer& operator=(const UniformBuffer&) = delete;
+
+    // 上传整块数据并绑定到 binding point，每帧调用一次
+    void update(const T& data)
+    {
+        GLStateCache::bindBuffer(GL_UNIFORM_BUFFER, m_buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(T), &data);
+        GLStateCache::bindBufferBase(GL_UNIFORM_BUFFER, m_binding, m_buffer);
+    }
+
+    // 和其他 GL 资源一样，需要在 context 销毁(glfwTerminate)之前手动释放
+    void destroy()
+    {
+        GLStateCache::deleteBuffers(1, &m_buffer);
+        m_buffer = 0;
+    }
+
+    GLuint id() const { return m_buffer; }
+    GLuint binding() const { return m_binding; }
+
+private:
+    GLuint m_buffer = 0;
+    GLuint m_binding;
+};
+
+#endif //RENDERER_UNIFORMBUFFER_H
@@ -0,0 +1,157 @@
+//
+// Created by liqiang on 2026/10/18.
+//
+
+#ifndef RENDERER_UNIFORMTABLE_H
+#define RENDERER_UNIFORMTABLE_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <glm/glm.hpp>
+#include "Utils/Hash.h"
+
+// uniform 名字 + 预先算好的哈希。字符串字面量可以隐式转换，
+// 用 "model"_uniform 可以强制在编译期求哈希。
+struct UniformName {
+    uint64_t hash;
+    std::string_view name;
+
+    constexpr UniformName(const char* text) : hash(fnv1a(text)), name(text) {}
+    constexpr UniformName(std::string_view text) : hash(fnv1a(text)), name(text) {}
+    UniformName(const std::string& text) : hash(fnv1a(text)), name(text) {}
+};
+
+consteval UniformName operator""_uniform(const char* text, size_t length) {
+    return UniformName(std::string_view(text, length));
+}
+
+// 解析一次后重复使用的 uniform 句柄，设置时直接使用 location
+template<typename T>
+struct UniformHandle {
+    GLint location = -1;
+    bool valid() const { return location >= 0; }
+};
+
+inline bool isSamplerType(GLenum type) {
+    switch (type) {
+        case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+        case GL_SAMPLER_1D_SHADOW: case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_CUBE_SHADOW:
+        case GL_SAMPLER_1D_ARRAY: case GL_SAMPLER_2D_ARRAY:
+        case GL_SAMPLER_1D_ARRAY_SHADOW: case GL_SAMPLER_2D_ARRAY_SHADOW:
+        case GL_SAMPLER_2D_MULTISAMPLE: case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+        case GL_SAMPLER_BUFFER: case GL_SAMPLER_2D_RECT: case GL_SAMPLER_2D_RECT_SHADOW:
+        case GL_INT_SAMPLER_2D: case GL_INT_SAMPLER_3D: case GL_INT_SAMPLER_CUBE: case GL_INT_SAMPLER_2D_ARRAY:
+        case GL_UNSIGNED_INT_SAMPLER_2D: case GL_UNSIGNED_INT_SAMPLER_3D:
+        case GL_UNSIGNED_INT_SAMPLER_CUBE: case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+        case GL_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// C++ 类型与 GLSL uniform 类型是否匹配(按 glUniform* 的规则)
+template<typename T> inline bool uniformTypeMatches(GLenum type);
+template<> inline bool uniformTypeMatches<int>(GLenum type) {
+    return type == GL_INT || type == GL_BOOL || isSamplerType(type);
+}
+template<> inline bool uniformTypeMatches<bool>(GLenum type) { return type == GL_BOOL || type == GL_INT; }
+template<> inline bool uniformTypeMatches<float>(GLenum type) { return type == GL_FLOAT; }
+template<> inline bool uniformTypeMatches<glm::vec3>(GLenum type) { return type == GL_FLOAT_VEC3; }
+template<> inline bool uniformTypeMatches<glm::vec4>(GLenum type) { return type == GL_FLOAT_VEC4; }
+template<> inline bool uniformTypeMatches<glm::mat4>(GLenum type) { return type == GL_FLOAT_MAT4; }
+
+// link 之后通过 glGetActiveUniform 反射出来的所有 uniform，
+// 用开放寻址的扁平哈希表存储，查找不涉及字符串和 GL 调用。
+class UniformTable {
+public:
+    struct Entry {
+        uint64_t hash;
+        GLint location;
+        GLenum type;
+        std::string name;
+    };
+
+    void reflect(GLuint program)
+    {
+        m_entries.clear();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> nameBuffer(maxLength > 0 ? maxLength : 1);
+        for (GLint i = 0; i < count; i++) {
+            GLsizei length = 0;
+            GLint arraySize = 0;
+            GLenum type = 0;
+            glGetActiveUniform(program, (GLuint)i, (GLsizei)nameBuffer.size(), &length, &arraySize, &type, nameBuffer.data());
+            std::string name(nameBuffer.data(), length);
+            GLint location = glGetUniformLocation(program, name.c_str());
+            // uniform block 里的成员没有 location，由 UBO 负责
+            if (location < 0) {
+                continue;
+            }
+            // 数组返回的名字是 "textures[0]"，同时注册 "textures" 和每个元素
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+                std::string baseName = name.substr(0, name.size() - 3);
+                m_entries.push_back({fnv1a(baseName), location, type, baseName});
+                for (GLint element = 1; element < arraySize; element++) {
+                    std::string elementName = baseName + "[" + std::to_string(element) + "]";
+                    GLint elementLocation = glGetUniformLocation(program, elementName.c_str());
+                    if (elementLocation >= 0) {
+                        m_entries.push_back({fnv1a(elementName), elementLocation, type, elementName});
+                    }
+                }
+            }
+            m_entries.push_back({fnv1a(name), location, type, name});
+        }
+        rebuildSlots();
+    }
+
+    // 先比较哈希，哈希相同再比较名字，两个名字哈希冲突时也不会拿到别人的 location
+    const Entry* find(const UniformName& name) const
+    {
+        if (m_slots.empty()) {
+            return nullptr;
+        }
+        size_t mask = m_slots.size() - 1;
+        for (size_t slot = name.hash & mask; ; slot = (slot + 1) & mask) {
+            int32_t index = m_slots[slot];
+            if (index < 0) {
+                return nullptr;
+            }
+            const Entry& entry = m_entries[index];
+            if (entry.hash == name.hash && entry.name == name.name) {
+                return &entry;
+            }
+        }
+    }
+
+    size_t size() const { return m_entries.size(); }
+
+private:
+    void rebuildSlots()
+    {
+        // 容量取 2 的幂且至少是元素个数的两倍，保证探测链很短
+        size_t capacity = 8;
+        while (capacity < m_entries.size() * 2) {
+            capacity *= 2;
+        }
+        m_slots.assign(capacity, -1);
+        size_t mask = capacity - 1;
+        for (size_t i = 0; i < m_entries.size(); i++) {
+            size_t slot = m_entries[i].hash & mask;
+            while (m_slots[slot] >= 0) {
+                slot = (slot + 1) & mask;
+            }
+            m_slots[slot] = (int32_t)i;
+        }
+    }
+
+    std::vector<Entry> m_entries;
+    std::vector<int32_t> m_slots;
+};
+
+#endif //RENDERER_UNIFORMTABLE_H